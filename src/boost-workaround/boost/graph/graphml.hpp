@@ -20,6 +20,7 @@
 #include <typeinfo>
 #include <boost/mpl/bool.hpp>
 #include <boost/mpl/vector.hpp>
+#include <boost/mpl/vector/vector30.hpp>
 #include <boost/mpl/find.hpp>
 #include <boost/mpl/for_each.hpp>
 #include <boost/python/object.hpp>
@@ -73,6 +74,22 @@ public:
     set_edge_property(const std::string& name, boost::any edge,
                       const std::string& value,
                       const std::string& value_type) = 0;
+
+    // The functions below are used when the file is read in parallel (see
+    // graphml.cpp). convert_value() converts a value from its string
+    // representation, and may be called concurrently. If it returns false,
+    // the value must instead be passed as a string to set_*_property().
+    virtual bool
+    convert_value(const std::string&, const std::string&, boost::any&) const
+    {
+        return false;
+    }
+
+    virtual void
+    put_vertex_property(const std::string&, boost::any, const boost::any&) {}
+
+    virtual void
+    put_edge_property(const std::string&, boost::any, const boost::any&) {}
 };
 
 template <typename MutableGraph>
@@ -208,6 +225,73 @@ public:
                                "\" for key " + name);
     }
 
+    virtual bool
+    convert_value(const std::string& value, const std::string& value_type,
+                  any& val) const
+    {
+        bool type_found = false;
+        try
+        {
+            mpl::for_each<value_types>
+                (convert_property<value_types>(value, value_type, m_type_names,
+                                               val, type_found));
+        }
+        catch (bad_lexical_cast)
+        {
+            return false;
+        }
+        return type_found && !val.empty();
+    }
+
+    virtual void
+    put_vertex_property(const std::string& name, any vertex, const any& value)
+    {
+        if (m_ignore_vp.find(name) != m_ignore_vp.end())
+            return;
+        put(name, m_dp, any_cast<vertex_descriptor>(vertex), value);
+    }
+
+    virtual void
+    put_edge_property(const std::string& name, any edge, const any& value)
+    {
+        if (m_ignore_ep.find(name) != m_ignore_ep.end())
+            return;
+        put(name, m_dp, any_cast<edge_descriptor>(edge), value);
+    }
+
+    // python objects are not converted, since this requires the interpreter
+    template <typename ValueVector>
+    class convert_property
+    {
+    public:
+        convert_property(const std::string& value,
+                         const std::string& value_type,
+                         const char** type_names, any& val, bool& type_found)
+            : m_value(value), m_value_type(value_type),
+              m_type_names(type_names), m_val(val), m_type_found(type_found) {}
+        template <class Value>
+        void operator()(Value)
+        {
+            if (m_value_type ==
+                m_type_names[mpl::find<ValueVector,Value>::type::pos::value])
+            {
+                m_type_found = true;
+                if (is_same<Value,python::object>::value)
+                    return;
+                if (is_same<Value,uint8_t>::value) // chars are stored as ints
+                    m_val = uint8_t(lexical_cast<int>(m_value));
+                else
+                    m_val = lexical_cast<Value>(m_value);
+            }
+        }
+    private:
+        const std::string& m_value;
+        const std::string& m_value_type;
+        const char** m_type_names;
+        any& m_val;
+        bool& m_type_found;
+    };
+
     template <typename Key, typename ValueVector>
     class put_property
     {
@@ -259,7 +343,9 @@ protected:
                         std::vector<uint8_t>, std::vector<int32_t>,
                         std::vector<int64_t>, std::vector<double>,
                         std::vector<long double>, std::vector<std::string>,
-                        std::string, python::object>
+                        std::string, python::object, int8_t, uint32_t, float,
+                        std::vector<int8_t>, std::vector<uint32_t>,
+                        std::vector<float> >
         value_types;
     static const char* m_type_names[];
 };
@@ -268,7 +354,8 @@ template<typename MutableGraph>
 const char* mutate_graph_impl<MutableGraph>::m_type_names[] =
 {"boolean", "short", "int", "long", "float", "double", "vector_boolean", "vector_int",
  "vector_long", "vector_float", "vector_double", "vector_string", "string",
- "python_object"};
+ "python_object", "byte", "unsigned_int", "float32", "vector_byte",
+ "vector_unsigned_int", "vector_float32"};
 
 void
 read_graphml(std::istream& in, mutate_graph& g, bool integer_vertices,
@@ -354,18 +441,23 @@ write_graphml(std::ostream& out, const Graph& g, VertexIndexMap vertex_index,
            "         xsi:schemaLocation=\"http://graphml.graphdrawing.org/xmlns"
            " http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd\">\n\n";
 
-    typedef mpl::vector<bool, uint8_t, int8_t, uint16_t, int16_t, uint32_t,
+    typedef mpl::vector23<bool, uint8_t, int8_t, uint16_t, int16_t, uint32_t,
                         int32_t, uint64_t, int64_t, float, double, long double,
                         std::vector<uint8_t>, std::vector<int32_t>,
                         std::vector<int64_t>, std::vector<double>,
                         std::vector<long double>, std::vector<std::string>,
-                        std::string, python::object> value_types;
-    const char* type_names[] = {"boolean", "boolean", "boolean", "short",
-                                "short", "int", "int", "long", "long", "float",
-                                "float", "double", "vector_boolean",
+                        std::string, python::object, std::vector<int8_t>,
+                        std::vector<uint32_t>, std::vector<float> >
+        value_types;
+    // "float" and "double" are used for double and long double values,
+    // respectively, so single precision values are written as "float32"
+    const char* type_names[] = {"boolean", "boolean", "byte", "short",
+                                "short", "unsigned_int", "int", "long", "long",
+                                "float32", "float", "double", "vector_boolean",
                                 "vector_int", "vector_long", "vector_float",
                                 "vector_double", "vector_string", "string",
-                                "python_object"};
+                                "python_object", "vector_byte",
+                                "vector_unsigned_int", "vector_float32"};
 
     std::map<std::string, std::string> graph_key_ids;
     std::map<std::string, std::string> vertex_key_ids;
@@ -82,7 +82,7 @@ void extended_clustering(GraphInterface& g, python::list props)
 
     boost::any vprop =
         prop_vector<writable_vertex_scalar_properties>()
-        (cmaps, num_vertices(g.GetGraph()));
+        (cmaps, g.GetTotalNumberOfVertices());
     if (vprop.empty())
         throw ValueException("all vertex properties must be of the same"
                              " floating point type");
@@ -0,0 +1,490 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2013 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EDGE_LIST_HH
+#define EDGE_LIST_HH
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <cctype>
+#include <limits>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "tr1_include.hh"
+#include TR1_HEADER(unordered_map)
+#include TR1_HEADER(functional)
+
+namespace graph_tool
+{
+using namespace std;
+using namespace boost;
+
+//
+// Edge list reader
+// ================
+//
+// Reads files where each line describes an edge as "source target [values...]",
+// with the fields separated either by whitespace, or by a given delimiter (as
+// in CSV files, in which case the fields may be enclosed in double quotes,
+// with "" standing for a literal quote). Empty lines and lines starting with
+// '#' are skipped. The vertices are identified by arbitrary strings or
+// integers, which are mapped to consecutive vertex indexes, in the order in
+// which they first appear in the file.
+//
+// The input is read in large blocks, each of which is split into slices that
+// are parsed in parallel. The vertex identifiers are then resolved, also in
+// parallel, via a hash table which is split into shards, each of which is
+// handled by a single thread. The edges are finally added in the order of the
+// file, and the extra fields of each line are passed on, as strings, to be
+// converted into property values (see read_edge_list() below).
+//
+
+class edge_list_parse_error: public std::exception
+{
+public:
+    edge_list_parse_error(const string& w): _what(w) {}
+    ~edge_list_parse_error() throw() {}
+    virtual const char* what() const throw() {return _what.c_str();}
+
+private:
+    std::string _what;
+};
+
+// splits the line [begin, end) into fields; if delim is zero, the fields are
+// separated by runs of whitespace
+inline void split_fields(const char* begin, const char* end, char delim,
+                         vector<string>& fields)
+{
+    fields.clear();
+    const char* p = begin;
+    if (delim == 0)
+    {
+        while (p != end)
+        {
+            while (p != end && isspace(*p))
+                ++p;
+            const char* q = p;
+            while (q != end && !isspace(*q))
+                ++q;
+            if (q != p)
+                fields.push_back(string(p, q));
+            p = q;
+        }
+        return;
+    }
+
+    while (true)
+    {
+        string field;
+        if (p != end && *p == '"')
+        {
+            ++p;
+            while (p != end)
+            {
+                if (*p == '"')
+                {
+                    if (p + 1 != end && *(p + 1) == '"')
+                    {
+                        field.push_back('"');
+                        p += 2;
+                        continue;
+                    }
+                    ++p;
+                    break;
+                }
+                field.push_back(*p++);
+            }
+        }
+        const char* q = p;
+        while (q != end && *q != delim)
+            ++q;
+        field.append(p, q);
+        fields.push_back(field);
+        if (q == end)
+            break;
+        p = q + 1;
+    }
+}
+
+// conversion of fields into vertex identifiers and property values, which
+// (unlike lexical_cast) does not depend on the global locale, and can
+// therefore be used from several threads
+
+inline bool parse_value(const string& s, string& val)
+{
+    val = s;
+    return true;
+}
+
+template <class Integer>
+inline bool parse_integer(const string& s, Integer& val)
+{
+    const char* str = s.c_str();
+    char* end = 0;
+    errno = 0;
+    long long v = strtoll(str, &end, 10);
+    if (end == str || *end != '\0' || errno != 0 ||
+        v < (long long)(numeric_limits<Integer>::min()) ||
+        v > (long long)(numeric_limits<Integer>::max()))
+        return false;
+    val = Integer(v);
+    return true;
+}
+
+inline bool parse_value(const string& s, uint8_t& val)
+{
+    if (s == "true" || s == "True")
+    {
+        val = 1;
+        return true;
+    }
+    if (s == "false" || s == "False")
+    {
+        val = 0;
+        return true;
+    }
+    return parse_integer(s, val);
+}
+
+inline bool parse_value(const string& s, int8_t& val)
+{
+    return parse_integer(s, val);
+}
+
+inline bool parse_value(const string& s, int16_t& val)
+{
+    return parse_integer(s, val);
+}
+
+inline bool parse_value(const string& s, int32_t& val)
+{
+    return parse_integer(s, val);
+}
+
+inline bool parse_value(const string& s, uint32_t& val)
+{
+    return parse_integer(s, val);
+}
+
+inline bool parse_value(const string& s, int64_t& val)
+{
+    return parse_integer(s, val);
+}
+
+inline bool parse_value(const string& s, float& val)
+{
+    const char* str = s.c_str();
+    char* end = 0;
+    val = strtof(str, &end);
+    return end != str && *end == '\0';
+}
+
+inline bool parse_value(const string& s, double& val)
+{
+    const char* str = s.c_str();
+    char* end = 0;
+    val = strtod(str, &end);
+    return end != str && *end == '\0';
+}
+
+inline bool parse_value(const string& s, long double& val)
+{
+    const char* str = s.c_str();
+    char* end = 0;
+    val = strtold(str, &end);
+    return end != str && *end == '\0';
+}
+
+// the parsed contents of a slice of a block of lines
+template <class Id>
+struct edge_list_slice
+{
+    vector<Id> ids;                 // source and target of each edge
+    vector<vector<string> > values; // extra fields, for each column
+    size_t offset;                  // position of the first edge in the block
+    string error;
+};
+
+// maps vertex identifiers to vertex indexes
+template <class Id>
+class vertex_id_table
+{
+public:
+    vertex_id_table(): _N(0) {}
+
+    // number of distinct identifiers seen so far
+    size_t size() const { return _N; }
+
+    // replaces the identifiers *ids[i] by their vertex indexes vs[i]; the
+    // identifiers which were not seen before get new indexes, in the order
+    // in which they appear in ids, and are appended to new_ids
+    void map(const vector<const Id*>& ids, vector<size_t>& vs,
+             vector<const Id*>& new_ids)
+    {
+        // provisional values, which point to the first occurrence of a new
+        // identifier
+        const size_t first = size_t(1) << (numeric_limits<size_t>::digits - 1);
+
+        size_t P = ids.size();
+        vector<uint8_t> shard(P);
+        vector<uint8_t> is_new(P, 0);
+        vs.resize(P);
+
+        tr1::hash<Id> hash;
+        int i, M = P;
+        #pragma omp parallel for default(shared) private(i) schedule(static) \
+            if (M > 1000)
+        for (i = 0; i < M; ++i)
+        {
+            // fibonacci hashing, so that the shards are balanced even for
+            // identity hashes
+            uint64_t h = uint64_t(hash(*ids[i])) * 0x9E3779B97F4A7C15ULL;
+            shard[i] = h >> (64 - shard_bits);
+        }
+
+        int s, S = n_shards;
+        #pragma omp parallel for default(shared) private(s) schedule(dynamic) \
+            if (M > 1000)
+        for (s = 0; s < S; ++s)
+        {
+            map_t& m = _shards[s];
+            for (size_t j = 0; j < P; ++j)
+            {
+                if (shard[j] != s)
+                    continue;
+                typename map_t::iterator iter = m.find(*ids[j]);
+                if (iter == m.end())
+                {
+                    m[*ids[j]] = vs[j] = first | j;
+                    is_new[j] = 1;
+                }
+                else
+                {
+                    vs[j] = iter->second;
+                }
+            }
+        }
+
+        for (size_t j = 0; j < P; ++j)
+        {
+            if (!is_new[j])
+                continue;
+            vs[j] = _N++;
+            new_ids.push_back(ids[j]);
+        }
+
+        #pragma omp parallel for default(shared) private(i) schedule(static) \
+            if (M > 1000)
+        for (i = 0; i < M; ++i)
+        {
+            if (vs[i] & first)
+                vs[i] = vs[vs[i] & ~first];
+        }
+
+        #pragma omp parallel for default(shared) private(s) schedule(dynamic) \
+            if (M > 1000)
+        for (s = 0; s < S; ++s)
+        {
+            for (size_t j = 0; j < P; ++j)
+                if (is_new[j] && shard[j] == s)
+                    _shards[s][*ids[j]] = vs[j];
+        }
+    }
+
+private:
+    static const size_t shard_bits = 6;
+    static const size_t n_shards = size_t(1) << shard_bits;
+    typedef tr1::unordered_map<Id, size_t> map_t;
+    map_t _shards[n_shards];
+    size_t _N;
+};
+
+// parses the lines in [begin, end) into the given slice
+template <class Id>
+void parse_edge_list_slice(const char* begin, const char* end, char delim,
+                           size_t n_values, edge_list_slice<Id>& slice)
+{
+    slice.ids.clear();
+    slice.values.assign(n_values, vector<string>());
+    vector<string> fields;
+    const char* p = begin;
+    while (p != end)
+    {
+        const char* q = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (q == 0)
+            q = end;
+        const char* line_end = q;
+        if (line_end != p && *(line_end - 1) == '\r')
+            --line_end;
+        const char* s = p;
+        while (s != line_end && isspace(*s))
+            ++s;
+        p = (q == end) ? end : q + 1;
+        if (s == line_end || *s == '#')
+            continue;
+
+        split_fields(s, line_end, delim, fields);
+        if (fields.size() < 2 + n_values)
+        {
+            slice.error = "expected " + lexical_cast<string>(2 + n_values) +
+                " fields, but found " + lexical_cast<string>(fields.size()) +
+                " in line: '" + string(s, line_end) + "'";
+            return;
+        }
+        for (size_t j = 0; j < 2; ++j)
+        {
+            Id id;
+            if (!parse_value(fields[j], id))
+            {
+                slice.error = "invalid vertex identifier '" + fields[j] +
+                    "' in line: '" + string(s, line_end) + "'";
+                return;
+            }
+            slice.ids.push_back(id);
+        }
+        for (size_t j = 0; j < n_values; ++j)
+        {
+            slice.values[j].push_back(string());
+            slice.values[j].back().swap(fields[2 + j]);
+        }
+    }
+}
+
+// Reads the edge list from the stream into the graph g, whose existing
+// vertices are left untouched. The identifier of each vertex is stored in id_map, and the edge
+// index of each edge is passed on to the sink, together with the values of the
+// remaining n_values columns: for each block of edges, the function
+// sink(eindex, slices) is called, where eindex[i] is the index of the i-th edge
+// of the block, and slices are the parsed slices of the block. If skip_first
+// is true, the first line is a header, which is split into the given vector.
+
+template <class Id, class Graph, class IdMap, class EdgeIndex, class Sink>
+void read_edge_list(istream& in, Graph& g, IdMap id_map, EdgeIndex eindex,
+                    char delim, bool skip_first, size_t n_values,
+                    vector<string>& header, Sink sink)
+{
+    typedef typename graph_traits<Graph>::vertex_descriptor vertex_t;
+    typedef typename graph_traits<Graph>::edge_descriptor edge_t;
+
+    // size of the blocks which are read at once, and of the slices in which
+    // each of them is split
+    const size_t block_size = size_t(1) << 24;
+    const size_t slice_size = size_t(1) << 16;
+
+    if (skip_first)
+    {
+        string line;
+        getline(in, line);
+        if (!line.empty() && line[line.size() - 1] == '\r')
+            line.resize(line.size() - 1);
+        split_fields(line.data(), line.data() + line.size(), delim, header);
+    }
+
+    size_t N0 = num_vertices(g);
+    vertex_id_table<Id> table;
+    vector<char> buf;
+    vector<edge_list_slice<Id> > slices;
+    vector<const char*> bounds;
+    vector<const Id*> ids, new_ids;
+    vector<size_t> vs, eidx;
+    while (in)
+    {
+        // read the next block, which ends with the last complete line
+        size_t pos = buf.size();
+        buf.resize(pos + block_size);
+        in.read(&buf[pos], block_size);
+        buf.resize(pos + in.gcount());
+        if (buf.empty())
+            break;
+        size_t end = buf.size();
+        if (in)
+        {
+            while (end > 0 && buf[end - 1] != '\n')
+                --end;
+            if (end == 0)
+                continue; // the line does not fit in a block
+        }
+
+        // split the block into slices at line boundaries, and parse them
+        const char* data = &buf[0];
+        bounds.clear();
+        bounds.push_back(data);
+        for (size_t i = slice_size; i < end; i += slice_size)
+        {
+            const char* p = static_cast<const char*>
+                (memchr(data + i, '\n', end - i));
+            if (p == 0)
+                break;
+            if (p + 1 > bounds.back())
+                bounds.push_back(p + 1);
+        }
+        if (bounds.back() != data + end)
+            bounds.push_back(data + end);
+
+        slices.resize(bounds.size() - 1);
+        int i, N = slices.size();
+        #pragma omp parallel for default(shared) private(i) \
+            schedule(dynamic) if (N > 1)
+        for (i = 0; i < N; ++i)
+        {
+            slices[i].error.clear();
+            parse_edge_list_slice(bounds[i], bounds[i + 1], delim, n_values,
+                                  slices[i]);
+        }
+
+        ids.clear();
+        for (size_t j = 0; j < slices.size(); ++j)
+        {
+            if (!slices[j].error.empty())
+                throw edge_list_parse_error(slices[j].error);
+            slices[j].offset = ids.size() / 2;
+            for (size_t k = 0; k < slices[j].ids.size(); ++k)
+                ids.push_back(&slices[j].ids[k]);
+        }
+
+        // resolve the identifiers, and add the new vertices and the edges
+        new_ids.clear();
+        table.map(ids, vs, new_ids);
+        for (size_t j = 0; j < new_ids.size(); ++j)
+        {
+            vertex_t v = add_vertex(g);
+            id_map[v] = *new_ids[j];
+        }
+
+        eidx.resize(ids.size() / 2);
+        for (size_t j = 0; j < eidx.size(); ++j)
+        {
+            edge_t e = add_edge(vertex(N0 + vs[2 * j], g),
+                                vertex(N0 + vs[2 * j + 1], g), g).first;
+            eidx[j] = eindex[e];
+        }
+        sink(eidx, slices);
+
+        // keep the incomplete last line for the next block
+        buf.erase(buf.begin(), buf.begin() + end);
+    }
+}
+
+} // namespace graph_tool
+
+#endif // EDGE_LIST_HH
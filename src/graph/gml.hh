@@ -35,6 +35,7 @@
 
 #include <boost/property_map/dynamic_property_map.hpp>
 #include <boost/tuple/tuple.hpp>
+#include <boost/mpl/vector/vector30.hpp>
 #include <boost/bind/bind.hpp>
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/properties.hpp>
@@ -45,6 +46,9 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include <iterator>
+#include <cstring>
+#include <cctype>
 
 #include "tr1_include.hh"
 #include TR1_HEADER(unordered_map)
@@ -75,10 +79,29 @@ public:
               std::set<std::string> ignore_ep = std::set<std::string>(),
               std::set<std::string> ignore_gp = std::set<std::string>())
         : _g(g), _dp(dp), _directed(false), _ignore_vp(ignore_vp),
-          _ignore_ep(ignore_ep), _ignore_gp(ignore_gp) {}
+          _ignore_ep(ignore_ep), _ignore_gp(ignore_gp), _records(0),
+          _dropped(false) {}
 
     typedef boost::variant<std::string, int, double> val_t;
 
+    // the stack holds the keys, and its properties (but omits nested lists)
+    typedef tr1::unordered_map<std::string, val_t> prop_list_t;
+    typedef pair<std::string, prop_list_t> record_t;
+
+    // if set, the lists are stored in records as they are finished, instead
+    // of being put in the graph, which can then be done later by
+    // finish_item(), in the same order
+    void set_records(vector<record_t>* records)
+    {
+        _records = records;
+    }
+
+    // whether a value was found outside of any list
+    bool dropped()
+    {
+        return _dropped;
+    }
+
     // key / value mechanics
     void push_key(const std::string& key)
     {
@@ -93,6 +116,8 @@ public:
         _stack.pop_back();
         if (!_stack.empty())
             _stack.back().second[k] = value;
+        else
+            _dropped = true;
     }
 
     // actual parsing
@@ -101,15 +126,29 @@ public:
         if (_stack.empty())
             return;
 
-        std::string &k = _stack.back().first;
+        if (_records != 0)
+        {
+            _records->push_back(record_t());
+            _records->back().first.swap(_stack.back().first);
+            _records->back().second.swap(_stack.back().second);
+        }
+        else
+        {
+            finish_item(_stack.back().first, _stack.back().second);
+        }
+        _stack.pop_back();
+    }
+
+    void finish_item(const std::string& k, prop_list_t& props)
+    {
         if (k == "node")
         {
             int id;
-            if (_stack.back().second.find("id") == _stack.back().second.end())
+            if (props.find("id") == props.end())
                 throw gml_parse_error("node does not have an id");
             try
             {
-                id = boost::get<double>(_stack.back().second["id"]);
+                id = boost::get<double>(props["id"]);
             }
             catch (bad_get)
             {
@@ -119,8 +158,8 @@ public:
             typename graph_traits<Graph>::vertex_descriptor v = get_vertex(id);
 
             // put properties
-            for (typeof(_stack.back().second.begin()) iter = _stack.back().second.begin();
-                 iter != _stack.back().second.end(); ++iter)
+            for (typeof(props.begin()) iter = props.begin();
+                 iter != props.end(); ++iter)
             {
                 if (iter->first == "id")
                     continue;
@@ -139,15 +178,13 @@ public:
         else if (k == "edge")
         {
             int source, target;
-            if (_stack.back().second.find("source") ==
-                _stack.back().second.end() ||
-                _stack.back().second.find("target") ==
-                _stack.back().second.end())
+            if (props.find("source") == props.end() ||
+                props.find("target") == props.end())
                 throw gml_parse_error("edge does not have source and target ids");
             try
             {
-                source = boost::get<double>(_stack.back().second["source"]);
-                target = boost::get<double>(_stack.back().second["target"]);
+                source = boost::get<double>(props["source"]);
+                target = boost::get<double>(props["target"]);
             }
             catch (bad_get)
             {
@@ -162,8 +199,8 @@ public:
                 add_edge(s, t, _g).first;
 
             // put properties
-            for (typeof(_stack.back().second.begin()) iter = _stack.back().second.begin();
-                 iter != _stack.back().second.end(); ++iter)
+            for (typeof(props.begin()) iter = props.begin();
+                 iter != props.end(); ++iter)
             {
                 if (iter->first == "id" || iter->first == "source" || iter->first == "target")
                     continue;
@@ -183,8 +220,8 @@ public:
         else if (k == "graph")
         {
             // put properties
-            for (typeof(_stack.back().second.begin()) iter = _stack.back().second.begin();
-                 iter != _stack.back().second.end(); ++iter)
+            for (typeof(props.begin()) iter = props.begin();
+                 iter != props.end(); ++iter)
             {
                 if (iter->first == "directed")
                     _directed = boost::get<double>(iter->second);
@@ -201,7 +238,6 @@ public:
             }
 
         }
-        _stack.pop_back();
     }
 
     typename graph_traits<Graph>::vertex_descriptor get_vertex(size_t index)
@@ -224,13 +260,14 @@ private:
     bool _directed;
     tr1::unordered_map<int, typename graph_traits<Graph>::vertex_descriptor> _vmap;
 
-    // the stack holds the keys, and its properties (but omits nested lists)
-    typedef tr1::unordered_map<std::string, val_t> prop_list_t;
     vector<pair<std::string,  prop_list_t> > _stack;
 
     std::set<std::string> _ignore_vp;
     std::set<std::string> _ignore_ep;
     std::set<std::string> _ignore_gp;
+
+    vector<record_t>* _records;
+    bool _dropped;
 };
 
 
@@ -274,16 +311,223 @@ struct gml : spirit::qi::grammar<Iterator, void(), Skipper>
     gml_state<Graph> _state;
 };
 
-template <class Iterator, class Graph, class Skipper>
-bool parse_grammar(Iterator begin, Iterator end, Graph& g,
+//
+// Parallel parsing
+// ================
+//
+// The whole file is read into memory, and the node and edge lists directly
+// inside the graph list are split into chunks, which are parsed in parallel,
+// each as a separate top-level list. The rest of the file (the "header" before
+// the first of these lists, and the "tail" after the last one) is also parsed
+// separately, with a marker list in place of the chunks. The finished lists of
+// every part are stored instead of being added to the graph, and are only
+// added afterwards, in the same order in which the whole file would have been
+// parsed. Since the lists are balanced, this gives exactly the same result,
+// provided each part is parsed completely, and no chunk contains values
+// outside a list (which would belong to the enclosing list). Otherwise, the
+// whole file is simply parsed serially.
+
+// stands for the chunks, when the header and tail are parsed
+const char gml_chunk_marker[] = "graphtoolchunks";
+
+// the approximate size of each chunk
+const size_t gml_chunk_size = 1 << 20;
+
+inline bool gml_is_alnum(char c)
+{
+    return isalnum(static_cast<unsigned char>(c));
+}
+
+inline bool gml_is_space(char c)
+{
+    return isspace(static_cast<unsigned char>(c));
+}
+
+// finds the beginning of the node and edge lists at depth one (i.e. inside
+// the graph list), and the end of the last one of them
+inline void find_gml_records(const char* begin, const char* end,
+                             vector<const char*>& starts, const char*& last)
+{
+    int depth = 0;
+    bool in_record = false;
+    char prev = ' ';
+    const char* pos = begin;
+    last = begin;
+    while (pos != end)
+    {
+        char c = *pos;
+        if (c == '"')
+        {
+            for (++pos; pos != end && *pos != '"'; ++pos)
+                if (*pos == '\\' && pos + 1 != end)
+                    ++pos;
+            if (pos == end)
+                break;
+        }
+        else if (c == '#')
+        {
+            while (pos != end && *pos != '\n' && *pos != '\r')
+                ++pos;
+            if (pos == end)
+                break;
+        }
+        else if (c == '[')
+        {
+            ++depth;
+        }
+        else if (c == ']')
+        {
+            --depth;
+            if (in_record && depth == 1)
+            {
+                last = pos + 1;
+                in_record = false;
+            }
+        }
+        else if (gml_is_alnum(c))
+        {
+            const char* word = pos;
+            while (pos != end && gml_is_alnum(*pos))
+                ++pos;
+            if (depth == 1 && pos - word == 4 &&
+                (std::memcmp(word, "node", 4) == 0 ||
+                 std::memcmp(word, "edge", 4) == 0) &&
+                (gml_is_space(prev) || prev == '[' || prev == ']' || prev == '"'))
+            {
+                const char* next = pos;
+                while (next != end && gml_is_space(*next))
+                    ++next;
+                if (next != end && *next == '[')
+                {
+                    starts.push_back(word);
+                    in_record = true;
+                }
+            }
+            prev = pos[-1];
+            continue;
+        }
+        prev = *pos;
+        ++pos;
+    }
+
+    // the last list is incomplete
+    if (in_record)
+        starts.pop_back();
+}
+
+// parses the text as a top-level list, storing the finished lists in records,
+// and returns true if it was parsed completely
+template <class Graph, class Skipper>
+bool parse_gml_records(const char* begin, const char* end, Graph& g,
+                       dynamic_properties& dp, const Skipper& skip,
+                       vector<typename gml_state<Graph>::record_t>& records,
+                       bool& dropped)
+{
+    try
+    {
+        gml<const char*, Graph, Skipper> parser(g, dp);
+        parser._state.set_records(&records);
+        const char* pos = begin;
+        bool ok = spirit::qi::phrase_parse(pos, end, parser, skip);
+        dropped = parser._state.dropped();
+        return ok && pos == end;
+    }
+    catch (...)
+    {
+        // the file will be parsed again serially, which will report the
+        // error properly
+        return false;
+    }
+}
+
+template <class Graph, class Skipper>
+bool parse_grammar_parallel(const char* begin, const char* end,
+                            gml_state<Graph>& state, Graph& g,
+                            dynamic_properties& dp, const Skipper& skip)
+{
+    typedef typename gml_state<Graph>::record_t record_t;
+
+    vector<const char*> starts;
+    const char* last;
+    find_gml_records(begin, end, starts, last);
+    if (starts.empty())
+        return false;
+
+    vector<const char*> bounds;
+    for (size_t i = 0; i < starts.size(); ++i)
+        if (bounds.empty() || size_t(starts[i] - bounds.back()) >= gml_chunk_size)
+            bounds.push_back(starts[i]);
+    bounds.push_back(last);
+
+    std::string rest(begin, starts.front());
+    rest += " ";
+    rest += gml_chunk_marker;
+    rest += " [ ] ";
+    rest.append(last, end);
+
+    // the last part is the rest
+    vector<vector<record_t> > records(bounds.size());
+    vector<int> failed(bounds.size(), 0);
+    int i, N = records.size();
+    #pragma omp parallel for default(shared) private(i) schedule(dynamic) \
+        if (N > 1)
+    for (i = 0; i < N; ++i)
+    {
+        bool dropped = false;
+        if (i < N - 1)
+        {
+            failed[i] = !parse_gml_records(bounds[i], bounds[i + 1], g, dp,
+                                           skip, records[i], dropped) ||
+                dropped;
+        }
+        else
+        {
+            failed[i] = !parse_gml_records(rest.data(),
+                                           rest.data() + rest.size(), g, dp,
+                                           skip, records[i], dropped);
+        }
+    }
+
+    for (size_t j = 0; j < failed.size(); ++j)
+        if (failed[j])
+            return false;
+
+    vector<record_t>& rest_records = records.back();
+    size_t marker = rest_records.size();
+    for (size_t j = 0; j < rest_records.size(); ++j)
+    {
+        if (rest_records[j].first != gml_chunk_marker)
+            continue;
+        if (marker < rest_records.size())
+            return false;
+        marker = j;
+    }
+    if (marker == rest_records.size())
+        return false;
+
+    for (size_t j = 0; j < marker; ++j)
+        state.finish_item(rest_records[j].first, rest_records[j].second);
+    for (size_t j = 0; j < records.size() - 1; ++j)
+        for (size_t k = 0; k < records[j].size(); ++k)
+            state.finish_item(records[j][k].first, records[j][k].second);
+    for (size_t j = marker + 1; j < rest_records.size(); ++j)
+        state.finish_item(rest_records[j].first, rest_records[j].second);
+    return true;
+}
+
+template <class Graph, class Skipper>
+bool parse_grammar(const char* begin, const char* end, Graph& g,
                    dynamic_properties& dp, Skipper skip,
                    std::set<std::string> ignore_vp = std::set<std::string>(),
                    std::set<std::string> ignore_ep = std::set<std::string>(),
                    std::set<std::string> ignore_gp = std::set<std::string>())
 {
     using namespace spirit;
-    gml<spirit::istream_iterator, Graph, Skipper> parser(g, dp, ignore_vp,
-                                                         ignore_ep, ignore_gp);
+    gml<const char*, Graph, Skipper> parser(g, dp, ignore_vp, ignore_ep,
+                                            ignore_gp);
+    if (parse_grammar_parallel(begin, end, parser._state, g, dp, skip))
+        return parser._state.is_directed();
+
     bool ok = qi::phrase_parse(begin, end, parser, skip);
     if (!ok)
         throw gml_parse_error("invalid syntax");
@@ -299,9 +543,10 @@ bool read_gml(istream& in, Graph& g, dynamic_properties& dp,
 {
     using namespace spirit;
 
-    in >> std::noskipws;
-    spirit::istream_iterator begin(in);
-    spirit::istream_iterator end;
+    std::string text((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+    const char* begin = text.data();
+    const char* end = begin + text.size();
 
     bool directed =
         parse_grammar(begin, end, g, dp,
@@ -319,7 +564,9 @@ struct get_str
         try
         {
             ValueType v = any_cast<ValueType>(val);
-            if (is_same<ValueType, python::object>::value)
+            // signed chars must be written as numbers
+            if (is_same<ValueType, python::object>::value ||
+                is_same<ValueType, int8_t>::value)
             {
                 sval = lexical_cast<string>(v);
             }
@@ -361,12 +608,14 @@ void write_gml(std::ostream& out, const Graph& g, VertexIndexMap vertex_index,
     typedef typename graph_traits<Graph>::edge_descriptor edge_descriptor;
     typedef typename graph_traits<Graph>::vertex_descriptor vertex_descriptor;
 
-    typedef mpl::vector<bool, uint8_t, int8_t, uint32_t, int32_t,
-                        uint64_t, int64_t, float, double, long double,
-                        std::vector<uint8_t>, std::vector<int32_t>,
-                        std::vector<int64_t>, std::vector<double>,
-                        std::vector<long double>, std::vector<std::string>,
-                        std::string, python::object> value_types;
+    typedef mpl::vector21<bool, uint8_t, int8_t, uint32_t, int32_t,
+                          uint64_t, int64_t, float, double, long double,
+                          std::vector<uint8_t>, std::vector<int32_t>,
+                          std::vector<int64_t>, std::vector<double>,
+                          std::vector<long double>, std::vector<std::string>,
+                          std::string, python::object, std::vector<int8_t>,
+                          std::vector<uint32_t>, std::vector<float> >
+        value_types;
 
     BOOST_STATIC_CONSTANT(bool, graph_is_directed =
                           (is_convertible<directed_category*,
@@ -29,8 +29,12 @@ using namespace graph_tool;
 
 
 // this is the constructor for the graph interface
-GraphInterface::GraphInterface()
+GraphInterface::GraphInterface(bool index32)
     :_mg(new multigraph_t()),
+     _mg32(new multigraph32_t()),
+     _index32(index32),
+     _csr(new csr_graph_t()),
+     _in_edges_triggers(new vector<string>()),
      _vertex_index(get(vertex_index, *_mg)),
      _edge_index(get(edge_index_t(), *_mg)),
      _reversed(false),
@@ -41,7 +45,8 @@ GraphInterface::GraphInterface()
      _vertex_filter_active(false),
      _edge_filter_map(_edge_index),
      _edge_filter_invert(false),
-     _edge_filter_active(false)
+     _edge_filter_active(false),
+     _csr_view_base(0)
 {
 }
 
@@ -74,20 +79,117 @@ size_t GraphInterface::GetNumberOfEdges()
     if (IsEdgeFilterActive() || IsVertexFilterActive())
         run_action<>()(*this, lambda::var(n) =
                        lambda::bind<size_t>(HardNumEdges(),lambda::_1))();
+    else if (GetMapped())
+        n = num_edges(*_csr);
     else
-        n = num_edges(*_mg);
+        n = _index32 ? num_edges(*_mg32) : num_edges(*_mg);
     return n;
 }
 
+size_t GraphInterface::GetTotalNumberOfVertices() const
+{
+    if (GetMapped())
+        return num_vertices(*_csr);
+    return _index32 ? num_vertices(*_mg32) : num_vertices(*_mg);
+}
+
+void GraphInterface::SetKeepEpos(bool keep)
+{
+    if (_index32)
+        _mg32->set_keep_epos(keep);
+    else
+        _mg->set_keep_epos(keep);
+}
+
+bool GraphInterface::GetKeepEpos()
+{
+    return _index32 ? _mg32->get_keep_epos() : _mg->get_keep_epos();
+}
+
+void GraphInterface::SetKeepEindex(bool keep)
+{
+    if (_index32)
+        _mg32->set_keep_eindex(keep);
+    else
+        _mg->set_keep_eindex(keep);
+}
+
+bool GraphInterface::GetKeepEindex()
+{
+    return _index32 ? _mg32->get_keep_eindex() : _mg->get_keep_eindex();
+}
+
+void GraphInterface::SetKeepInEdges(bool keep)
+{
+    if (_index32)
+        _mg32->set_keep_in_edges(keep);
+    else
+        _mg->set_keep_in_edges(keep);
+}
+
+bool GraphInterface::GetKeepInEdges() const
+{
+    return _index32 ? _mg32->get_keep_in_edges() : _mg->get_keep_in_edges();
+}
+
+python::list GraphInterface::GetInEdgesTriggers() const
+{
+    python::list triggers;
+    for (size_t i = 0; i < _in_edges_triggers->size(); ++i)
+        triggers.append((*_in_edges_triggers)[i]);
+    return triggers;
+}
+
+size_t GraphInterface::GetMemoryUsage() const
+{
+    return _index32 ? _mg32->memory_usage() : _mg->memory_usage();
+}
+
 void GraphInterface::Clear()
 {
+    bool keep_in_edges = GetKeepInEdges();
     *_mg = multigraph_t();
+    *_mg32 = multigraph32_t();
+    SetKeepInEdges(keep_in_edges);
 }
 
+// builds (or discards) the immutable CSR snapshot of the graph, which will be
+// used instead of the adjacency list by all unfiltered graph views. A
+// memory-mapped graph has no adjacency list, and is always frozen.
+void GraphInterface::SetFrozen(bool frozen)
+{
+    if (GetMapped())
+    {
+        if (!frozen)
+            throw GraphException("the graph is memory-mapped, and cannot be "
+                                 "unfrozen; copy it first");
+        return;
+    }
+
+    if (frozen)
+    {
+        bool keep_in_edges = GetKeepInEdges();
+        if (_index32)
+            _csr->build(*_mg32);
+        else
+            _csr->build(*_mg);
+        if (!keep_in_edges && GetKeepInEdges())
+            _in_edges_triggers->push_back("GraphInterface::SetFrozen");
+    }
+    else
+        _csr->clear();
+}
+
+struct clear_edges
+{
+    template <class Graph>
+    void operator()(Graph& g) const
+    {
+        g.clear_edges();
+    }
+};
+
 void GraphInterface::ClearEdges()
 {
-    graph_traits<multigraph_t>::vertex_iterator v, v_end;
-    for (tie(v, v_end) = vertices(*_mg); v != v_end; ++v)
-        clear_vertex(*v, *_mg);
-    _mg->reindex_edges();
+    RunOnGraph(clear_edges());
 }
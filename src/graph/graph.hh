@@ -24,8 +24,11 @@
 #include <boost/python/dict.hpp>
 
 #include <deque>
+#include <set>
+#include <iosfwd>
 
 #include "graph_adjacency.hh"
+#include "graph_csr.hh"
 
 #include <boost/graph/graph_traits.hpp>
 
@@ -57,10 +60,10 @@ struct graph_action;
 class GraphInterface
 {
 public:
-    GraphInterface();
+    GraphInterface(bool index32 = false);
     GraphInterface(const GraphInterface& g, bool keep_ref,
                    python::object ovprops, python::object oeprops,
-                   python::object vorder);
+                   python::object vorder, bool index32);
     ~GraphInterface();
 
     // useful enums
@@ -82,12 +85,46 @@ public:
 
     size_t GetNumberOfVertices();
     size_t GetNumberOfEdges();
+    size_t GetTotalNumberOfVertices() const; // ignores the vertex filter
     void SetDirected(bool directed) {_directed = directed;}
     bool GetDirected() {return _directed;}
     void SetReversed(bool reversed) {_reversed = reversed;}
     bool GetReversed() {return _reversed;}
-    void SetKeepEpos(bool keep) {_mg->set_keep_epos(keep);}
-    bool GetKeepEpos() {return _mg->get_keep_epos();}
+    void SetKeepEpos(bool keep);
+    bool GetKeepEpos();
+    void SetKeepEindex(bool keep);
+    bool GetKeepEindex();
+
+    // out-edges-only storage: if disabled, the in-edge lists are discarded,
+    // and are rebuilt only when an algorithm needs them. The names of the
+    // actions which triggered this are kept (see graph_filtering.hh)
+    void SetKeepInEdges(bool keep);
+    bool GetKeepInEdges() const;
+    void AddInEdgesTrigger(const std::type_info& action) const;
+    python::list GetInEdgesTriggers() const;
+    size_t GetMemoryUsage() const; // bytes used by the adjacency list
+
+    // whether the adjacency list is stored with 32-bit integers (see
+    // multigraph32_t below); this is fixed when the graph is created
+    bool GetIndex32() const {return _index32;}
+
+    // immutable CSR snapshot, used for all unfiltered graph views while the
+    // graph is frozen (see graph_csr.hh)
+    void SetFrozen(bool frozen);
+    bool GetFrozen() const {return _csr->is_valid();}
+    size_t GetFrozenMemoryUsage() const {return _csr->memory_usage();}
+
+    // whether the graph was loaded from a memory-mapped image (see
+    // graph_io_binary.cc). Such a graph consists only of the frozen CSR
+    // snapshot, which refers directly to the mapped file, and the adjacency
+    // list is left empty; it is always frozen, and cannot be unfrozen.
+    bool GetMapped() const {return _csr->is_mapped();}
+
+    // materialized copy of the filtered graph, used instead of the filtered
+    // adjacency list by all filtered graph views while enabled. It is rebuilt
+    // lazily whenever the graph or the filters change (see graph_filtering.cc)
+    void SetFilterCache(bool cache);
+    bool GetFilterCache() const {return _filter_cache.enabled;}
 
 
     // graph filtering
@@ -100,12 +137,14 @@ public:
     void InsertPropertyMap(string name, boost::any map);
     void ReIndexEdges();
     void PurgeVertices(boost::any old_index); // removes filtered vertices
+    void ReorderVertices(string method, boost::any vorder, boost::any old_index);
     void PurgeEdges();    // removes filtered edges
     void Clear();
     void ClearEdges();
     void ShiftVertexProperty(boost::any map, size_t index) const;
     void MoveVertexProperty(boost::any map, size_t index) const;
     void ReIndexVertexProperty(boost::any map, boost::any old_index) const;
+    void PermuteVertexProperty(boost::any map, boost::any old_index) const;
     void CopyVertexProperty(const GraphInterface& src, boost::any prop_src,
                             boost::any prop_tgt);
     void CopyEdgeProperty(const GraphInterface& src, boost::any prop_src,
@@ -122,10 +161,16 @@ public:
 
     // I/O
     void WriteToFile(string s, python::object pf, string format,
-                     python::list properties);
+                     python::list properties, int threads);
     python::tuple ReadFromFile(string s, python::object pf, string format,
                                python::list ignore_vp, python::list ignore_ep,
-                               python::list ignore_gp);
+                               python::list ignore_gp, bool lazy);
+    python::object ReadProperty(string s, size_t pos, size_t n);
+    python::tuple ReadEdgeList(string s, python::object pf, string delimiter,
+                               bool skip_first, string id_type,
+                               python::list column_types);
+    python::object WriteToBlob(python::list properties, bool compress);
+    python::tuple ReadFromBlob(python::object blob);
 
     //
     // Internal types
@@ -142,6 +187,11 @@ public:
     //                         EdgeProperty,
     //                         vecS>  multigraph_t;
     typedef adj_list<size_t> multigraph_t;
+
+    // same as above, but with the adjacency lists stored as 32-bit integers,
+    // which halves their memory usage. The vertex and edge descriptors are the
+    // same as multigraph_t, so all property maps are shared.
+    typedef adj_list<size_t, uint32_t> multigraph32_t;
     typedef graph_traits<multigraph_t>::vertex_descriptor vertex_t;
     typedef graph_traits<multigraph_t>::edge_descriptor edge_t;
 
@@ -149,12 +199,38 @@ public:
     typedef property_map<multigraph_t,edge_index_t>::type edge_index_map_t;
     typedef ConstantPropertyMap<size_t,graph_property_tag> graph_index_map_t;
 
+    typedef csr_graph<uint32_t> csr_graph_t;
+
     // internal access
 
-    multigraph_t& GetGraph() {return *_mg;}
+    // this is only valid if the graph uses the default 64-bit index type;
+    // otherwise use RunOnGraph() below
+    multigraph_t& GetGraph()
+    {
+        if (_index32)
+            throw GraphException("graph does not use the default index type");
+        return *_mg;
+    }
+
+    // calls a(g) with the unfiltered adjacency list, which is either of type
+    // multigraph_t or multigraph32_t, depending on the index type
+    template <class Action>
+    void RunOnGraph(Action a)
+    {
+        if (_index32)
+            a(*_mg32);
+        else
+            a(*_mg);
+    }
+
     vertex_index_map_t GetVertexIndex() {return _vertex_index;}
     edge_index_map_t   GetEdgeIndex()   {return _edge_index;}
-    size_t             GetMaxEdgeIndex(){return _mg->get_last_index();}
+    size_t             GetMaxEdgeIndex() const
+    {
+        if (_csr->is_mapped())
+            return _csr->get_last_index();
+        return _index32 ? _mg32->get_last_index() : _mg->get_last_index();
+    }
 
     graph_index_map_t  GetGraphIndex()  {return graph_index_map_t(0);}
 
@@ -162,6 +238,18 @@ public:
     boost::any GetGraphView() const;
 
 private:
+    const csr_graph_t& UpdateFilterCache() const;
+
+    // binary format IO (see graph_io_binary.cc)
+    void WriteBinary(std::ostream& s, python::list properties);
+    python::tuple ReadBinary(std::istream& s, const std::set<string>& ignore_vp,
+                             const std::set<string>& ignore_ep,
+                             const std::set<string>& ignore_gp, bool lazy);
+    void WriteImage(std::ostream& s, python::list properties);
+    python::tuple ReadImage(const string& file,
+                            const std::set<string>& ignore_vp,
+                            const std::set<string>& ignore_ep,
+                            const std::set<string>& ignore_gp, bool lazy);
 
     // Generic graph_action functor. See graph_filtering.hh for details.
     template <class Action, class GraphViews, class Wrap, class TR1, class TR2,
@@ -173,8 +261,20 @@ private:
     template <class Graph>
     friend class PythonEdge;
 
-    // this is the main graph
+    // this is the main graph; only one of these is used, depending on the
+    // index type, and the other is always empty
     shared_ptr<multigraph_t> _mg;
+    shared_ptr<multigraph32_t> _mg32;
+    bool _index32;
+
+    // frozen CSR snapshot of the main graph (empty if not frozen). This is
+    // shared with the graph views, and is never reallocated, since the cached
+    // views in _graph_views keep references to it.
+    shared_ptr<csr_graph_t> _csr;
+
+    // names of the actions which caused the in-edge lists to be built (see
+    // SetKeepInEdges()). This is shared with the graph views.
+    shared_ptr<vector<string> > _in_edges_triggers;
 
     // vertex index map
     vertex_index_map_t _vertex_index;
@@ -205,6 +305,26 @@ private:
     edge_filter_t _edge_filter_map;
     bool _edge_filter_invert;
     bool _edge_filter_active;
+
+    // materialized filtered graph (see SetFilterCache()), together with the
+    // state of the graph and filters from which it was built. This belongs to
+    // each graph view, and is never reallocated, since the cached views in
+    // _graph_views keep references to it.
+    struct filter_cache_t
+    {
+        filter_cache_t(): enabled(false), valid(false) {}
+        bool enabled;
+        bool valid;
+        csr_graph_t g;
+        pair<size_t, size_t> version;
+        bool vertex_active, vertex_invert, edge_active, edge_invert;
+        vector<uint8_t> vertex_mask, edge_mask;
+    };
+    mutable filter_cache_t _filter_cache;
+
+    // the CSR graph (either _csr or the filter cache) referred to by the CSR
+    // views in _graph_views
+    mutable const csr_graph_t* _csr_view_base;
 };
 
 } //namespace graph_tool
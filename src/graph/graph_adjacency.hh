@@ -20,8 +20,10 @@
 
 #include <vector>
 #include <deque>
+#include <limits>
 #include <utility>
 #include <numeric>
+#include <algorithm>
 #include <iostream>
 #include <boost/iterator.hpp>
 #include <boost/graph/graph_traits.hpp>
@@ -30,12 +32,16 @@
 #include <boost/graph/properties.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/iterator/iterator_facade.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "transform_iterator.hh"
+#include "graph_exceptions.hh"
+#include "slab_allocator.hh"
 
 #include "tr1_include.hh"
 
 #include TR1_HEADER(tuple)
+#include TR1_HEADER(unordered_map)
 
 
 namespace boost
@@ -45,76 +51,76 @@ namespace boost
 // Forward declarations
 // ========================================================================
 
-template <class Vertex>
+template <class Vertex = size_t, class Index = Vertex>
 class adj_list;
 
 // forward declaration of manipulation functions
-template <class Vertex>
-std::pair<typename adj_list<Vertex>::vertex_iterator,
-          typename adj_list<Vertex>::vertex_iterator>
-vertices(const adj_list<Vertex>& g);
+template <class Vertex, class Index>
+std::pair<typename adj_list<Vertex, Index>::vertex_iterator,
+          typename adj_list<Vertex, Index>::vertex_iterator>
+vertices(const adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-std::pair<typename adj_list<Vertex>::edge_iterator,
-          typename adj_list<Vertex>::edge_iterator>
-edges(const adj_list<Vertex>& g);
+template <class Vertex, class Index>
+std::pair<typename adj_list<Vertex, Index>::edge_iterator,
+          typename adj_list<Vertex, Index>::edge_iterator>
+edges(const adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-std::pair<typename adj_list<Vertex>::edge_descriptor, bool>
-edge(Vertex s, Vertex t, const adj_list<Vertex>& g);
+template <class Vertex, class Index>
+std::pair<typename adj_list<Vertex, Index>::edge_descriptor, bool>
+edge(Vertex s, Vertex t, const adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-size_t out_degree(Vertex v, const adj_list<Vertex>& g);
+template <class Vertex, class Index>
+size_t out_degree(Vertex v, const adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-size_t in_degree(Vertex v, const adj_list<Vertex>& g);
+template <class Vertex, class Index>
+size_t in_degree(Vertex v, const adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-std::pair<typename adj_list<Vertex>::out_edge_iterator,
-          typename adj_list<Vertex>::out_edge_iterator>
-out_edges(Vertex v, const adj_list<Vertex>& g);
+template <class Vertex, class Index>
+std::pair<typename adj_list<Vertex, Index>::out_edge_iterator,
+          typename adj_list<Vertex, Index>::out_edge_iterator>
+out_edges(Vertex v, const adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-std::pair<typename adj_list<Vertex>::in_edge_iterator,
-          typename adj_list<Vertex>::in_edge_iterator>
-in_edges(Vertex v, const adj_list<Vertex>& g);
+template <class Vertex, class Index>
+std::pair<typename adj_list<Vertex, Index>::in_edge_iterator,
+          typename adj_list<Vertex, Index>::in_edge_iterator>
+in_edges(Vertex v, const adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-std::pair<typename adj_list<Vertex>::adjacency_iterator,
-          typename adj_list<Vertex>::adjacency_iterator>
-adjacent_vertices(Vertex v, const adj_list<Vertex>& g);
+template <class Vertex, class Index>
+std::pair<typename adj_list<Vertex, Index>::adjacency_iterator,
+          typename adj_list<Vertex, Index>::adjacency_iterator>
+adjacent_vertices(Vertex v, const adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-size_t num_vertices(const adj_list<Vertex>& g);
+template <class Vertex, class Index>
+size_t num_vertices(const adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-size_t num_edges(const adj_list<Vertex>& g);
+template <class Vertex, class Index>
+size_t num_edges(const adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-Vertex add_vertex(adj_list<Vertex>& g);
+template <class Vertex, class Index>
+Vertex add_vertex(adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-void clear_vertex(Vertex v, adj_list<Vertex>& g);
+template <class Vertex, class Index>
+void clear_vertex(Vertex v, adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-void remove_vertex(Vertex v, adj_list<Vertex>& g);
+template <class Vertex, class Index>
+void remove_vertex(Vertex v, adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-void remove_vertex_fast(Vertex v, adj_list<Vertex>& g);
+template <class Vertex, class Index>
+void remove_vertex_fast(Vertex v, adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-std::pair<typename adj_list<Vertex>::edge_descriptor, bool>
-add_edge(Vertex s, Vertex t, adj_list<Vertex>& g);
+template <class Vertex, class Index>
+std::pair<typename adj_list<Vertex, Index>::edge_descriptor, bool>
+add_edge(Vertex s, Vertex t, adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-void remove_edge(Vertex s, Vertex t, adj_list<Vertex>& g);
+template <class Vertex, class Index>
+void remove_edge(Vertex s, Vertex t, adj_list<Vertex, Index>& g);
 
-template <class Vertex>
-void remove_edge(const typename adj_list<Vertex>::edge_descriptor& e,
-                 adj_list<Vertex>& g);
+template <class Vertex, class Index>
+void remove_edge(const typename adj_list<Vertex, Index>::edge_descriptor& e,
+                 adj_list<Vertex, Index>& g);
 
 // ========================================================================
-// adj_list<Vertex>
+// adj_list<Vertex, Index>
 // ========================================================================
 //
 // adj_list is a very simple adjacency list implementation for bidirectional
@@ -123,32 +129,56 @@ void remove_edge(const typename adj_list<Vertex>::edge_descriptor& e,
 // each vertex, and each edge has a built-in index (which is replicated in both
 // lists). For each edge, a total of 4 integers is necessary: the source and
 // target vertices, in the in_edges and out_edges lists, respectively, and the
-// (same) edge index in both lists. The integer type is given by the Vertex
-// template parameter. It achieves about half as much memory as
+// (same) edge index in both lists. The integer type of the vertex and edge
+// descriptors is given by the Vertex template parameter, and the (possibly
+// narrower) integer type used to store the adjacency lists is given by the
+// Index template parameter. It achieves about half as much memory as
 // boost::adjacency_list with an edge index property map and the same integer
-// type.
+// type. With Index = uint32_t the memory usage is halved again, at the cost of
+// limiting the number of vertices and edges to 2^32 - 1. Since the descriptors
+// are the same, all property maps can be shared between both variants.
+//
+// Optionally, only the out-edge lists can be stored (see set_keep_in_edges()),
+// which halves the memory usage of graphs which are only traversed in the
+// forward direction. The in-edge lists are then built from the out-edge lists,
+// only once, when they are first needed, i.e. by in_edges(), in_degree() or
+// degree(). Without the in-edge lists, removing a vertex with clear_vertex(),
+// remove_vertex() or remove_vertex_fast() takes O(V + E) time.
+//
+// If USING_SLAB_ALLOCATOR is defined, the per-vertex edge lists are allocated
+// from size-class slabs (see slab_allocator.hh) instead of the general-purpose
+// heap, which avoids the per-allocation overhead and fragmentation of many
+// small lists.
 
 // The complexity guarantees and iterator invalidation rules are the same as
 // boost::adjacency_list with vector storage selectors for both vertex and edge
 // lists.
 
-template <class Vertex = size_t>
+template <class Vertex, class Index>
 class adj_list
 {
 public:
     struct graph_tag {};
     typedef Vertex vertex_t;
     typedef std::tr1::tuple<vertex_t, vertex_t, vertex_t> edge_descriptor;
-    typedef std::vector<std::pair<vertex_t, vertex_t> > edge_list_t;
+    typedef Index index_t;
+#ifdef USING_SLAB_ALLOCATOR
+    typedef std::vector<std::pair<index_t, index_t>,
+                        slab_allocator<std::pair<index_t, index_t> > >
+        edge_list_t;
+#else
+    typedef std::vector<std::pair<index_t, index_t> > edge_list_t;
+#endif
     typedef typename integer_range<Vertex>::iterator vertex_iterator;
 
-    adj_list(): _n_edges(0), _last_idx(0), _keep_epos(false) {}
+    adj_list(): _n_edges(0), _last_idx(0), _keep_epos(false),
+                _keep_eindex(false), _keep_in_edges(true), _version(0) {}
 
     struct get_vertex
     {
         get_vertex() {}
         typedef Vertex result_type;
-        Vertex operator()(const std::pair<vertex_t, vertex_t>& v) const
+        Vertex operator()(const std::pair<index_t, index_t>& v) const
         { return v.first; }
     };
 
@@ -161,8 +191,8 @@ public:
         make_out_edge() {}
         vertex_t _src;
         typedef edge_descriptor result_type;
-        edge_descriptor operator()(const std::pair<vertex_t, vertex_t>& v) const
-        { return std::tr1::make_tuple(_src, v.first, v.second); }
+        edge_descriptor operator()(const std::pair<index_t, index_t>& v) const
+        { return edge_descriptor(_src, v.first, v.second); }
     };
 
     struct make_in_edge
@@ -171,8 +201,8 @@ public:
         make_in_edge() {}
         vertex_t _tgt;
         typedef edge_descriptor result_type;
-        edge_descriptor operator()(const std::pair<vertex_t, vertex_t>& v) const
-        { return std::tr1::make_tuple(v.first, _tgt, v.second); }
+        edge_descriptor operator()(const std::pair<index_t, index_t>& v) const
+        { return edge_descriptor(v.first, _tgt, v.second); }
     };
 
     typedef transform_random_access_iterator<make_out_edge, typename edge_list_t::const_iterator>
@@ -227,8 +257,7 @@ public:
 
         edge_descriptor dereference() const
         {
-            return std::tr1::make_tuple(vertex_t(_vi - _vi_begin),
-                                        _ei->first, _ei->second);
+            return edge_descriptor(_vi - _vi_begin, _ei->first, _ei->second);
         }
 
         typename std::vector<edge_list_t>::const_iterator _vi_begin;
@@ -239,22 +268,27 @@ public:
 
     void reindex_edges()
     {
+        ++_version;
         _free_indexes.clear();
         _last_idx = 0;
         _in_edges.clear();
-        _in_edges.resize(_out_edges.size());
+        if (_keep_in_edges)
+            _in_edges.resize(_out_edges.size());
         for (size_t i = 0; i < _out_edges.size(); ++i)
             for (size_t j = 0; j < _out_edges[i].size(); ++j)
             {
                 Vertex v = _out_edges[i][j].first;
                 _out_edges[i][j].second = _last_idx;
-                _in_edges[v].push_back(std::make_pair(Vertex(i),
-                                                      _last_idx));
+                if (_keep_in_edges)
+                    _in_edges[v].push_back(std::make_pair(Vertex(i),
+                                                          _last_idx));
                 _last_idx++;
             }
 
         if (_keep_epos)
             rebuild_epos();
+        if (_keep_eindex)
+            rebuild_eindex();
     }
 
     void set_keep_epos(bool keep)
@@ -276,8 +310,287 @@ public:
         return _keep_epos;
     }
 
+    // if enabled, a hash index of all (source, target) pairs is kept, so that
+    // edge(s, t, g) can be answered in O(1) expected time, instead of O(k_s)
+    void set_keep_eindex(bool keep)
+    {
+        if (keep)
+        {
+            if (!_keep_eindex)
+                rebuild_eindex();
+        }
+        else
+        {
+            eindex_t().swap(_eindex);
+        }
+        _keep_eindex = keep;
+    }
+
+    bool get_keep_eindex()
+    {
+        return _keep_eindex;
+    }
+
+    // if disabled, the in-edge lists are discarded, and only the out-edge
+    // lists are maintained, until the in-edges are requested again
+    void set_keep_in_edges(bool keep)
+    {
+        if (keep)
+        {
+            build_in_edges();
+        }
+        else
+        {
+            vertex_list_t().swap(_in_edges);
+            _keep_in_edges = false;
+        }
+    }
+
+    bool get_keep_in_edges() const
+    {
+        return _keep_in_edges;
+    }
+
+    // builds the in-edge lists, if they are not kept. This is called by all
+    // functions which need them, which may happen concurrently in a parallel
+    // loop, so only the first call does the work, and the others wait for it.
+    // Although this modifies the graph, its structure is not changed.
+    void build_in_edges() const
+    {
+        if (_keep_in_edges)
+            return;
+        #pragma omp critical (adj_list_in_edges)
+        if (!_keep_in_edges)
+            const_cast<adj_list*>(this)->rebuild_in_edges();
+    }
+
+    // removes all edges, and resets the edge indexes
+    void clear_edges()
+    {
+        ++_version;
+        for (size_t i = 0; i < _out_edges.size(); ++i)
+            edge_list_t().swap(_out_edges[i]);
+        for (size_t i = 0; i < _in_edges.size(); ++i)
+            edge_list_t().swap(_in_edges[i]);
+        _n_edges = 0;
+        _last_idx = 0;
+        _free_indexes.clear();
+        _epos.clear();
+        _eindex.clear();
+    }
+
     size_t get_last_index() const { return _last_idx; }
 
+    // the pair (id, version) identifies the current state of the graph: the id
+    // is unique for each constructed graph, and the version is incremented by
+    // every modification of its structure
+    std::pair<size_t, size_t> get_version() const
+    {
+        return std::make_pair(_id.id, _version);
+    }
+
+    // copies the graph g, which may use a different index type. The vertex and
+    // edge indexes are preserved.
+    template <class OIndex>
+    void assign(const adj_list<Vertex, OIndex>& g)
+    {
+        size_t N = g._out_edges.size();
+        if (N > 0)
+            check_index(N - 1);
+        if (g._last_idx > 0)
+            check_index(g._last_idx - 1);
+        ++_version;
+
+        _out_edges.resize(N);
+        _in_edges.clear();
+        _in_edges.resize(g._in_edges.size());
+        for (size_t v = 0; v < N; ++v)
+            _out_edges[v].assign(g._out_edges[v].begin(),
+                                 g._out_edges[v].end());
+        for (size_t v = 0; v < g._in_edges.size(); ++v)
+            _in_edges[v].assign(g._in_edges[v].begin(),
+                                g._in_edges[v].end());
+        _keep_in_edges = g._keep_in_edges;
+        _n_edges = g._n_edges;
+        _last_idx = g._last_idx;
+        _free_indexes = g._free_indexes;
+        _keep_epos = g._keep_epos;
+        _epos = g._epos;
+        _keep_eindex = g._keep_eindex;
+        _eindex.clear();
+        if (_keep_eindex)
+            rebuild_eindex();
+    }
+
+    // reserve space for k_out (k_in) additional out- (in-) edges of vertex v;
+    // useful before inserting many edges at once
+    void reserve_edges(Vertex v, size_t k_out, size_t k_in)
+    {
+        _out_edges[v].reserve(_out_edges[v].size() + k_out);
+        if (_keep_in_edges)
+            _in_edges[v].reserve(_in_edges[v].size() + k_in);
+    }
+
+    // removes all vertices v for which deleted[v] is true, together with all
+    // their edges, in O(V + E) time. The remaining vertices are renumbered
+    // contiguously, keeping their relative order, and the remaining edges keep
+    // their indexes.
+    void purge_vertices(const std::vector<bool>& deleted)
+    {
+        ++_version;
+        size_t N = _out_edges.size();
+        std::vector<Vertex> new_index(N, null_vertex());
+        size_t n = 0;
+        for (size_t v = 0; v < N; ++v)
+        {
+            if (!deleted[v])
+                new_index[v] = n++;
+        }
+
+        // free the indexes of all removed edges; each edge is visited only
+        // once, in the out-edge list of its source
+        for (size_t v = 0; v < N; ++v)
+        {
+            edge_list_t& oes = _out_edges[v];
+            for (size_t j = 0; j < oes.size(); ++j)
+            {
+                if (deleted[v] || deleted[oes[j].first])
+                {
+                    _free_indexes.push_back(oes[j].second);
+                    _n_edges--;
+                }
+            }
+        }
+
+        // filter and relabel the edge lists of the remaining vertices
+        int i, NN = N;
+        #pragma omp parallel for default(shared) private(i) \
+            schedule(dynamic) if (NN > 100)
+        for (i = 0; i < NN; ++i)
+        {
+            if (deleted[i])
+                continue;
+            relabel_edge_list(_out_edges[i], deleted, new_index);
+            if (_keep_in_edges)
+                relabel_edge_list(_in_edges[i], deleted, new_index);
+        }
+
+        // move the edge lists to their new positions
+        for (size_t v = 0; v < N; ++v)
+        {
+            if (deleted[v] || new_index[v] == v)
+                continue;
+            _out_edges[new_index[v]].swap(_out_edges[v]);
+            if (_keep_in_edges)
+                _in_edges[new_index[v]].swap(_in_edges[v]);
+        }
+        _out_edges.resize(n);
+        if (_keep_in_edges)
+            _in_edges.resize(n);
+
+        if (_keep_epos)
+            rebuild_epos();
+        if (_keep_eindex)
+            rebuild_eindex();
+    }
+
+    // removes all edges e for which keep(e) is false, in O(V + E) time. The
+    // remaining edges keep their indexes and relative order.
+    template <class EdgePredicate>
+    void purge_edges(EdgePredicate keep)
+    {
+        ++_version;
+        size_t N = _out_edges.size();
+        for (size_t v = 0; v < N; ++v)
+        {
+            edge_list_t& oes = _out_edges[v];
+            size_t pos = 0;
+            for (size_t j = 0; j < oes.size(); ++j)
+            {
+                if (keep(edge_descriptor(v, oes[j].first, oes[j].second)))
+                {
+                    oes[pos++] = oes[j];
+                }
+                else
+                {
+                    _free_indexes.push_back(oes[j].second);
+                    _n_edges--;
+                }
+            }
+            oes.resize(pos);
+        }
+
+        int i, NN = _in_edges.size();
+        #pragma omp parallel for default(shared) private(i) \
+            schedule(dynamic) if (NN > 100)
+        for (i = 0; i < NN; ++i)
+        {
+            edge_list_t& ies = _in_edges[i];
+            size_t pos = 0;
+            for (size_t j = 0; j < ies.size(); ++j)
+            {
+                if (keep(edge_descriptor(ies[j].first, i, ies[j].second)))
+                    ies[pos++] = ies[j];
+            }
+            ies.resize(pos);
+        }
+
+        if (_keep_epos)
+            rebuild_epos();
+        if (_keep_eindex)
+            rebuild_eindex();
+    }
+
+    // renumbers the vertices such that v becomes new_index[v], which must be a
+    // permutation of the vertices. The edge lists are relabelled and sorted by
+    // neighbour, and the edges keep their indexes.
+    void permute_vertices(const std::vector<Vertex>& new_index)
+    {
+        ++_version;
+        size_t N = _out_edges.size();
+        vertex_list_t out_edges(N), in_edges(_in_edges.size());
+        for (size_t v = 0; v < N; ++v)
+        {
+            out_edges[new_index[v]].swap(_out_edges[v]);
+            if (_keep_in_edges)
+                in_edges[new_index[v]].swap(_in_edges[v]);
+        }
+        _out_edges.swap(out_edges);
+        _in_edges.swap(in_edges);
+
+        int i, NN = N;
+        #pragma omp parallel for default(shared) private(i) \
+            schedule(dynamic) if (NN > 100)
+        for (i = 0; i < NN; ++i)
+        {
+            relabel_edge_list(_out_edges[i], new_index);
+            if (_keep_in_edges)
+                relabel_edge_list(_in_edges[i], new_index);
+        }
+
+        if (_keep_epos)
+            rebuild_epos();
+        if (_keep_eindex)
+            rebuild_eindex();
+    }
+
+    // number of bytes used by the adjacency lists and auxiliary indexes
+    size_t memory_usage() const
+    {
+        size_t m = (_out_edges.capacity() + _in_edges.capacity()) *
+            sizeof(edge_list_t);
+        for (size_t i = 0; i < _out_edges.size(); ++i)
+            m += list_memory(_out_edges[i]);
+        for (size_t i = 0; i < _in_edges.size(); ++i)
+            m += list_memory(_in_edges[i]);
+        m += _epos.capacity() * sizeof(typename epos_t::value_type);
+        m += _free_indexes.size() * sizeof(size_t);
+        m += _eindex.bucket_count() * sizeof(void*) +
+            _eindex.size() * (sizeof(typename eindex_t::value_type) +
+                              sizeof(void*));
+        return m;
+    }
+
     static Vertex null_vertex() { return std::numeric_limits<Vertex>::max(); }
 
 private:
@@ -291,7 +604,116 @@ private:
                                       // indexes, and unnecessary property map
                                       // memory use
     bool _keep_epos;
-    std::vector<std::pair<int32_t, int32_t> > _epos;
+    typedef std::vector<std::pair<int32_t, int32_t> > epos_t;
+    epos_t _epos;
+
+    typedef std::tr1::unordered_multimap<std::pair<Index, Index>, Index,
+                                         boost::hash<std::pair<Index, Index> > >
+        eindex_t;
+    bool _keep_eindex;
+    eindex_t _eindex;
+
+    bool _keep_in_edges; // if false, _in_edges is empty
+
+    // a new id is drawn whenever the graph is constructed, copied or assigned
+    struct unique_id
+    {
+        unique_id(): id(next()) {}
+        unique_id(const unique_id&): id(next()) {}
+        unique_id& operator=(const unique_id&) { id = next(); return *this; }
+        size_t id;
+
+        static size_t next()
+        {
+            static size_t count = 0;
+            size_t i;
+            #pragma omp critical (adj_list_id)
+            i = count++;
+            return i;
+        }
+    };
+    unique_id _id;
+    size_t _version;
+
+    static size_t list_memory(const edge_list_t& es)
+    {
+#ifdef USING_SLAB_ALLOCATOR
+        return slab_pool<typename edge_list_t::value_type>::
+            block_bytes(es.capacity());
+#else
+        // estimate of the chunk size of a typical malloc implementation, with
+        // one size_t header, aligned to 2 * sizeof(size_t)
+        size_t bytes = es.capacity() * sizeof(typename edge_list_t::value_type);
+        if (bytes == 0)
+            return 0;
+        size_t align = 2 * sizeof(size_t);
+        return std::max((bytes + sizeof(size_t) + align - 1) / align * align,
+                        2 * align);
+#endif
+    }
+
+    // throws if i cannot be stored as an Index (null_vertex() is reserved)
+    static void check_index(size_t i)
+    {
+        if (i >= size_t(std::numeric_limits<Index>::max()))
+            throw graph_tool::ValueException("the maximum number of vertices "
+                                             "or edges for the chosen index "
+                                             "type was exceeded");
+    }
+
+    static void relabel_edge_list(edge_list_t& es,
+                                  const std::vector<Vertex>& new_index)
+    {
+        for (size_t j = 0; j < es.size(); ++j)
+            es[j].first = new_index[es[j].first];
+        std::sort(es.begin(), es.end());
+    }
+
+    static void relabel_edge_list(edge_list_t& es,
+                                  const std::vector<bool>& deleted,
+                                  const std::vector<Vertex>& new_index)
+    {
+        size_t pos = 0;
+        for (size_t j = 0; j < es.size(); ++j)
+        {
+            if (deleted[es[j].first])
+                continue;
+            es[pos] = es[j];
+            es[pos].first = new_index[es[j].first];
+            ++pos;
+        }
+        es.resize(pos);
+    }
+
+    void eindex_insert(Vertex s, Vertex t, Vertex idx)
+    {
+        _eindex.insert(std::make_pair(std::make_pair(s, t), idx));
+    }
+
+    void eindex_erase(Vertex s, Vertex t, Vertex idx)
+    {
+        typedef typename eindex_t::iterator iter_t;
+        std::pair<iter_t, iter_t> range =
+            _eindex.equal_range(std::make_pair(s, t));
+        for (iter_t iter = range.first; iter != range.second; ++iter)
+        {
+            if (iter->second == idx)
+            {
+                _eindex.erase(iter);
+                break;
+            }
+        }
+    }
+
+    void rebuild_eindex()
+    {
+        _eindex.clear();
+        _eindex.rehash(_n_edges);
+        for (size_t i = 0; i < _out_edges.size(); ++i)
+            for (size_t j = 0; j < _out_edges[i].size(); ++j)
+                eindex_insert(i, _out_edges[i][j].first,
+                              _out_edges[i][j].second);
+    }
 
     void rebuild_epos()
     {
@@ -303,7 +725,9 @@ private:
                 size_t idx = _out_edges[i][j].second;
                 _epos[idx].first = j;
             }
-
+        }
+        for (size_t i = 0; i < _in_edges.size(); ++i)
+        {
             for (size_t j = 0; j < _in_edges[i].size(); ++j)
             {
                 size_t idx = _in_edges[i][j].second;
@@ -312,47 +736,78 @@ private:
         }
     }
 
+    // the in-edges of each vertex are ordered by source, as in
+    // reindex_edges()
+    void rebuild_in_edges()
+    {
+        size_t N = _out_edges.size();
+        std::vector<size_t> k_in(N, 0);
+        for (size_t i = 0; i < N; ++i)
+            for (size_t j = 0; j < _out_edges[i].size(); ++j)
+                k_in[_out_edges[i][j].first]++;
+
+        _in_edges.clear();
+        _in_edges.resize(N);
+        for (size_t i = 0; i < N; ++i)
+            _in_edges[i].reserve(k_in[i]);
+        for (size_t i = 0; i < N; ++i)
+            for (size_t j = 0; j < _out_edges[i].size(); ++j)
+                _in_edges[_out_edges[i][j].first].
+                    push_back(std::make_pair(Vertex(i),
+                                             _out_edges[i][j].second));
+        if (_keep_epos)
+            rebuild_epos();
+
+        // the lists must be complete before any other thread can see the
+        // flag
+        #pragma omp flush
+        _keep_in_edges = true;
+    }
+
+    template <class V, class I>
+    friend class adj_list;
+
     // manipulation functions
     friend std::pair<vertex_iterator, vertex_iterator>
-    vertices<>(const adj_list<Vertex>& g);
+    vertices<>(const adj_list<Vertex, Index>& g);
 
     friend std::pair<edge_iterator, edge_iterator>
-    edges<>(const adj_list<Vertex>& g);
+    edges<>(const adj_list<Vertex, Index>& g);
 
     friend std::pair<edge_descriptor, bool>
-    edge<>(Vertex s, Vertex t, const adj_list<Vertex>& g);
+    edge<>(Vertex s, Vertex t, const adj_list<Vertex, Index>& g);
 
-    friend size_t out_degree<>(Vertex v, const adj_list<Vertex>& g);
+    friend size_t out_degree<>(Vertex v, const adj_list<Vertex, Index>& g);
 
-    friend size_t in_degree<>(Vertex v, const adj_list<Vertex>& g);
+    friend size_t in_degree<>(Vertex v, const adj_list<Vertex, Index>& g);
 
     friend std::pair<out_edge_iterator, out_edge_iterator>
-    out_edges<>(Vertex v, const adj_list<Vertex>& g);
+    out_edges<>(Vertex v, const adj_list<Vertex, Index>& g);
 
     friend std::pair<in_edge_iterator, in_edge_iterator>
-    in_edges<>(Vertex v, const adj_list<Vertex>& g);
+    in_edges<>(Vertex v, const adj_list<Vertex, Index>& g);
 
     friend std::pair<adjacency_iterator, adjacency_iterator>
-    adjacent_vertices<>(Vertex v, const adj_list<Vertex>& g);
+    adjacent_vertices<>(Vertex v, const adj_list<Vertex, Index>& g);
 
-    friend size_t num_vertices<>(const adj_list<Vertex>& g);
+    friend size_t num_vertices<>(const adj_list<Vertex, Index>& g);
 
-    friend size_t num_edges<>(const adj_list<Vertex>& g);
+    friend size_t num_edges<>(const adj_list<Vertex, Index>& g);
 
-    friend Vertex add_vertex<>(adj_list<Vertex>& g);
+    friend Vertex add_vertex<>(adj_list<Vertex, Index>& g);
 
-    friend void clear_vertex<>(Vertex v, adj_list<Vertex>& g);
+    friend void clear_vertex<>(Vertex v, adj_list<Vertex, Index>& g);
 
-    friend void remove_vertex<>(Vertex v, adj_list<Vertex>& g);
+    friend void remove_vertex<>(Vertex v, adj_list<Vertex, Index>& g);
 
-    friend void remove_vertex_fast<>(Vertex v, adj_list<Vertex>& g);
+    friend void remove_vertex_fast<>(Vertex v, adj_list<Vertex, Index>& g);
 
     friend std::pair<edge_descriptor, bool>
-    add_edge<>(Vertex s, Vertex t, adj_list<Vertex>& g);
+    add_edge<>(Vertex s, Vertex t, adj_list<Vertex, Index>& g);
 
-    friend void remove_edge<>(Vertex s, Vertex t, adj_list<Vertex>& g);
+    friend void remove_edge<>(Vertex s, Vertex t, adj_list<Vertex, Index>& g);
 
-    friend void remove_edge<>(const edge_descriptor& e, adj_list<Vertex>& g);
+    friend void remove_edge<>(const edge_descriptor& e, adj_list<Vertex, Index>& g);
 };
 
 //========================================================================
@@ -365,18 +820,18 @@ struct adj_list_traversal_tag
       public adjacency_graph_tag,
       public bidirectional_graph_tag { };
 
-template <class Vertex>
-struct graph_traits<adj_list<Vertex> >
+template <class Vertex, class Index>
+struct graph_traits<adj_list<Vertex, Index> >
 {
     typedef Vertex vertex_descriptor;
-    typedef typename adj_list<Vertex>::edge_descriptor edge_descriptor;
-    typedef typename adj_list<Vertex>::edge_iterator edge_iterator;
-    typedef typename adj_list<Vertex>::adjacency_iterator adjacency_iterator;
+    typedef typename adj_list<Vertex, Index>::edge_descriptor edge_descriptor;
+    typedef typename adj_list<Vertex, Index>::edge_iterator edge_iterator;
+    typedef typename adj_list<Vertex, Index>::adjacency_iterator adjacency_iterator;
 
-    typedef typename adj_list<Vertex>::out_edge_iterator out_edge_iterator;
-    typedef typename adj_list<Vertex>::in_edge_iterator in_edge_iterator;
+    typedef typename adj_list<Vertex, Index>::out_edge_iterator out_edge_iterator;
+    typedef typename adj_list<Vertex, Index>::in_edge_iterator in_edge_iterator;
 
-    typedef typename adj_list<Vertex>::vertex_iterator vertex_iterator;
+    typedef typename adj_list<Vertex, Index>::vertex_iterator vertex_iterator;
 
     typedef bidirectional_tag directed_category;
     typedef allow_parallel_edge_tag edge_parallel_category;
@@ -386,7 +841,7 @@ struct graph_traits<adj_list<Vertex> >
     typedef Vertex edges_size_type;
     typedef size_t degree_size_type;
 
-    static Vertex null_vertex() { return adj_list<Vertex>::null_vertex(); }
+    static Vertex null_vertex() { return adj_list<Vertex, Index>::null_vertex(); }
 private:
     BOOST_STATIC_ASSERT((is_convertible<typename std::iterator_traits<out_edge_iterator>::iterator_category,
                                         std::random_access_iterator_tag>::value));
@@ -396,27 +851,27 @@ private:
                                         std::random_access_iterator_tag>::value));
 };
 
-template <class Vertex>
-struct graph_traits<const adj_list<Vertex> >
-    : public graph_traits<adj_list<Vertex> >
+template <class Vertex, class Index>
+struct graph_traits<const adj_list<Vertex, Index> >
+    : public graph_traits<adj_list<Vertex, Index> >
 {
 };
 
 
-template <class Vertex>
-struct edge_property_type<adj_list<Vertex> >
+template <class Vertex, class Index>
+struct edge_property_type<adj_list<Vertex, Index> >
 {
     typedef void type;
 };
 
-template <class Vertex>
-struct vertex_property_type<adj_list<Vertex> >
+template <class Vertex, class Index>
+struct vertex_property_type<adj_list<Vertex, Index> >
 {
     typedef void type;
 };
 
-template <class Vertex>
-struct graph_property_type<adj_list<Vertex> >
+template <class Vertex, class Index>
+struct graph_property_type<adj_list<Vertex, Index> >
 {
     typedef void type;
 };
@@ -425,175 +880,236 @@ struct graph_property_type<adj_list<Vertex> >
 // Graph access and manipulation functions
 //========================================================================
 
-template <class Vertex>
-inline std::pair<typename adj_list<Vertex>::vertex_iterator,
-                 typename adj_list<Vertex>::vertex_iterator>
-vertices(const adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline std::pair<typename adj_list<Vertex, Index>::vertex_iterator,
+                 typename adj_list<Vertex, Index>::vertex_iterator>
+vertices(const adj_list<Vertex, Index>& g)
 {
-    typedef typename adj_list<Vertex>::vertex_iterator vi_t;
+    typedef typename adj_list<Vertex, Index>::vertex_iterator vi_t;
     return std::make_pair(vi_t(0), vi_t(g._out_edges.size()));
 }
 
 
-template <class Vertex>
-inline std::pair<typename adj_list<Vertex>::edge_iterator,
-                 typename adj_list<Vertex>::edge_iterator>
-edges(const adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline std::pair<typename adj_list<Vertex, Index>::edge_iterator,
+                 typename adj_list<Vertex, Index>::edge_iterator>
+edges(const adj_list<Vertex, Index>& g)
 {
-    typedef typename adj_list<Vertex>::edge_list_t::const_iterator ei_t;
-    typedef typename adj_list<Vertex>::vertex_list_t::const_iterator vi_t;
+    typedef typename adj_list<Vertex, Index>::edge_list_t::const_iterator ei_t;
+    typedef typename adj_list<Vertex, Index>::vertex_list_t::const_iterator vi_t;
     ei_t ei_begin = g._out_edges.empty() ? ei_t() : g._out_edges[0].begin();
     vi_t last_vi = g._out_edges.end();
     if (!g._out_edges.empty())
         --last_vi;
     ei_t ei_end = g._out_edges.empty() ? ei_t() : last_vi->end();
-    typename adj_list<Vertex>::edge_iterator ebegin(g._out_edges.begin(),
+    typename adj_list<Vertex, Index>::edge_iterator ebegin(g._out_edges.begin(),
                                                     g._out_edges.end(),
                                                     g._out_edges.begin(),
                                                     ei_begin);
-    typename adj_list<Vertex>::edge_iterator eend(g._out_edges.begin(),
+    typename adj_list<Vertex, Index>::edge_iterator eend(g._out_edges.begin(),
                                                   g._out_edges.end(),
                                                   last_vi,
                                                   ei_end);
     return std::make_pair(ebegin, eend);
 }
 
-template <class Vertex>
-inline Vertex vertex(size_t i, const adj_list<Vertex>&)
+template <class Vertex, class Index>
+inline Vertex vertex(size_t i, const adj_list<Vertex, Index>&)
 {
     return i;
 }
 
-template <class Vertex>
-inline std::pair<typename adj_list<Vertex>::edge_descriptor, bool>
-edge(Vertex s, Vertex t, const adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline std::pair<typename adj_list<Vertex, Index>::edge_descriptor, bool>
+edge(Vertex s, Vertex t, const adj_list<Vertex, Index>& g)
 {
-    const typename adj_list<Vertex>::edge_list_t& oes = g._out_edges[s];
-    for (size_t i = 0; i < oes.size(); ++i)
-        if (oes[i].first == t)
-            return std::make_pair(std::tr1::make_tuple(s, t, oes[i].second), true);
-    Vertex v = graph_traits<adj_list<Vertex> >::null_vertex();
+    if (g._keep_eindex) // O(1) expected
+    {
+        typename adj_list<Vertex, Index>::eindex_t::const_iterator iter =
+            g._eindex.find(std::make_pair(s, t));
+        if (iter != g._eindex.end())
+            return std::make_pair(std::tr1::make_tuple(s, t, iter->second),
+                                  true);
+    }
+    else // O(k_s)
+    {
+        const typename adj_list<Vertex, Index>::edge_list_t& oes = g._out_edges[s];
+        for (size_t i = 0; i < oes.size(); ++i)
+            if (oes[i].first == t)
+                return std::make_pair(std::tr1::make_tuple(s, t, oes[i].second),
+                                      true);
+    }
+    Vertex v = graph_traits<adj_list<Vertex, Index> >::null_vertex();
     return std::make_pair(std::tr1::make_tuple(v, v, v), false);
 }
 
-template <class Vertex>
-inline size_t out_degree(Vertex v, const adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline size_t out_degree(Vertex v, const adj_list<Vertex, Index>& g)
 {
     return g._out_edges[v].size();
 }
 
-template <class Vertex>
-inline size_t in_degree(Vertex v, const adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline size_t in_degree(Vertex v, const adj_list<Vertex, Index>& g)
 {
+    g.build_in_edges();
     return g._in_edges[v].size();
 }
 
-template <class Vertex>
-inline size_t degree(Vertex v, const adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline size_t degree(Vertex v, const adj_list<Vertex, Index>& g)
 {
     return in_degree(v, g) + out_degree(v, g);
 }
 
-template <class Vertex>
-inline std::pair<typename adj_list<Vertex>::out_edge_iterator,
-                 typename adj_list<Vertex>::out_edge_iterator>
-out_edges(Vertex v, const adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline std::pair<typename adj_list<Vertex, Index>::out_edge_iterator,
+                 typename adj_list<Vertex, Index>::out_edge_iterator>
+out_edges(Vertex v, const adj_list<Vertex, Index>& g)
 {
-    typedef typename adj_list<Vertex>::out_edge_iterator ei_t;
-    typedef typename adj_list<Vertex>::make_out_edge mk_edge;
+    typedef typename adj_list<Vertex, Index>::out_edge_iterator ei_t;
+    typedef typename adj_list<Vertex, Index>::make_out_edge mk_edge;
     return std::make_pair(ei_t(g._out_edges[v].begin(), mk_edge(v)),
                           ei_t(g._out_edges[v].end(), mk_edge(v)));
 }
 
-template <class Vertex>
-inline std::pair<typename adj_list<Vertex>::in_edge_iterator,
-                 typename adj_list<Vertex>::in_edge_iterator>
-in_edges(Vertex v, const adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline std::pair<typename adj_list<Vertex, Index>::in_edge_iterator,
+                 typename adj_list<Vertex, Index>::in_edge_iterator>
+in_edges(Vertex v, const adj_list<Vertex, Index>& g)
 {
-    typedef typename adj_list<Vertex>::in_edge_iterator ei_t;
-    typedef typename adj_list<Vertex>::make_in_edge mk_edge;
+    typedef typename adj_list<Vertex, Index>::in_edge_iterator ei_t;
+    typedef typename adj_list<Vertex, Index>::make_in_edge mk_edge;
+    g.build_in_edges();
     return std::make_pair(ei_t(g._in_edges[v].begin(), mk_edge(v)),
                           ei_t(g._in_edges[v].end(), mk_edge(v)));
 }
 
-template <class Vertex>
-inline std::pair<typename adj_list<Vertex>::adjacency_iterator,
-                 typename adj_list<Vertex>::adjacency_iterator>
-adjacent_vertices(Vertex v, const adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline std::pair<typename adj_list<Vertex, Index>::adjacency_iterator,
+                 typename adj_list<Vertex, Index>::adjacency_iterator>
+adjacent_vertices(Vertex v, const adj_list<Vertex, Index>& g)
 {
-    typedef typename adj_list<Vertex>::adjacency_iterator ai_t;
+    typedef typename adj_list<Vertex, Index>::adjacency_iterator ai_t;
     return std::make_pair(ai_t(g._out_edges[v].begin()),
                           ai_t(g._out_edges[v].end()));
 }
 
-template <class Vertex>
-inline size_t num_vertices(const adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline size_t num_vertices(const adj_list<Vertex, Index>& g)
 {
     return g._out_edges.size();
 }
 
-template <class Vertex>
-inline size_t num_edges(const adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline size_t num_edges(const adj_list<Vertex, Index>& g)
 {
     return g._n_edges;
 }
 
-template <class Vertex>
-inline Vertex add_vertex(adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline Vertex add_vertex(adj_list<Vertex, Index>& g)
 {
     size_t n = g._out_edges.size();
+    g.check_index(n);
+    ++g._version;
     g._out_edges.resize(n + 1);
-    g._in_edges.resize(n + 1);
+    if (g._keep_in_edges)
+        g._in_edges.resize(n + 1);
     return n;
 }
 
-template <class Vertex>
-inline void clear_vertex(Vertex v, adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline void clear_vertex(Vertex v, adj_list<Vertex, Index>& g)
 {
+    ++g._version;
+    if (!g._keep_in_edges) // O(V + E), since the in-edges must be searched
+    {
+        for (size_t u = 0; u < g._out_edges.size(); ++u)
+        {
+            typename adj_list<Vertex, Index>::edge_list_t& oes = g._out_edges[u];
+            size_t pos = 0;
+            for (size_t i = 0; i < oes.size(); ++i)
+            {
+                if (u == v || oes[i].first == v)
+                {
+                    if (g._keep_eindex)
+                        g.eindex_erase(u, oes[i].first, oes[i].second);
+                    g._free_indexes.push_back(oes[i].second);
+                    g._n_edges--;
+                }
+                else
+                {
+                    oes[pos++] = oes[i];
+                }
+            }
+            oes.resize(pos);
+        }
+        if (g._keep_epos)
+            g.rebuild_epos();
+        return;
+    }
+
+    if (g._keep_eindex)
+    {
+        typename adj_list<Vertex, Index>::edge_list_t& oes = g._out_edges[v];
+        for (size_t i = 0; i < oes.size(); ++i)
+            g.eindex_erase(v, oes[i].first, oes[i].second);
+        typename adj_list<Vertex, Index>::edge_list_t& ies = g._in_edges[v];
+        for (size_t i = 0; i < ies.size(); ++i)
+            if (ies[i].first != v)
+                g.eindex_erase(ies[i].first, v, ies[i].second);
+    }
+
     if (!g._keep_epos)
     {
-        typename adj_list<Vertex>::edge_list_t& oes = g._out_edges[v];
+        typename adj_list<Vertex, Index>::edge_list_t& oes = g._out_edges[v];
         for (size_t i = 0; i < oes.size(); ++i)
         {
             Vertex t = oes[i].first;
-            typename adj_list<Vertex>::edge_list_t& ies = g._in_edges[t];
+            size_t idx = oes[i].second;
+            typename adj_list<Vertex, Index>::edge_list_t& ies = g._in_edges[t];
             for (size_t j = 0; j < ies.size(); ++j)
             {
-                if (ies[j].first == v)
+                if (ies[j].first == v && ies[j].second == idx)
                 {
-                    g._free_indexes.push_back(ies[j].second);
                     ies.erase(ies.begin() + j);
+                    break;
                 }
             }
+            g._free_indexes.push_back(idx);
         }
         g._n_edges -= oes.size();
         oes.clear();
 
-        typename adj_list<Vertex>::edge_list_t& ies = g._in_edges[v];
-        for (size_t i = 0; i < oes.size(); ++i)
+        // self-loops were already removed above
+        typename adj_list<Vertex, Index>::edge_list_t& ies = g._in_edges[v];
+        for (size_t i = 0; i < ies.size(); ++i)
         {
             Vertex s = ies[i].first;
-            typename adj_list<Vertex>::edge_list_t& oes = g._out_edges[s];
+            size_t idx = ies[i].second;
+            typename adj_list<Vertex, Index>::edge_list_t& oes = g._out_edges[s];
             for (size_t j = 0; j < oes.size(); ++j)
             {
-                if (oes[j].first == v)
+                if (oes[j].first == v && oes[j].second == idx)
                 {
-                    g._free_indexes.push_back(oes[j].second);
                     oes.erase(oes.begin() + j);
+                    break;
                 }
             }
+            g._free_indexes.push_back(idx);
         }
         g._n_edges -= ies.size();
         ies.clear();
     }
     else
     {
-        typename adj_list<Vertex>::edge_list_t& oes = g._out_edges[v];
+        typename adj_list<Vertex, Index>::edge_list_t& oes = g._out_edges[v];
         for (size_t i = 0; i < oes.size(); ++i)
         {
             Vertex t = oes[i].first;
             size_t idx = oes[i].second;
-            typename adj_list<Vertex>::edge_list_t& ies = g._in_edges[t];
+            typename adj_list<Vertex, Index>::edge_list_t& ies = g._in_edges[t];
             const std::pair<int32_t, int32_t>& pos = g._epos[idx];
 
             g._epos[ies.back().second].second = pos.second;
@@ -604,12 +1120,12 @@ inline void clear_vertex(Vertex v, adj_list<Vertex>& g)
         g._n_edges -= oes.size();
         oes.clear();
 
-        typename adj_list<Vertex>::edge_list_t& ies = g._in_edges[v];
+        typename adj_list<Vertex, Index>::edge_list_t& ies = g._in_edges[v];
         for (size_t i = 0; i < ies.size(); ++i)
         {
             Vertex s = ies[i].first;
             size_t idx = ies[i].second;
-            typename adj_list<Vertex>::edge_list_t& oes = g._out_edges[s];
+            typename adj_list<Vertex, Index>::edge_list_t& oes = g._out_edges[s];
             const std::pair<int32_t, int32_t>& pos = g._epos[idx];
 
             g._epos[oes.back().second].first = pos.first;
@@ -623,12 +1139,14 @@ inline void clear_vertex(Vertex v, adj_list<Vertex>& g)
 }
 
 // O(V + E)
-template <class Vertex>
-inline void remove_vertex(Vertex v, adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline void remove_vertex(Vertex v, adj_list<Vertex, Index>& g)
 {
     clear_vertex(v, g);
+    ++g._version;
     g._out_edges.erase(g._out_edges.begin() + v);
-    g._in_edges.erase(g._in_edges.begin() + v);
+    if (g._keep_in_edges)
+        g._in_edges.erase(g._in_edges.begin() + v);
 
     int i, N = g._out_edges.size();
     #pragma omp parallel for default(shared) private(i)
@@ -639,23 +1157,60 @@ inline void remove_vertex(Vertex v, adj_list<Vertex>& g)
             if (g._out_edges[i][j].first > v)
                 g._out_edges[i][j].first--;
         }
+        if (!g._keep_in_edges)
+            continue;
         for (size_t j = 0; j < g._in_edges[i].size(); ++j)
         {
             if (g._in_edges[i][j].first > v)
                 g._in_edges[i][j].first--;
         }
     }
+
+    if (g._keep_eindex)
+        g.rebuild_eindex();
 }
 
 // O(k + k_last)
-template <class Vertex>
-inline void remove_vertex_fast(Vertex v, adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline void remove_vertex_fast(Vertex v, adj_list<Vertex, Index>& g)
 {
     clear_vertex(v, g);
+    ++g._version;
     Vertex back = g._out_edges.size() - 1;
 
+    if (!g._keep_in_edges) // O(V + E)
+    {
+        if (v < back)
+        {
+            g._out_edges[v].swap(g._out_edges[back]);
+            for (size_t u = 0; u < back; ++u)
+            {
+                typename adj_list<Vertex, Index>::edge_list_t& oes =
+                    g._out_edges[u];
+                for (size_t i = 0; i < oes.size(); ++i)
+                    if (oes[i].first == back)
+                        oes[i].first = v;
+            }
+            if (g._keep_eindex)
+                g.rebuild_eindex();
+        }
+        g._out_edges.pop_back();
+        return;
+    }
+
     if (v < back)
     {
+        if (g._keep_eindex)
+        {
+            for (size_t i = 0; i < g._out_edges[back].size(); ++i)
+                g.eindex_erase(back, g._out_edges[back][i].first,
+                               g._out_edges[back][i].second);
+            for (size_t i = 0; i < g._in_edges[back].size(); ++i)
+                if (g._in_edges[back][i].first != back)
+                    g.eindex_erase(g._in_edges[back][i].first, back,
+                                   g._in_edges[back][i].second);
+        }
+
         g._out_edges[v].swap(g._out_edges[back]);
         g._in_edges[v].swap(g._in_edges[back]);
 
@@ -679,7 +1234,7 @@ inline void remove_vertex_fast(Vertex v, adj_list<Vertex>& g)
             Vertex u = g._in_edges[v][i].first;
             if (u == back)
             {
-                g._out_edges[v][i].first = v;
+                g._in_edges[v][i].first = v;
             }
             else
             {
@@ -688,19 +1243,31 @@ inline void remove_vertex_fast(Vertex v, adj_list<Vertex>& g)
                         g._out_edges[u][j].first = v;
             }
         }
+
+        if (g._keep_eindex)
+        {
+            for (size_t i = 0; i < g._out_edges[v].size(); ++i)
+                g.eindex_insert(v, g._out_edges[v][i].first,
+                                g._out_edges[v][i].second);
+            for (size_t i = 0; i < g._in_edges[v].size(); ++i)
+                if (g._in_edges[v][i].first != v)
+                    g.eindex_insert(g._in_edges[v][i].first, v,
+                                    g._in_edges[v][i].second);
+        }
     }
 
     g._out_edges.pop_back();
     g._in_edges.pop_back();
 }
 
-template <class Vertex>
-inline typename std::pair<typename adj_list<Vertex>::edge_descriptor, bool>
-add_edge(Vertex s, Vertex t, adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline typename std::pair<typename adj_list<Vertex, Index>::edge_descriptor, bool>
+add_edge(Vertex s, Vertex t, adj_list<Vertex, Index>& g)
 {
     Vertex idx;
     if (g._free_indexes.empty())
     {
+        g.check_index(g._last_idx);
         idx = g._last_idx++;
     }
     else
@@ -708,9 +1275,11 @@ add_edge(Vertex s, Vertex t, adj_list<Vertex>& g)
         idx = g._free_indexes.front();
         g._free_indexes.pop_front();
     }
+    ++g._version;
 
     g._out_edges[s].push_back(std::make_pair(t, idx));
-    g._in_edges[t].push_back(std::make_pair(s, idx));
+    if (g._keep_in_edges)
+        g._in_edges[t].push_back(std::make_pair(s, idx));
     g._n_edges++;
 
     if (g._keep_epos)
@@ -718,51 +1287,74 @@ add_edge(Vertex s, Vertex t, adj_list<Vertex>& g)
         if (idx >= g._epos.size())
             g._epos.resize(idx + 1);
         g._epos[idx].first = g._out_edges[s].size() - 1;
-        g._epos[idx].second = g._in_edges[t].size() - 1;
+        if (g._keep_in_edges)
+            g._epos[idx].second = g._in_edges[t].size() - 1;
     }
 
+    if (g._keep_eindex)
+        g.eindex_insert(s, t, idx);
+
     return std::make_pair(std::tr1::make_tuple(s, t, idx), true);
 }
 
-template <class Vertex>
+template <class Vertex, class Index>
 inline void remove_edge(Vertex s, Vertex t,
-                        adj_list<Vertex>& g)
+                        adj_list<Vertex, Index>& g)
 {
+    // all parallel edges from s to t are removed
+    ++g._version;
     if (!g._keep_epos)
     {
-        typename adj_list<Vertex>::edge_list_t& oes = g._out_edges[s];
+        typename adj_list<Vertex, Index>::edge_list_t& oes = g._out_edges[s];
+        size_t pos = 0;
         for (size_t i = 0; i < oes.size(); ++i)
         {
             if (t == oes[i].first)
             {
+                if (g._keep_eindex)
+                    g.eindex_erase(s, t, oes[i].second);
                 g._free_indexes.push_back(oes[i].second);
-                oes.erase(oes.begin() + i);
                 g._n_edges--;
             }
+            else
+            {
+                oes[pos++] = oes[i];
+            }
         }
+        oes.resize(pos);
 
-        typename adj_list<Vertex>::edge_list_t& ies = g._in_edges[t];
+        if (!g._keep_in_edges)
+            return;
+        typename adj_list<Vertex, Index>::edge_list_t& ies = g._in_edges[t];
+        pos = 0;
         for (size_t i = 0; i < ies.size(); ++i)
         {
-            if (s == ies[i].first)
-                ies.erase(ies.begin() + i);
+            if (s != ies[i].first)
+                ies[pos++] = ies[i];
         }
+        ies.resize(pos);
     }
     else
     {
-        remove_edge(edge(s, t, g).first, g);
+        std::pair<typename adj_list<Vertex, Index>::edge_descriptor, bool> e =
+            edge(s, t, g);
+        while (e.second)
+        {
+            remove_edge(e.first, g);
+            e = edge(s, t, g);
+        }
     }
 }
 
-template <class Vertex>
-inline void remove_edge(const typename adj_list<Vertex>::edge_descriptor& e,
-                        adj_list<Vertex>& g)
+template <class Vertex, class Index>
+inline void remove_edge(const typename adj_list<Vertex, Index>::edge_descriptor& e,
+                        adj_list<Vertex, Index>& g)
 {
     Vertex s = get<0>(e);
     Vertex t = get<1>(e);
     Vertex idx = get<2>(e);
-    typename adj_list<Vertex>::edge_list_t& oes = g._out_edges[s];
-    typename adj_list<Vertex>::edge_list_t& ies = g._in_edges[t];
+    typename adj_list<Vertex, Index>::edge_list_t& oes = g._out_edges[s];
+    ++g._version;
 
     if (!g._keep_epos) // O(k_s + k_t)
     {
@@ -775,12 +1367,16 @@ inline void remove_edge(const typename adj_list<Vertex>::edge_descriptor& e,
             }
         }
 
-        for (size_t i = 0; i < ies.size(); ++i)
+        if (g._keep_in_edges)
         {
-            if (s == ies[i].first && idx == ies[i].second)
+            typename adj_list<Vertex, Index>::edge_list_t& ies = g._in_edges[t];
+            for (size_t i = 0; i < ies.size(); ++i)
             {
-                ies.erase(ies.begin() + i);
-                break;
+                if (s == ies[i].first && idx == ies[i].second)
+                {
+                    ies.erase(ies.begin() + i);
+                    break;
+                }
             }
         }
     }
@@ -792,25 +1388,33 @@ inline void remove_edge(const typename adj_list<Vertex>::edge_descriptor& e,
         oes[pos.first] = oes.back();
         oes.pop_back();
 
-        g._epos[ies.back().second].second = pos.second;
-        ies[pos.second] = ies.back();
-        ies.pop_back();
+        if (g._keep_in_edges)
+        {
+            typename adj_list<Vertex, Index>::edge_list_t& ies = g._in_edges[t];
+            g._epos[ies.back().second].second = pos.second;
+            ies[pos.second] = ies.back();
+            ies.pop_back();
+        }
     }
+
+    if (g._keep_eindex)
+        g.eindex_erase(s, t, idx);
+
     g._free_indexes.push_back(idx);
     g._n_edges--;
 }
 
 
-template <class Vertex>
-inline Vertex source(const typename adj_list<Vertex>::edge_descriptor& e,
-                     const adj_list<Vertex>&)
+template <class Vertex, class Index>
+inline Vertex source(const typename adj_list<Vertex, Index>::edge_descriptor& e,
+                     const adj_list<Vertex, Index>&)
 {
     return get<0>(e);
 }
 
-template <class Vertex>
-inline Vertex target(const typename adj_list<Vertex>::edge_descriptor& e,
-                     const adj_list<Vertex>&)
+template <class Vertex, class Index>
+inline Vertex target(const typename adj_list<Vertex, Index>::edge_descriptor& e,
+                     const adj_list<Vertex, Index>&)
 {
     return get<1>(e);
 
@@ -820,30 +1424,30 @@ inline Vertex target(const typename adj_list<Vertex>::edge_descriptor& e,
 // Vertex and edge index property maps
 //========================================================================
 
-template <class Vertex>
-struct property_map<adj_list<Vertex>, vertex_index_t>
+template <class Vertex, class Index>
+struct property_map<adj_list<Vertex, Index>, vertex_index_t>
 {
     typedef identity_property_map type;
     typedef type const_type;
 };
 
-template <class Vertex>
-struct property_map<const adj_list<Vertex>, vertex_index_t>
+template <class Vertex, class Index>
+struct property_map<const adj_list<Vertex, Index>, vertex_index_t>
 {
     typedef identity_property_map type;
     typedef type const_type;
 };
 
-template <class Vertex>
+template <class Vertex, class Index>
 inline identity_property_map
-get(vertex_index_t, adj_list<Vertex>&)
+get(vertex_index_t, adj_list<Vertex, Index>&)
 {
     return identity_property_map();
 }
 
-template <class Vertex>
+template <class Vertex, class Index>
 inline identity_property_map
-get(vertex_index_t, const adj_list<Vertex>&)
+get(vertex_index_t, const adj_list<Vertex, Index>&)
 {
     return identity_property_map();
 }
@@ -871,17 +1475,17 @@ public:
     reference operator[](const key_type& k) const {return get<2>(k);}
 };
 
-template <class Vertex>
-struct property_map<adj_list<Vertex>, edge_index_t>
+template <class Vertex, class Index>
+struct property_map<adj_list<Vertex, Index>, edge_index_t>
 {
     typedef adj_edge_index_property_map<Vertex> type;
     typedef type const_type;
 
 };
 
-template <class Vertex>
+template <class Vertex, class Index>
 inline adj_edge_index_property_map<Vertex>
-get(edge_index_t, const adj_list<Vertex>&)
+get(edge_index_t, const adj_list<Vertex, Index>&)
 {
     return adj_edge_index_property_map<Vertex>();
 }
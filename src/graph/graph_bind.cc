@@ -321,6 +321,15 @@ bool openmp_enabled()
 #endif
 }
 
+bool slab_allocator_enabled()
+{
+#ifdef USING_SLAB_ALLOCATOR
+    return true;
+#else
+    return false;
+#endif
+}
+
 // numpy array interface weirdness
 void* do_import_array()
 {
@@ -336,6 +345,11 @@ void infect_vertex_property(GraphInterface& gi, boost::any prop,
                             python::object val);
 void edge_difference(GraphInterface& gi, boost::any prop,
                      boost::any eprop);
+void intern_string_property(GraphInterface& gi, boost::any prop,
+                            boost::any codes, python::list strings, bool edge);
+void unintern_string_property(GraphInterface& gi, boost::any codes,
+                              python::list strings, boost::any prop,
+                              bool edge);
 void export_python_interface();
 
 BOOST_PYTHON_MODULE(libgraph_tool_core)
@@ -362,12 +376,18 @@ BOOST_PYTHON_MODULE(libgraph_tool_core)
 
     def("graph_filtering_enabled", &graph_filtering_enabled);
     def("openmp_enabled", &openmp_enabled);
+    def("slab_allocator_enabled", &slab_allocator_enabled);
 
     mpl::for_each<mpl::push_back<scalar_types,string>::type>(export_vector_types());
 
     class_<GraphInterface>("GraphInterface", init<>())
-        .def(init<GraphInterface,bool,python::object,python::object,python::object>())
+        .def(init<bool>())
+        .def(init<GraphInterface,bool,python::object,python::object,
+                  python::object,bool>())
+        .def("GetIndex32", &GraphInterface::GetIndex32)
         .def("GetNumberOfVertices", &GraphInterface::GetNumberOfVertices)
+        .def("GetTotalNumberOfVertices",
+             &GraphInterface::GetTotalNumberOfVertices)
         .def("GetNumberOfEdges", &GraphInterface::GetNumberOfEdges)
         .def("SetDirected", &GraphInterface::SetDirected)
         .def("GetDirected", &GraphInterface::GetDirected)
@@ -375,6 +395,18 @@ BOOST_PYTHON_MODULE(libgraph_tool_core)
         .def("GetReversed", &GraphInterface::GetReversed)
         .def("SetKeepEpos", &GraphInterface::SetKeepEpos)
         .def("GetKeepEpos", &GraphInterface::GetKeepEpos)
+        .def("SetKeepEindex", &GraphInterface::SetKeepEindex)
+        .def("GetKeepEindex", &GraphInterface::GetKeepEindex)
+        .def("SetKeepInEdges", &GraphInterface::SetKeepInEdges)
+        .def("GetKeepInEdges", &GraphInterface::GetKeepInEdges)
+        .def("GetInEdgesTriggers", &GraphInterface::GetInEdgesTriggers)
+        .def("GetMemoryUsage", &GraphInterface::GetMemoryUsage)
+        .def("SetFilterCache", &GraphInterface::SetFilterCache)
+        .def("GetFilterCache", &GraphInterface::GetFilterCache)
+        .def("SetFrozen", &GraphInterface::SetFrozen)
+        .def("GetFrozen", &GraphInterface::GetFrozen)
+        .def("GetFrozenMemoryUsage", &GraphInterface::GetFrozenMemoryUsage)
+        .def("GetMapped", &GraphInterface::GetMapped)
         .def("SetVertexFilterProperty",
              &GraphInterface::SetVertexFilterProperty)
         .def("IsVertexFilterActive", &GraphInterface::IsVertexFilterActive)
@@ -382,12 +414,18 @@ BOOST_PYTHON_MODULE(libgraph_tool_core)
              &GraphInterface::SetEdgeFilterProperty)
         .def("IsEdgeFilterActive", &GraphInterface::IsEdgeFilterActive)
         .def("PurgeVertices",  &GraphInterface::PurgeVertices)
+        .def("ReorderVertices",  &GraphInterface::ReorderVertices)
         .def("PurgeEdges",  &GraphInterface::PurgeEdges)
         .def("ShiftVertexProperty",  &GraphInterface::ShiftVertexProperty)
         .def("MoveVertexProperty",  &GraphInterface::MoveVertexProperty)
         .def("ReIndexVertexProperty",  &GraphInterface::ReIndexVertexProperty)
+        .def("PermuteVertexProperty",  &GraphInterface::PermuteVertexProperty)
         .def("WriteToFile", &GraphInterface::WriteToFile)
         .def("ReadFromFile",&GraphInterface::ReadFromFile)
+        .def("ReadProperty", &GraphInterface::ReadProperty)
+        .def("ReadEdgeList", &GraphInterface::ReadEdgeList)
+        .def("WriteToBlob", &GraphInterface::WriteToBlob)
+        .def("ReadFromBlob", &GraphInterface::ReadFromBlob)
         .def("DegreeMap", &GraphInterface::DegreeMap)
         .def("Clear", &GraphInterface::Clear)
         .def("ClearEdges", &GraphInterface::ClearEdges)
@@ -433,6 +471,8 @@ BOOST_PYTHON_MODULE(libgraph_tool_core)
     def("ungroup_vector_property", &ungroup_vector_property);
     def("infect_vertex_property", &infect_vertex_property);
     def("edge_difference", &edge_difference);
+    def("intern_string_property", &intern_string_property);
+    def("unintern_string_property", &unintern_string_property);
 
     class_<LibInfo>("mod_info")
         .add_property("name", &LibInfo::GetName)
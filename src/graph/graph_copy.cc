@@ -300,26 +300,50 @@ struct do_graph_copy
 // copy constructor
 GraphInterface::GraphInterface(const GraphInterface& gi, bool keep_ref,
                                python::object ovprops, python::object oeprops,
-                               python::object vorder)
+                               python::object vorder, bool index32)
     :_mg(keep_ref ? gi._mg : shared_ptr<multigraph_t>(new multigraph_t())),
+     _mg32(keep_ref ? gi._mg32 :
+           shared_ptr<multigraph32_t>(new multigraph32_t())),
+     _index32(keep_ref ? gi._index32 : index32),
+     _csr(keep_ref ? gi._csr : shared_ptr<csr_graph_t>(new csr_graph_t())),
+     _in_edges_triggers(keep_ref ? gi._in_edges_triggers :
+                        shared_ptr<vector<string> >(new vector<string>())),
      _vertex_index(get(vertex_index, *_mg)),
      _edge_index(get(edge_index_t(), *_mg)),
      _reversed(gi._reversed),
      _directed(gi._directed),
-     _vertex_filter_map(_vertex_index),
+     // views share the (inactive) filter storage of gi until their own
+     // filters are set, so that no allocation is done here
+     _vertex_filter_map(keep_ref ? gi._vertex_filter_map :
+                        vertex_filter_t(_vertex_index)),
      _vertex_filter_invert(false),
      _vertex_filter_active(false),
-     _edge_filter_map(_edge_index),
+     _edge_filter_map(keep_ref ? gi._edge_filter_map :
+                      edge_filter_t(_edge_index)),
      _edge_filter_invert(false),
-     _edge_filter_active(false)
+     _edge_filter_active(false),
+     _csr_view_base(0)
 {
     if (keep_ref)
         return;
 
     if (vorder == python::object())
     {
-        // simple copying
-        *_mg = *gi._mg;
+        // simple copying, possibly converting the index type
+        if (_index32)
+        {
+            if (gi._index32)
+                *_mg32 = *gi._mg32;
+            else
+                _mg32->assign(*gi._mg);
+        }
+        else
+        {
+            if (gi._index32)
+                _mg->assign(*gi._mg32);
+            else
+                *_mg = *gi._mg;
+        }
         return;
     }
 
@@ -337,11 +361,20 @@ GraphInterface::GraphInterface(const GraphInterface& gi, bool keep_ref,
     }
 
     boost::any avorder = python::extract<boost::any>(vorder);
-    run_action<>()
-        (const_cast<GraphInterface&>(gi),
-         bind<void>(do_graph_copy(gi._mg->get_last_index()), _1, ref(*_mg),
-                    gi._vertex_index, _vertex_index, gi._edge_index,
-                    _edge_index, _2, ref(vprops), ref(eprops)),
-         vertex_scalar_properties())(avorder);
+    size_t max_eindex = const_cast<GraphInterface&>(gi).GetMaxEdgeIndex();
+    if (_index32)
+        run_action<>()
+            (const_cast<GraphInterface&>(gi),
+             bind<void>(do_graph_copy(max_eindex), _1, ref(*_mg32),
+                        gi._vertex_index, _vertex_index, gi._edge_index,
+                        _edge_index, _2, ref(vprops), ref(eprops)),
+             vertex_scalar_properties())(avorder);
+    else
+        run_action<>()
+            (const_cast<GraphInterface&>(gi),
+             bind<void>(do_graph_copy(max_eindex), _1, ref(*_mg),
+                        gi._vertex_index, _vertex_index, gi._edge_index,
+                        _edge_index, _2, ref(vprops), ref(eprops)),
+             vertex_scalar_properties())(avorder);
     // filters will be copied in python
 }
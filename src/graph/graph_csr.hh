@@ -0,0 +1,888 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2013 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_CSR_HH
+#define GRAPH_CSR_HH
+
+#include <vector>
+#include <limits>
+#include <utility>
+#include <boost/shared_ptr.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/filtered_graph.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include "graph_adjacency.hh"
+#include "graph_exceptions.hh"
+#include "transform_iterator.hh"
+
+namespace boost
+{
+
+// ========================================================================
+// csr_array<T>
+// ========================================================================
+//
+// Contiguous array used for the adjacency of csr_graph. It either owns its
+// values, which are kept in a std::vector, or refers to values stored
+// elsewhere, such as in a memory-mapped file, which are never modified, and
+// which are kept alive by a shared handle. Any resizing operation discards
+// the external values, and switches back to the owned storage.
+
+template <class T>
+class csr_array
+{
+public:
+    csr_array(): _data(0), _size(0) {}
+
+    csr_array(const csr_array& a)
+        : _vec(a._vec), _data(a._data), _size(a._size), _handle(a._handle)
+    {
+        if (!is_mapped())
+            sync();
+    }
+
+    csr_array& operator=(const csr_array& a)
+    {
+        _vec = a._vec;
+        _data = a._data;
+        _size = a._size;
+        _handle = a._handle;
+        if (!is_mapped())
+            sync();
+        return *this;
+    }
+
+    // refers to the n values at the given address, which must remain valid
+    // while the handle is alive
+    void map(const T* data, size_t n, const shared_ptr<void>& handle)
+    {
+        std::vector<T>().swap(_vec);
+        _data = const_cast<T*>(data);
+        _size = n;
+        _handle = handle;
+    }
+
+    bool is_mapped() const { return _handle.get() != 0; }
+
+    void resize(size_t n)
+    {
+        release();
+        _vec.resize(n);
+        sync();
+    }
+
+    void assign(size_t n, const T& val)
+    {
+        release();
+        _vec.assign(n, val);
+        sync();
+    }
+
+    void clear()
+    {
+        release();
+        std::vector<T>().swap(_vec);
+        sync();
+    }
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    // allocated memory (the external values are not counted)
+    size_t capacity() const { return _vec.capacity(); }
+
+    T& operator[](size_t i) { return _data[i]; }
+    const T& operator[](size_t i) const { return _data[i]; }
+
+private:
+    void release()
+    {
+        if (is_mapped())
+        {
+            _handle.reset();
+            sync();
+        }
+    }
+
+    void sync()
+    {
+        _data = _vec.empty() ? 0 : &_vec[0];
+        _size = _vec.size();
+    }
+
+    std::vector<T> _vec;
+    T* _data;
+    size_t _size;
+    shared_ptr<void> _handle;
+};
+
+// ========================================================================
+// csr_graph<Index>
+// ========================================================================
+//
+// csr_graph is an immutable, compressed sparse row snapshot of an
+// adj_list<size_t>. The out- and in-edges of all vertices are stored
+// contiguously in two pairs of arrays (neighbour and edge index), addressed by
+// an offset array with one entry per vertex. The integer type used for storage
+// is given by the Index template parameter, which is typically uint32_t, so
+// that each edge requires a total of 4 integers of this type (against 4
+// size_t's in adj_list), and no per-vertex heap allocation is necessary.
+//
+// The vertex and edge descriptors are the same as adj_list<size_t>, and the
+// edge indexes are preserved, so that all vertex and edge property maps of the
+// original graph can be used unmodified with the snapshot. The snapshot does
+// not track further modifications of the original graph, and it can not be
+// modified itself: all manipulation functions throw a GraphException.
+//
+// The snapshot can also be built from a filtered graph, in which case only the
+// remaining edges are stored, and the remaining vertices are marked in a
+// bit-packed mask. As with filtered_graph, num_vertices() still returns the
+// total number of vertices, and vertex(i, g) returns null_vertex() for vertices
+// which were filtered out. The vertex iterators skip 64 masked vertices at a
+// time, and the edges need no filtering at all.
+//
+// Finally, the arrays can be made to refer to an external, read-only image of
+// the adjacency (see map()), e.g. a memory-mapped file, in which case nothing
+// is copied, and the pages are only read when they are accessed.
+
+template <class Index = uint32_t>
+class csr_graph
+{
+public:
+    struct graph_tag {};
+    typedef size_t vertex_t;
+    typedef Index index_t;
+    typedef adj_list<size_t>::edge_descriptor edge_descriptor;
+    class vertex_iterator;
+
+    csr_graph(): _last_idx(0) {}
+
+    template <class Graph>
+    explicit csr_graph(const Graph& g): _last_idx(0) { build(g); }
+
+    // (re)builds the snapshot from the given graph, in one pass over its
+    // adjacency lists
+    template <class Graph>
+    void build(const Graph& g)
+    {
+        build(g, keep_all(), keep_all());
+    }
+
+    // (re)builds the snapshot from the edges e = (s, t) of the given graph for
+    // which edge_pred(e), vertex_pred(s) and vertex_pred(t) hold. All the
+    // vertices are kept, and the vertex and edge indexes are preserved, so that
+    // the property maps of the original graph remain valid; the vertices for
+    // which vertex_pred(v) does not hold are simply left without edges.
+    template <class Graph, class EdgePredicate, class VertexPredicate>
+    void build(const Graph& g, EdgePredicate edge_pred,
+               VertexPredicate vertex_pred)
+    {
+        size_t N = num_vertices(g);
+        size_t E = num_edges(g);
+        size_t max_idx = g.get_last_index();
+        if (N >= size_t(std::numeric_limits<Index>::max()) ||
+            E >= size_t(std::numeric_limits<Index>::max()) ||
+            max_idx >= size_t(std::numeric_limits<Index>::max()))
+            throw graph_tool::ValueException("graph is too large for the "
+                                             "requested CSR index type");
+
+        _out_offsets.resize(N + 1);
+        _in_offsets.resize(N + 1);
+        _out_offsets[0] = _in_offsets[0] = 0;
+
+        int i, M = N;
+        #pragma omp parallel for default(shared) private(i) \
+            schedule(static) if (M > 100)
+        for (i = 0; i < M; ++i)
+        {
+            _out_offsets[i + 1] = count_out_edges(i, g, edge_pred, vertex_pred);
+            _in_offsets[i + 1] = count_in_edges(i, g, edge_pred, vertex_pred);
+        }
+        for (size_t v = 0; v < N; ++v)
+        {
+            _out_offsets[v + 1] += _out_offsets[v];
+            _in_offsets[v + 1] += _in_offsets[v];
+        }
+
+        E = _out_offsets[N];
+        _out_targets.resize(E);
+        _out_eidx.resize(E);
+        _in_sources.resize(E);
+        _in_eidx.resize(E);
+
+        #pragma omp parallel for default(shared) private(i) \
+            schedule(static) if (M > 100)
+        for (i = 0; i < M; ++i)
+        {
+            if (!vertex_pred(size_t(i)))
+                continue;
+
+            size_t pos = _out_offsets[i];
+            typename graph_traits<Graph>::out_edge_iterator e, e_end;
+            for (tie(e, e_end) = out_edges(size_t(i), g); e != e_end; ++e)
+            {
+                if (!vertex_pred(target(*e, g)) || !edge_pred(*e))
+                    continue;
+                _out_targets[pos] = target(*e, g);
+                _out_eidx[pos] = get<2>(*e);
+                ++pos;
+            }
+
+            pos = _in_offsets[i];
+            typename graph_traits<Graph>::in_edge_iterator ie, ie_end;
+            for (tie(ie, ie_end) = in_edges(size_t(i), g); ie != ie_end; ++ie)
+            {
+                if (!vertex_pred(source(*ie, g)) || !edge_pred(*ie))
+                    continue;
+                _in_sources[pos] = source(*ie, g);
+                _in_eidx[pos] = get<2>(*ie);
+                ++pos;
+            }
+        }
+        build_vertex_mask(N, vertex_pred);
+        _last_idx = max_idx;
+    }
+
+    // the adjacency arrays, in the order in which they are given to map()
+    static const size_t n_arrays = 6;
+
+    const csr_array<Index>& get_array(size_t i) const
+    {
+        const csr_array<Index>* arrays[n_arrays] =
+            {&_out_offsets, &_out_targets, &_out_eidx,
+             &_in_offsets, &_in_sources, &_in_eidx};
+        return *arrays[i];
+    }
+
+    // makes the snapshot refer to the given adjacency arrays, with N + 1, E,
+    // E, N + 1, E and E values, respectively, instead of copying them. The
+    // arrays must remain valid while the handle is alive. No vertex is masked.
+    void map(const Index* const arrays[n_arrays], size_t N, size_t E,
+             size_t last_idx, const shared_ptr<void>& handle)
+    {
+        csr_array<Index>* members[n_arrays] =
+            {&_out_offsets, &_out_targets, &_out_eidx,
+             &_in_offsets, &_in_sources, &_in_eidx};
+        for (size_t i = 0; i < n_arrays; ++i)
+            members[i]->map(arrays[i], (i % 3 == 0) ? N + 1 : E, handle);
+        std::vector<uint64_t>().swap(_vertex_mask);
+        _last_idx = last_idx;
+    }
+
+    void clear()
+    {
+        _out_offsets.clear();
+        _out_targets.clear();
+        _out_eidx.clear();
+        _in_offsets.clear();
+        _in_sources.clear();
+        _in_eidx.clear();
+        std::vector<uint64_t>().swap(_vertex_mask);
+        _last_idx = 0;
+    }
+
+    // a snapshot is valid if it was built from a graph (or mapped) and not
+    // cleared
+    bool is_valid() const { return !_out_offsets.empty(); }
+
+    // whether the arrays refer to an external image (see map())
+    bool is_mapped() const { return _out_offsets.is_mapped(); }
+
+    size_t get_last_index() const { return _last_idx; }
+
+    // memory allocated for the adjacency arrays, in bytes (mapped arrays are
+    // not counted)
+    size_t memory_usage() const
+    {
+        return sizeof(Index) * (_out_offsets.capacity() +
+                                _out_targets.capacity() +
+                                _out_eidx.capacity() +
+                                _in_offsets.capacity() +
+                                _in_sources.capacity() +
+                                _in_eidx.capacity()) +
+            sizeof(uint64_t) * _vertex_mask.capacity();
+    }
+
+    // whether the vertex v was filtered out when the graph was built
+    bool is_masked(size_t v) const
+    {
+        return !_vertex_mask.empty() &&
+            !((_vertex_mask[v / 64] >> (v % 64)) & 1);
+    }
+
+    static size_t null_vertex() { return std::numeric_limits<size_t>::max(); }
+
+    // iterates over the vertices which are not masked, skipping whole words
+    // of the mask with count-trailing-zeros
+    class vertex_iterator:
+        public iterator_facade<vertex_iterator, size_t,
+                               forward_traversal_tag, size_t>
+    {
+    public:
+        vertex_iterator(): _mask(0), _v(0), _N(0) {}
+        vertex_iterator(const uint64_t* mask, size_t v, size_t N)
+            : _mask(mask), _v(v), _N(N) { skip(); }
+
+    private:
+        friend class boost::iterator_core_access;
+
+        void skip()
+        {
+            if (_mask == 0 || _v >= _N)
+                return;
+            size_t w = _v / 64;
+            uint64_t bits = _mask[w] >> (_v % 64);
+            if (bits == 0)
+            {
+                size_t n_words = (_N + 63) / 64;
+                do
+                {
+                    ++w;
+                }
+                while (w < n_words && _mask[w] == 0);
+                if (w == n_words)
+                {
+                    _v = _N;
+                    return;
+                }
+                _v = w * 64;
+                bits = _mask[w];
+            }
+            _v += __builtin_ctzll(bits);
+        }
+
+        void increment()
+        {
+            ++_v;
+            skip();
+        }
+
+        bool equal(vertex_iterator const& other) const
+        {
+            return _v == other._v;
+        }
+
+        size_t dereference() const { return _v; }
+
+        const uint64_t* _mask;
+        size_t _v;
+        size_t _N;
+    };
+
+    struct make_out_edge
+    {
+        make_out_edge(): _g(0), _src(0) {}
+        make_out_edge(const csr_graph* g, size_t src): _g(g), _src(src) {}
+        typedef edge_descriptor result_type;
+        edge_descriptor operator()(size_t pos) const
+        {
+            return std::tr1::make_tuple(_src, size_t(_g->_out_targets[pos]),
+                                        size_t(_g->_out_eidx[pos]));
+        }
+        const csr_graph* _g;
+        size_t _src;
+    };
+
+    struct make_in_edge
+    {
+        make_in_edge(): _g(0), _tgt(0) {}
+        make_in_edge(const csr_graph* g, size_t tgt): _g(g), _tgt(tgt) {}
+        typedef edge_descriptor result_type;
+        edge_descriptor operator()(size_t pos) const
+        {
+            return std::tr1::make_tuple(size_t(_g->_in_sources[pos]), _tgt,
+                                        size_t(_g->_in_eidx[pos]));
+        }
+        const csr_graph* _g;
+        size_t _tgt;
+    };
+
+    struct get_target
+    {
+        get_target(): _g(0) {}
+        get_target(const csr_graph* g): _g(g) {}
+        typedef size_t result_type;
+        size_t operator()(size_t pos) const
+        {
+            return _g->_out_targets[pos];
+        }
+        const csr_graph* _g;
+    };
+
+    typedef counting_iterator<size_t> pos_iterator;
+
+    typedef transform_random_access_iterator<make_out_edge, pos_iterator>
+        out_edge_iterator;
+    typedef transform_random_access_iterator<make_in_edge, pos_iterator>
+        in_edge_iterator;
+    typedef transform_random_access_iterator<get_target, pos_iterator>
+        adjacency_iterator;
+
+    class edge_iterator:
+        public boost::iterator_facade<edge_iterator,
+                                      edge_descriptor,
+                                      boost::forward_traversal_tag,
+                                      edge_descriptor>
+    {
+    public:
+        edge_iterator(): _g(0), _v(0), _pos(0) {}
+        edge_iterator(const csr_graph* g, size_t v, size_t pos)
+            : _g(g), _v(v), _pos(pos)
+        {
+            skip();
+        }
+
+    private:
+        friend class boost::iterator_core_access;
+
+        void skip()
+        {
+            // skip vertices with no (remaining) out-edges
+            size_t N = _g->_out_offsets.size() - 1;
+            while (_v < N && _pos >= size_t(_g->_out_offsets[_v + 1]))
+                ++_v;
+        }
+
+        void increment()
+        {
+            ++_pos;
+            skip();
+        }
+
+        bool equal(edge_iterator const& other) const
+        {
+            return _pos == other._pos;
+        }
+
+        edge_descriptor dereference() const
+        {
+            return std::tr1::make_tuple(_v, size_t(_g->_out_targets[_pos]),
+                                        size_t(_g->_out_eidx[_pos]));
+        }
+
+        const csr_graph* _g;
+        size_t _v;
+        size_t _pos;
+    };
+
+private:
+    csr_array<Index> _out_offsets;
+    csr_array<Index> _out_targets;
+    csr_array<Index> _out_eidx;
+    csr_array<Index> _in_offsets;
+    csr_array<Index> _in_sources;
+    csr_array<Index> _in_eidx;
+    std::vector<uint64_t> _vertex_mask; // empty if no vertex is masked
+    size_t _last_idx;
+
+    template <class VertexPredicate>
+    void build_vertex_mask(size_t N, VertexPredicate vertex_pred)
+    {
+        // the bits past N are kept unset
+        _vertex_mask.assign((N + 63) / 64, 0);
+        int i, M = _vertex_mask.size();
+        #pragma omp parallel for default(shared) private(i) \
+            schedule(static) if (M > 100)
+        for (i = 0; i < M; ++i)
+        {
+            uint64_t word = 0;
+            for (size_t j = 0; j < 64 && i * 64 + j < N; ++j)
+                if (vertex_pred(size_t(i * 64 + j)))
+                    word |= uint64_t(1) << j;
+            _vertex_mask[i] = word;
+        }
+    }
+
+    void build_vertex_mask(size_t, keep_all)
+    {
+        std::vector<uint64_t>().swap(_vertex_mask);
+    }
+
+    template <class Graph, class EdgePredicate, class VertexPredicate>
+    static size_t count_out_edges(size_t v, const Graph& g,
+                                  EdgePredicate edge_pred,
+                                  VertexPredicate vertex_pred)
+    {
+        if (!vertex_pred(v))
+            return 0;
+        size_t k = 0;
+        typename graph_traits<Graph>::out_edge_iterator e, e_end;
+        for (tie(e, e_end) = out_edges(v, g); e != e_end; ++e)
+            if (vertex_pred(target(*e, g)) && edge_pred(*e))
+                ++k;
+        return k;
+    }
+
+    template <class Graph, class EdgePredicate, class VertexPredicate>
+    static size_t count_in_edges(size_t v, const Graph& g,
+                                 EdgePredicate edge_pred,
+                                 VertexPredicate vertex_pred)
+    {
+        if (!vertex_pred(v))
+            return 0;
+        size_t k = 0;
+        typename graph_traits<Graph>::in_edge_iterator e, e_end;
+        for (tie(e, e_end) = in_edges(v, g); e != e_end; ++e)
+            if (vertex_pred(source(*e, g)) && edge_pred(*e))
+                ++k;
+        return k;
+    }
+
+    // without filtering, the degrees are simply copied
+    template <class Graph>
+    static size_t count_out_edges(size_t v, const Graph& g, keep_all, keep_all)
+    {
+        return out_degree(v, g);
+    }
+
+    template <class Graph>
+    static size_t count_in_edges(size_t v, const Graph& g, keep_all, keep_all)
+    {
+        return in_degree(v, g);
+    }
+
+    template <class I>
+    friend std::pair<typename csr_graph<I>::vertex_iterator,
+                     typename csr_graph<I>::vertex_iterator>
+    vertices(const csr_graph<I>& g);
+
+    template <class I>
+    friend size_t num_vertices(const csr_graph<I>& g);
+
+    template <class I>
+    friend size_t num_edges(const csr_graph<I>& g);
+
+    template <class I>
+    friend size_t out_degree(size_t v, const csr_graph<I>& g);
+
+    template <class I>
+    friend size_t in_degree(size_t v, const csr_graph<I>& g);
+
+    template <class I>
+    friend std::pair<typename csr_graph<I>::out_edge_iterator,
+                     typename csr_graph<I>::out_edge_iterator>
+    out_edges(size_t v, const csr_graph<I>& g);
+
+    template <class I>
+    friend std::pair<typename csr_graph<I>::in_edge_iterator,
+                     typename csr_graph<I>::in_edge_iterator>
+    in_edges(size_t v, const csr_graph<I>& g);
+
+    template <class I>
+    friend std::pair<typename csr_graph<I>::adjacency_iterator,
+                     typename csr_graph<I>::adjacency_iterator>
+    adjacent_vertices(size_t v, const csr_graph<I>& g);
+
+    template <class I>
+    friend std::pair<typename csr_graph<I>::edge_iterator,
+                     typename csr_graph<I>::edge_iterator>
+    edges(const csr_graph<I>& g);
+
+    template <class I>
+    friend std::pair<typename csr_graph<I>::edge_descriptor, bool>
+    edge(size_t s, size_t t, const csr_graph<I>& g);
+};
+
+//========================================================================
+// Graph traits and BGL scaffolding
+//========================================================================
+
+template <class Index>
+struct graph_traits<csr_graph<Index> >
+{
+    typedef size_t vertex_descriptor;
+    typedef typename csr_graph<Index>::edge_descriptor edge_descriptor;
+    typedef typename csr_graph<Index>::edge_iterator edge_iterator;
+    typedef typename csr_graph<Index>::adjacency_iterator adjacency_iterator;
+
+    typedef typename csr_graph<Index>::out_edge_iterator out_edge_iterator;
+    typedef typename csr_graph<Index>::in_edge_iterator in_edge_iterator;
+
+    typedef typename csr_graph<Index>::vertex_iterator vertex_iterator;
+
+    typedef bidirectional_tag directed_category;
+    typedef allow_parallel_edge_tag edge_parallel_category;
+    typedef adj_list_traversal_tag traversal_category;
+
+    typedef size_t vertices_size_type;
+    typedef size_t edges_size_type;
+    typedef size_t degree_size_type;
+
+    static size_t null_vertex() { return csr_graph<Index>::null_vertex(); }
+};
+
+template <class Index>
+struct graph_traits<const csr_graph<Index> >
+    : public graph_traits<csr_graph<Index> >
+{
+};
+
+template <class Index>
+struct edge_property_type<csr_graph<Index> >
+{
+    typedef void type;
+};
+
+template <class Index>
+struct vertex_property_type<csr_graph<Index> >
+{
+    typedef void type;
+};
+
+template <class Index>
+struct graph_property_type<csr_graph<Index> >
+{
+    typedef void type;
+};
+
+//========================================================================
+// Graph access functions
+//========================================================================
+
+template <class Index>
+inline std::pair<typename csr_graph<Index>::vertex_iterator,
+                 typename csr_graph<Index>::vertex_iterator>
+vertices(const csr_graph<Index>& g)
+{
+    typedef typename csr_graph<Index>::vertex_iterator vi_t;
+    size_t N = num_vertices(g);
+    const uint64_t* mask = g._vertex_mask.empty() ? 0 : &g._vertex_mask[0];
+    return std::make_pair(vi_t(mask, 0, N), vi_t(mask, N, N));
+}
+
+template <class Index>
+inline size_t vertex(size_t i, const csr_graph<Index>& g)
+{
+    if (g.is_masked(i))
+        return csr_graph<Index>::null_vertex();
+    return i;
+}
+
+template <class Index>
+inline size_t num_vertices(const csr_graph<Index>& g)
+{
+    return g._out_offsets.empty() ? 0 : g._out_offsets.size() - 1;
+}
+
+template <class Index>
+inline size_t num_edges(const csr_graph<Index>& g)
+{
+    return g._out_targets.size();
+}
+
+template <class Index>
+inline size_t out_degree(size_t v, const csr_graph<Index>& g)
+{
+    return g._out_offsets[v + 1] - g._out_offsets[v];
+}
+
+template <class Index>
+inline size_t in_degree(size_t v, const csr_graph<Index>& g)
+{
+    return g._in_offsets[v + 1] - g._in_offsets[v];
+}
+
+template <class Index>
+inline size_t degree(size_t v, const csr_graph<Index>& g)
+{
+    return in_degree(v, g) + out_degree(v, g);
+}
+
+template <class Index>
+inline std::pair<typename csr_graph<Index>::out_edge_iterator,
+                 typename csr_graph<Index>::out_edge_iterator>
+out_edges(size_t v, const csr_graph<Index>& g)
+{
+    typedef typename csr_graph<Index>::out_edge_iterator ei_t;
+    typedef typename csr_graph<Index>::make_out_edge mk_edge;
+    typedef typename csr_graph<Index>::pos_iterator pi_t;
+    return std::make_pair(ei_t(pi_t(g._out_offsets[v]), mk_edge(&g, v)),
+                          ei_t(pi_t(g._out_offsets[v + 1]), mk_edge(&g, v)));
+}
+
+template <class Index>
+inline std::pair<typename csr_graph<Index>::in_edge_iterator,
+                 typename csr_graph<Index>::in_edge_iterator>
+in_edges(size_t v, const csr_graph<Index>& g)
+{
+    typedef typename csr_graph<Index>::in_edge_iterator ei_t;
+    typedef typename csr_graph<Index>::make_in_edge mk_edge;
+    typedef typename csr_graph<Index>::pos_iterator pi_t;
+    return std::make_pair(ei_t(pi_t(g._in_offsets[v]), mk_edge(&g, v)),
+                          ei_t(pi_t(g._in_offsets[v + 1]), mk_edge(&g, v)));
+}
+
+template <class Index>
+inline std::pair<typename csr_graph<Index>::adjacency_iterator,
+                 typename csr_graph<Index>::adjacency_iterator>
+adjacent_vertices(size_t v, const csr_graph<Index>& g)
+{
+    typedef typename csr_graph<Index>::adjacency_iterator ai_t;
+    typedef typename csr_graph<Index>::get_target get_target;
+    typedef typename csr_graph<Index>::pos_iterator pi_t;
+    return std::make_pair(ai_t(pi_t(g._out_offsets[v]), get_target(&g)),
+                          ai_t(pi_t(g._out_offsets[v + 1]), get_target(&g)));
+}
+
+template <class Index>
+inline std::pair<typename csr_graph<Index>::edge_iterator,
+                 typename csr_graph<Index>::edge_iterator>
+edges(const csr_graph<Index>& g)
+{
+    typedef typename csr_graph<Index>::edge_iterator ei_t;
+    size_t N = num_vertices(g);
+    return std::make_pair(ei_t(&g, 0, 0), ei_t(&g, N, num_edges(g)));
+}
+
+template <class Index>
+inline std::pair<typename csr_graph<Index>::edge_descriptor, bool>
+edge(size_t s, size_t t, const csr_graph<Index>& g)
+{
+    for (size_t pos = g._out_offsets[s]; pos < g._out_offsets[s + 1]; ++pos)
+        if (size_t(g._out_targets[pos]) == t)
+            return std::make_pair(std::tr1::make_tuple(s, t,
+                                                       size_t(g._out_eidx[pos])),
+                                  true);
+    size_t v = graph_traits<csr_graph<Index> >::null_vertex();
+    return std::make_pair(std::tr1::make_tuple(v, v, v), false);
+}
+
+template <class Index>
+inline size_t source(const typename csr_graph<Index>::edge_descriptor& e,
+                     const csr_graph<Index>&)
+{
+    return get<0>(e);
+}
+
+template <class Index>
+inline size_t target(const typename csr_graph<Index>::edge_descriptor& e,
+                     const csr_graph<Index>&)
+{
+    return get<1>(e);
+}
+
+//========================================================================
+// Manipulation functions (not supported)
+//========================================================================
+
+inline void csr_graph_immutable()
+{
+    throw graph_tool::GraphException("cannot modify a frozen (CSR) graph; "
+                                     "unfreeze it first");
+}
+
+template <class Index>
+inline size_t add_vertex(csr_graph<Index>&)
+{
+    csr_graph_immutable();
+    return 0;
+}
+
+template <class Index>
+inline void clear_vertex(size_t, csr_graph<Index>&)
+{
+    csr_graph_immutable();
+}
+
+template <class Index>
+inline void remove_vertex(size_t, csr_graph<Index>&)
+{
+    csr_graph_immutable();
+}
+
+template <class Index>
+inline void remove_vertex_fast(size_t, csr_graph<Index>&)
+{
+    csr_graph_immutable();
+}
+
+template <class Index>
+inline std::pair<typename csr_graph<Index>::edge_descriptor, bool>
+add_edge(size_t, size_t, csr_graph<Index>&)
+{
+    csr_graph_immutable();
+    return std::make_pair(typename csr_graph<Index>::edge_descriptor(), false);
+}
+
+template <class Index>
+inline void remove_edge(size_t, size_t, csr_graph<Index>&)
+{
+    csr_graph_immutable();
+}
+
+template <class Index>
+inline void remove_edge(const typename csr_graph<Index>::edge_descriptor&,
+                        csr_graph<Index>&)
+{
+    csr_graph_immutable();
+}
+
+//========================================================================
+// Vertex and edge index property maps
+//========================================================================
+
+// these are the same as adj_list<size_t>, so that all property maps are
+// shared with the original graph
+
+template <class Index>
+struct property_map<csr_graph<Index>, vertex_index_t>
+{
+    typedef identity_property_map type;
+    typedef type const_type;
+};
+
+template <class Index>
+struct property_map<const csr_graph<Index>, vertex_index_t>
+{
+    typedef identity_property_map type;
+    typedef type const_type;
+};
+
+template <class Index>
+inline identity_property_map
+get(vertex_index_t, csr_graph<Index>&)
+{
+    return identity_property_map();
+}
+
+template <class Index>
+inline identity_property_map
+get(vertex_index_t, const csr_graph<Index>&)
+{
+    return identity_property_map();
+}
+
+template <class Index>
+struct property_map<csr_graph<Index>, edge_index_t>
+{
+    typedef adj_edge_index_property_map<size_t> type;
+    typedef type const_type;
+};
+
+template <class Index>
+inline adj_edge_index_property_map<size_t>
+get(edge_index_t, const csr_graph<Index>&)
+{
+    return adj_edge_index_property_map<size_t>();
+}
+
+} // namespace boost
+
+#endif //GRAPH_CSR_HH
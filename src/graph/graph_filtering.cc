@@ -16,7 +16,9 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 #include "graph_filtering.hh"
+#include "graph_reorder.hh"
 #include <boost/python/type_id.hpp>
+#include <cstring>
 
 using namespace graph_tool;
 using namespace graph_tool::detail;
@@ -60,6 +62,12 @@ const char * graph_tool::ActionNotFound::what () const throw ()
     return error.c_str();
 }
 
+void GraphInterface::AddInEdgesTrigger(const type_info& action) const
+{
+    using python::detail::gcc_demangle;
+    _in_edges_triggers->push_back(gcc_demangle(action.name()));
+}
+
 // this function retrieves a graph view stored in graph_views, or stores one if
 // non-existent
 template <class Graph>
@@ -183,16 +191,168 @@ check_filtered(const Graph &g, const EdgeFilter& edge_filter,
 #endif
 }
 
+// the reversed and undirected views of csr_graph_t kept in graph_views refer
+// to a specific CSR graph (either the frozen snapshot or the filter cache), so
+// they are discarded whenever the other one is used
+template <class Graph>
+void reset_csr_views(vector<boost::any>& graph_views, const Graph* g,
+                     const Graph*& base)
+{
+    if (g == base)
+        return;
+    size_t rindex = mpl::find<all_graph_views,
+                              reverse_graph<Graph> >::type::pos::value;
+    size_t uindex = mpl::find<all_graph_views,
+                              UndirectedAdaptor<Graph> >::type::pos::value;
+    if (rindex < graph_views.size())
+        graph_views[rindex] = boost::any();
+    if (uindex < graph_views.size())
+        graph_views[uindex] = boost::any();
+    base = g;
+}
+
+// copies the first n values of a filter map into mask, and returns whether they
+// were already equal
+template <class FilterMap>
+bool update_mask(FilterMap filter, size_t n, vector<uint8_t>& mask)
+{
+    if (n > 0)
+        filter.reserve(n);
+    uint8_t* vals = n > 0 ? &filter.get_storage()[0] : 0;
+    if (mask.size() == n && (n == 0 || memcmp(&mask[0], vals, n) == 0))
+        return true;
+    mask.assign(vals, vals + n);
+    return false;
+}
+
+struct build_filter_cache
+{
+    template <class Graph, class EdgePredicate, class VertexPredicate>
+    void operator()(const Graph& g, GraphInterface::csr_graph_t& cg,
+                    EdgePredicate edge_pred, VertexPredicate vertex_pred) const
+    {
+        cg.build(g, edge_pred, vertex_pred);
+    }
+};
+
+void GraphInterface::SetFilterCache(bool cache)
+{
+#ifdef NO_GRAPH_FILTERING
+    if (cache)
+        throw GraphException("graph filtering was not enabled at compile time");
+#endif
+    _filter_cache.enabled = cache;
+    _filter_cache.valid = false;
+    if (!cache)
+    {
+        _filter_cache.g.clear();
+        vector<uint8_t>().swap(_filter_cache.vertex_mask);
+        vector<uint8_t>().swap(_filter_cache.edge_mask);
+    }
+}
+
+// rebuilds the filter cache if the graph or any of the active filters changed
+// since it was last built. Changes to the filter values are detected by
+// comparing them with a copy, which is O(V + E) but much cheaper than
+// traversing the filtered graph.
+const GraphInterface::csr_graph_t& GraphInterface::UpdateFilterCache() const
+{
+    filter_cache_t& c = _filter_cache;
+    pair<size_t, size_t> version = _index32 ? _mg32->get_version() :
+        _mg->get_version();
+
+    bool valid = c.valid && c.version == version &&
+        c.vertex_active == _vertex_filter_active &&
+        c.edge_active == _edge_filter_active;
+    if (_vertex_filter_active)
+    {
+        valid &= update_mask(_vertex_filter_map, GetTotalNumberOfVertices(),
+                             c.vertex_mask);
+        valid &= (c.vertex_invert == _vertex_filter_invert);
+    }
+    if (_edge_filter_active)
+    {
+        valid &= update_mask(_edge_filter_map, GetMaxEdgeIndex(),
+                             c.edge_mask);
+        valid &= (c.edge_invert == _edge_filter_invert);
+    }
+    if (valid)
+        return c.g;
+
+    MaskFilter<edge_filter_t> e_filter(_edge_filter_map, _edge_filter_invert);
+    MaskFilter<vertex_filter_t> v_filter(_vertex_filter_map,
+                                         _vertex_filter_invert);
+    GraphInterface& gi = const_cast<GraphInterface&>(*this);
+    if (GetMapped())
+    {
+        // the mapped snapshot is the only copy of the graph
+        if (_edge_filter_active && _vertex_filter_active)
+            build_filter_cache()(*_csr, c.g, e_filter, v_filter);
+        else if (_edge_filter_active)
+            build_filter_cache()(*_csr, c.g, e_filter, keep_all());
+        else
+            build_filter_cache()(*_csr, c.g, keep_all(), v_filter);
+    }
+    else if (_edge_filter_active && _vertex_filter_active)
+        gi.RunOnGraph(bind<void>(build_filter_cache(), _1, ref(c.g),
+                                 e_filter, v_filter));
+    else if (_edge_filter_active)
+        gi.RunOnGraph(bind<void>(build_filter_cache(), _1, ref(c.g),
+                                 e_filter, keep_all()));
+    else
+        gi.RunOnGraph(bind<void>(build_filter_cache(), _1, ref(c.g),
+                                 keep_all(), v_filter));
+
+    c.version = version;
+    c.vertex_active = _vertex_filter_active;
+    c.vertex_invert = _vertex_filter_invert;
+    c.edge_active = _edge_filter_active;
+    c.edge_invert = _edge_filter_invert;
+    c.valid = true;
+    return c.g;
+}
+
 // gets the correct graph view at run time
 boost::any GraphInterface::GetGraphView() const
 {
-    boost::any graph =
-        check_filtered(*_mg, _edge_filter_map, _edge_filter_invert,
-                       _edge_filter_active, _mg->get_last_index(),
-                       _vertex_filter_map, _vertex_filter_invert,
-                       _vertex_filter_active,
-                       const_cast<vector<boost::any>&>(_graph_views), _reversed,
-                       _directed);
+    vector<boost::any>& graph_views =
+        const_cast<vector<boost::any>&>(_graph_views);
+
+#ifndef NO_GRAPH_FILTERING
+    // the filter cache replaces the filtered adjacency list with a CSR graph
+    // containing only the remaining edges, and a bit mask of the remaining
+    // vertices. It is always used for memory-mapped graphs, since they have
+    // no adjacency list.
+    if ((_filter_cache.enabled || GetMapped()) &&
+        (_edge_filter_active || _vertex_filter_active))
+    {
+        const csr_graph_t& cg = UpdateFilterCache();
+        reset_csr_views(graph_views, &cg, _csr_view_base);
+        return check_directed(cg, _reversed, _directed, graph_views);
+    }
+#endif
+
+    // the frozen CSR snapshot is only used for unfiltered graphs; the filtered
+    // views are always based on the adjacency list
+    if (_csr->is_valid() && !_edge_filter_active && !_vertex_filter_active)
+    {
+        reset_csr_views(graph_views, _csr.get(), _csr_view_base);
+        return check_directed(*_csr, _reversed, _directed, graph_views);
+    }
+
+    boost::any graph;
+    if (_index32)
+        graph = check_filtered(*_mg32, _edge_filter_map, _edge_filter_invert,
+                               _edge_filter_active, _mg32->get_last_index(),
+                               _vertex_filter_map, _vertex_filter_invert,
+                               _vertex_filter_active, graph_views,
+                               _reversed, _directed);
+    else
+        graph = check_filtered(*_mg, _edge_filter_map, _edge_filter_invert,
+                               _edge_filter_active, _mg->get_last_index(),
+                               _vertex_filter_map, _vertex_filter_invert,
+                               _vertex_filter_active, graph_views,
+                               _reversed, _directed);
     return graph;
 }
 
@@ -208,7 +368,10 @@ bool GraphInterface::IsEdgeFilterActive() const
 // found
 void GraphInterface::ReIndexEdges()
 {
-    _mg->reindex_edges();
+    if (_index32)
+        _mg32->reindex_edges();
+    else
+        _mg->reindex_edges();
 }
 
 // this will definitively remove all the edges from the graph, which are being
@@ -219,19 +382,10 @@ void GraphInterface::PurgeEdges()
         return;
 
     MaskFilter<edge_filter_t> filter(_edge_filter_map, _edge_filter_invert);
-    graph_traits<multigraph_t>::vertex_iterator v, v_end;
-    graph_traits<multigraph_t>::out_edge_iterator e, e_end;
-    vector<graph_traits<multigraph_t>::edge_descriptor> deleted_edges;
-    for (tie(v, v_end) = vertices(*_mg); v != v_end; ++v)
-    {
-        for (tie(e, e_end) = out_edges(*v, *_mg); e != e_end; ++e)
-            if (!filter(*e))
-                deleted_edges.push_back(*e);
-        for (typeof(deleted_edges.begin()) iter = deleted_edges.begin();
-             iter != deleted_edges.end(); ++iter)
-            remove_edge(*iter, *_mg);
-        deleted_edges.clear();
-    }
+    if (_index32)
+        _mg32->purge_edges(filter);
+    else
+        _mg->purge_edges(filter);
 }
 
 
@@ -249,34 +403,65 @@ void GraphInterface::PurgeVertices(boost::any aold_index)
 
     MaskFilter<vertex_filter_t> filter(_vertex_filter_map,
                                        _vertex_filter_invert);
-    size_t N = num_vertices(*_mg);
+    size_t N = GetTotalNumberOfVertices();
     vector<bool> deleted(N, false);
     for (size_t i = 0; i < N; ++i)
-        deleted[i] = !filter(vertex(i, *_mg));
-    vector<int> old_indexes;
+        deleted[i] = !filter(vertex_t(i));
 
-    vector<graph_traits<multigraph_t>::edge_descriptor> edges;
+    if (_index32)
+        _mg32->purge_vertices(deleted);
+    else
+        _mg->purge_vertices(deleted);
 
-    //remove vertices
-    for (int i = N-1; i >= 0; --i)
+    size_t pos = 0;
+    for (size_t i = 0; i < N; ++i)
     {
-        if (deleted[i])
-        {
-            graph_traits<multigraph_t>::vertex_descriptor v =
-                vertex(i, *_mg);
-            remove_vertex(v, *_mg);
-        }
-        else
-        {
-            old_indexes.push_back(i);
-        }
+        if (!deleted[i])
+            old_index[vertex_t(pos++)] = i;
     }
+}
+
+// renumbers the vertices, either according to a user-supplied order
+// (vorder[v] = new index of v), or to an ordering computed with
+// get_locality_order(); old_index[v] is set to the previous index of v
+void GraphInterface::ReorderVertices(string method, boost::any avorder,
+                                     boost::any aold_index)
+{
+    typedef property_map_type::apply<int64_t,
+                                     GraphInterface::vertex_index_map_t>::type
+        index_prop_t;
+    index_prop_t old_index = any_cast<index_prop_t>(aold_index);
 
-    N = old_indexes.size();
-    for (int i = N-1; i >= 0; --i)
+    size_t N = GetTotalNumberOfVertices();
+    vector<size_t> order;
+    if (avorder.empty())
     {
-        old_index[vertex((N - 1) - i, *_mg)] = old_indexes[i];
+        RunOnGraph(bind<void>(get_locality_order(), _1, cref(method),
+                              ref(order)));
     }
+    else
+    {
+        index_prop_t vorder = any_cast<index_prop_t>(avorder);
+        vector<bool> seen(N, false);
+        order.resize(N);
+        for (size_t i = 0; i < N; ++i)
+        {
+            int64_t j = vorder[vertex_t(i)];
+            if (j < 0 || size_t(j) >= N || seen[j])
+                throw ValueException("the vertex order must be a permutation "
+                                     "of the vertex indexes");
+            seen[j] = true;
+            order[i] = j;
+        }
+    }
+
+    if (_index32)
+        _mg32->permute_vertices(order);
+    else
+        _mg->permute_vertices(order);
+
+    for (size_t i = 0; i < N; ++i)
+        old_index[vertex_t(order[i])] = i;
 }
 
 void GraphInterface::SetVertexFilterProperty(boost::any property, bool invert)
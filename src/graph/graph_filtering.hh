@@ -48,6 +48,7 @@
 #include <boost/mpl/quote.hpp>
 #include <boost/mpl/range_c.hpp>
 #include <boost/mpl/print.hpp>
+#include <boost/mpl/push_back.hpp>
 
 #include "graph_adaptor.hh"
 #include "graph_selectors.hh"
@@ -65,18 +66,24 @@ using namespace boost;
 // We want to generate versions of a template algorithm for every possible type
 // of graph views. The types of graph views are the following:
 //
-//    - The original directed multigraph
+//    - The original directed multigraph, in one of two variants: with 64-bit
+//      (multigraph_t) or 32-bit (multigraph32_t) adjacency lists
 //
 //    - Filtered graphs, based on MaskFilter below. This amounts to a
 //      filtered_graph for every combination of filtered and unfiltered vertex
-//      or edge, i.e., 3.
+//      or edge, i.e., 3, for each variant.
 //
-//    - A reversed view of each directed graph (original + filtered)
+//    - The immutable CSR snapshot of the original graph (see graph_csr.hh),
+//      which is used instead of the original graph while it is frozen, and
+//      no filtering is active, or the materialized copy of the filtered graph
+//      (see GraphInterface::SetFilterCache())
+//
+//    - A reversed view of each directed graph (original + filtered + CSR)
 //
 //    - An undirected view of each directed (unreversed) graph (original +
-//      filtered)
+//      filtered + CSR)
 //
-// The total number of graph views is then: 3 * 4 = 12
+// The total number of graph views is then: 3 * (2 * 4 + 1) = 27
 //
 // The specific specialization can be called at run time (and generated at
 // compile time) with the run_action() function, which takes as arguments the
@@ -323,7 +330,8 @@ struct get_property_map_type<keep_all, IndexMap>
 };
 
 // this metafunction returns a filtered graph type, given the scalar types to be
-// used in the property maps
+// used in the property maps, and the underlying (adjacency list) graph type
+template <class Graph>
 struct get_graph_filtered
 {
     template <class TypePair>
@@ -352,7 +360,7 @@ struct get_graph_filtered
                 GraphInterface::vertex_index_map_t>::type
             >::type vertex_property_map;
 
-        typedef typename graph_filter::apply<GraphInterface::multigraph_t,
+        typedef typename graph_filter::apply<Graph,
                                              edge_property_map,
                                              vertex_property_map>::type type;
     };
@@ -369,13 +377,24 @@ struct get_all_graph_views
               class NeverFiltered = mpl::bool_<false> >
     struct apply
     {
-        // filtered graphs
+        // filtered graphs, for both index types (plus the unfiltered CSR
+        // snapshot)
         struct filtered_graphs:
             mpl::if_
             <NeverFiltered,
-             mpl::vector<GraphInterface::multigraph_t>,
-             typename mpl::transform<TypePairs,
-                                     get_graph_filtered>::type>::type {};
+             mpl::vector<GraphInterface::multigraph_t,
+                         GraphInterface::multigraph32_t,
+                         GraphInterface::csr_graph_t>,
+             typename mpl::push_back<
+                 typename mpl::transform<
+                     TypePairs,
+                     get_graph_filtered<GraphInterface::multigraph32_t>,
+                     mpl::back_inserter<
+                         typename mpl::transform<
+                             TypePairs,
+                             get_graph_filtered<GraphInterface::multigraph_t>
+                             >::type> >::type,
+                 GraphInterface::csr_graph_t>::type>::type {};
 
         // filtered + reversed graphs
         struct reversed_graphs:
@@ -497,9 +516,9 @@ struct never_filtered:
 // sanity check
 typedef mpl::size<all_graph_views>::type n_views;
 #ifndef NO_GRAPH_FILTERING
-BOOST_MPL_ASSERT_RELATION(n_views::value, == , mpl::int_<12>::value);
+BOOST_MPL_ASSERT_RELATION(n_views::value, == , mpl::int_<27>::value);
 #else
-BOOST_MPL_ASSERT_RELATION(n_views::value, == , mpl::int_<3>::value);
+BOOST_MPL_ASSERT_RELATION(n_views::value, == , mpl::int_<9>::value);
 #endif
 
 // run_action() implementation
@@ -545,6 +564,22 @@ struct action_wrap
         return a.get_unchecked(_max_e);
     }
 
+    template <class Type>
+    mapped_vector_property_map<Type,GraphInterface::vertex_index_map_t>
+    uncheck(mapped_vector_property_map
+            <Type,GraphInterface::vertex_index_map_t> a, mpl::false_) const
+    {
+        return a.get_unchecked(_max_v);
+    }
+
+    template <class Type>
+    mapped_vector_property_map<Type,GraphInterface::edge_index_map_t>
+    uncheck(mapped_vector_property_map
+            <Type,GraphInterface::edge_index_map_t> a, mpl::false_) const
+    {
+        return a.get_unchecked(_max_e);
+    }
+
     template <class Type>
     scalarS<typename Type::unchecked_t>
     uncheck(scalarS<Type> a, mpl::false_) const
@@ -581,6 +616,24 @@ struct action_wrap
     size_t _max_v, _max_e;
 };
 
+// records the action in the graph if the in-edge lists were built while it
+// was running (see GraphInterface::SetKeepInEdges())
+template <class Action>
+struct in_edges_watch
+{
+    in_edges_watch(const GraphInterface& g)
+        : _g(g), _kept(g.GetKeepInEdges()) {}
+
+    ~in_edges_watch()
+    {
+        if (!_kept && _g.GetKeepInEdges())
+            _g.AddInEdgesTrigger(typeid(Action));
+    }
+
+    const GraphInterface& _g;
+    bool _kept;
+};
+
 // this functor encapsulates another functor Action, which takes a pointer to a
 // graph view as first argument
 template <class Action, class GraphViews, class Wrap, class TR1, class TR2,
@@ -591,11 +644,12 @@ struct graph_action
         mpl::transform<GraphViews, mpl::quote1<add_pointer> >::type {};
 
     graph_action(GraphInterface& g, Action a)
-        : _g(g), _a(a, g, num_vertices(*g._mg),
-                    max(g._mg->get_last_index(), size_t(1))) {}
+        : _g(g), _a(a, g, g.GetTotalNumberOfVertices(),
+                    max(g.GetMaxEdgeIndex(), size_t(1))) {}
 
     void operator()() const
     {
+        in_edges_watch<Action> watch(_g);
         bool found = false;
         boost::any gview = _g.GetGraphView();
         boost::mpl::for_each<graph_view_pointers>
@@ -609,6 +663,7 @@ struct graph_action
 
     void operator()(boost::any a1) const
     {
+        in_edges_watch<Action> watch(_g);
         bool found = false;
         boost::any gview = _g.GetGraphView();
         boost::mpl::nested_for_each<graph_view_pointers,TR1>()
@@ -623,6 +678,7 @@ struct graph_action
 
     void operator()(boost::any a1, boost::any a2) const
     {
+        in_edges_watch<Action> watch(_g);
         bool found = false;
         boost::any gview = _g.GetGraphView();
         boost::mpl::nested_for_each<graph_view_pointers,TR1,TR2>()
@@ -638,6 +694,7 @@ struct graph_action
 
     void operator()(boost::any a1, boost::any a2, boost::any a3) const
     {
+        in_edges_watch<Action> watch(_g);
         bool found = false;
         boost::any gview = _g.GetGraphView();
         boost::mpl::nested_for_each<graph_view_pointers,TR1,TR2,TR3>()
@@ -655,6 +712,7 @@ struct graph_action
     void operator()(boost::any a1, boost::any a2, boost::any a3,
                     boost::any a4) const
     {
+        in_edges_watch<Action> watch(_g);
         bool found = false;
         boost::any gview = _g.GetGraphView();
         boost::mpl::nested_for_each<graph_view_pointers,TR1,TR2,TR3,TR4>()
@@ -18,6 +18,7 @@
 #include <boost/python/extract.hpp>
 
 #include <iostream>
+#include <cstring>
 #include <boost/algorithm/string.hpp>
 #include <boost/iostreams/categories.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
@@ -25,12 +26,17 @@
 #include <boost/iostreams/filter/bzip2.hpp>
 #include <boost/iostreams/device/file_descriptor.hpp>
 #include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/graph/graphml.hpp>
 #include <boost/graph/graphviz.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/xpressive/xpressive.hpp>
+#include <boost/mpl/contains.hpp>
+#include <boost/mpl/find.hpp>
 
 #include "gml.hh"
+#include "edge_list.hh"
 #include "graph.hh"
 #include "graph_filtering.hh"
 #include "graph_properties.hh"
@@ -95,7 +101,14 @@ public:
     {
         python::object pbuf = _file.attr("read")(n);
 #if (PY_MAJOR_VERSION >= 3)
-        string buf = python::extract<string>(pbuf.attr("decode")("utf-8"));
+        // the data is copied verbatim, so that binary files can also be read
+        if (PyBytes_Check(pbuf.ptr()))
+        {
+            std::streamsize size = PyBytes_Size(pbuf.ptr());
+            memcpy(s, PyBytes_AsString(pbuf.ptr()), size);
+            return size;
+        }
+        string buf = python::extract<string>(pbuf);
 #else
         string buf = python::extract<string>(pbuf);
 #endif
@@ -106,9 +119,14 @@ public:
 
     std::streamsize write(const char* s, std::streamsize n)
     {
+#if (PY_MAJOR_VERSION >= 3)
+        python::object pbuf(python::handle<>(PyBytes_FromStringAndSize(s, n)));
+        _file.attr("write")(pbuf);
+#else
         string buf(s, s+n);
         python::object pbuf(buf);
-        _file.attr("write")(pbuf.attr("encode")("utf-8"));
+        _file.attr("write")(pbuf);
+#endif
         return n;
     }
 
@@ -123,6 +141,108 @@ private:
     python::object _file;
 };
 
+// the following output filter compresses the data in independent blocks, in
+// parallel, each of which is written as a separate gzip (or bzip2) member.
+// Concatenated members are decompressed as a single stream, so the output can
+// be read as usual.
+
+class parallel_compressor
+{
+public:
+    typedef char char_type;
+    struct category: iostreams::output_filter_tag, iostreams::multichar_tag,
+                     iostreams::closable_tag {};
+
+    parallel_compressor(bool bzip2, int threads)
+        : _bzip2(bzip2), _threads(threads), _blocks(threads),
+          _compressed(threads), _current(0), _empty(true) {}
+
+    template <class Sink>
+    std::streamsize write(Sink& snk, const char* s, std::streamsize n)
+    {
+        std::streamsize pos = 0;
+        while (pos < n)
+        {
+            vector<char>& block = _blocks[_current];
+            size_t m = std::min(size_t(n - pos), block_size - block.size());
+            block.insert(block.end(), s + pos, s + pos + m);
+            pos += m;
+            if (block.size() == block_size)
+            {
+                _current++;
+                if (_current == _blocks.size())
+                    flush_blocks(snk);
+            }
+        }
+        return n;
+    }
+
+    template <class Sink>
+    void close(Sink& snk)
+    {
+        // an empty stream still needs one (empty) member
+        if (!_blocks[_current].empty() || (_empty && _current == 0))
+            _current++;
+        flush_blocks(snk);
+    }
+
+private:
+    // compresses the first _current blocks, and writes them in order
+    template <class Sink>
+    void flush_blocks(Sink& snk)
+    {
+        bool failed = false;
+        int i, N = _current;
+        #pragma omp parallel for default(shared) private(i) \
+            schedule(dynamic) num_threads(_threads) if (N > 1)
+        for (i = 0; i < N; ++i)
+        {
+            try
+            {
+                compress(_blocks[i], _compressed[i]);
+            }
+            catch (std::exception&)
+            {
+                #pragma omp critical
+                failed = true;
+            }
+        }
+        if (failed)
+            throw ios_base::failure("error compressing data");
+
+        for (size_t j = 0; j < _current; ++j)
+        {
+            iostreams::write(snk, &_compressed[j][0], _compressed[j].size());
+            _compressed[j].clear();
+            _blocks[j].clear();
+        }
+        _current = 0;
+        _empty = false;
+    }
+
+    void compress(const vector<char>& block, vector<char>& out) const
+    {
+        iostreams::filtering_stream<iostreams::output> stream;
+        if (_bzip2)
+            stream.push(iostreams::bzip2_compressor());
+        else
+            stream.push(iostreams::gzip_compressor());
+        stream.push(iostreams::back_inserter(out));
+        if (!block.empty())
+            stream.write(&block[0], block.size());
+        stream.reset();
+    }
+
+    static const size_t block_size = 1 << 22;
+
+    bool _bzip2;
+    int _threads;
+    vector<vector<char> > _blocks;
+    vector<vector<char> > _compressed;
+    size_t _current;
+    bool _empty;
+};
+
 // Property Maps
 // =============
 
@@ -315,11 +435,26 @@ python::tuple GraphInterface::ReadFromFile(string file, python::object pfile,
                                            string format,
                                            python::list ignore_vp,
                                            python::list ignore_ep,
-                                           python::list ignore_gp)
+                                           python::list ignore_gp,
+                                           bool lazy)
 {
-    if (format != "dot" && format != "xml" && format != "gml")
+    if (format != "dot" && format != "xml" && format != "gml" &&
+        format != "gt" && format != "gti")
         throw ValueException("error reading from file '" + file +
                              "': requested invalid format '" + format + "'");
+    if (format == "gti" && (pfile != python::object() || file == "-" ||
+                            boost::ends_with(file, ".gz") ||
+                            boost::ends_with(file, ".bz2")))
+        throw ValueException("error reading from file '" + file +
+                             "': the 'gti' format can only be memory-mapped"
+                             " from an uncompressed file");
+    if (lazy && ((format != "gt" && format != "gti") ||
+                 pfile != python::object() || file == "-" ||
+                 boost::ends_with(file, ".gz") ||
+                 boost::ends_with(file, ".bz2")))
+        throw ValueException("error reading from file '" + file +
+                             "': only uncompressed files in the 'gt' or 'gti'"
+                             " formats can be read lazily");
     try
     {
         boost::iostreams::filtering_stream<boost::iostreams::input>
@@ -335,6 +470,21 @@ python::tuple GraphInterface::ReadFromFile(string file, python::object pfile,
         for (int i = 0; i < len(ignore_gp); ++i)
             igp.insert(python::extract<string>(ignore_gp[i]));
 
+        if (format == "gt")
+        {
+            if (lazy)
+            {
+                // the property maps are located by seeking in the file
+                std::ifstream fstream(file.c_str(), std::ios_base::in |
+                                      std::ios_base::binary);
+                fstream.exceptions(ios_base::badbit);
+                return ReadBinary(fstream, ivp, iep, igp, true);
+            }
+            return ReadBinary(stream, ivp, iep, igp, false);
+        }
+        if (format == "gti")
+            return ReadImage(file, ivp, iep, igp, lazy);
+
         create_dynamic_map<vertex_index_map_t,edge_index_map_t>
             map_creator(_vertex_index, _edge_index);
         dynamic_properties dp(map_creator);
@@ -349,6 +499,12 @@ python::tuple GraphInterface::ReadFromFile(string file, python::object pfile,
         else if (format == "gml")
             _directed = read_gml(stream, *_mg, dp, ivp, iep, igp);
 
+        if (_index32)
+        {
+            _mg32->assign(*_mg);
+            *_mg = multigraph_t();
+        }
+
         python::dict vprops, eprops, gprops;
         for(typeof(dp.begin()) iter = dp.begin(); iter != dp.end(); ++iter)
         {
@@ -378,6 +534,189 @@ python::tuple GraphInterface::ReadFromFile(string file, python::object pfile,
     }
 };
 
+//==============================================================================
+// ReadEdgeList(file, pfile, delimiter, skip_first, id_type, value_types)
+//==============================================================================
+
+// value types which can be read from the columns of an edge list
+typedef mpl::push_back<scalar_types, string>::type edge_list_value_types;
+
+// creates the edge property map for a column of an edge list, if it has the
+// given value type name
+struct new_edge_column
+{
+    template <class ValueType>
+    void operator()(ValueType, const string& type_name, GraphInterface& gi,
+                    boost::any& prop, python::object& pprop) const
+    {
+        typedef typename property_map_type::apply
+            <ValueType, GraphInterface::edge_index_map_t>::type map_t;
+        size_t pos = mpl::find<value_types, ValueType>::type::pos::value;
+        if (!prop.empty() || type_name != type_names[pos])
+            return;
+        map_t map(gi.GetEdgeIndex());
+        prop = map;
+        pprop = python::object(PythonPropertyMap<map_t>(map));
+    }
+};
+
+// converts the values of a column of a block of edges, in parallel
+template <class Id>
+struct fill_edge_column
+{
+    fill_edge_column(const vector<size_t>& eidx,
+                     vector<edge_list_slice<Id> >& slices, size_t c,
+                     boost::any& prop)
+        : _eidx(eidx), _slices(slices), _c(c), _prop(prop) {}
+
+    template <class ValueType>
+    void operator()(ValueType) const
+    {
+        typedef typename property_map_type::apply
+            <ValueType, GraphInterface::edge_index_map_t>::type map_t;
+        map_t* pmap = any_cast<map_t>(&_prop);
+        if (pmap == 0 || _eidx.empty())
+            return;
+        pmap->reserve(*max_element(_eidx.begin(), _eidx.end()) + 1);
+        vector<ValueType>& vals = pmap->get_storage();
+
+        string error;
+        int i, N = _slices.size();
+        #pragma omp parallel for default(shared) private(i) \
+            schedule(dynamic) if (N > 1)
+        for (i = 0; i < N; ++i)
+        {
+            edge_list_slice<Id>& slice = _slices[i];
+            vector<string>& fields = slice.values[_c];
+            for (size_t j = 0; j < fields.size(); ++j)
+            {
+                if (!parse_value(fields[j], vals[_eidx[slice.offset + j]]))
+                {
+                    #pragma omp critical
+                    error = "invalid value for column " +
+                        lexical_cast<string>(_c + 2) + ": '" + fields[j] +
+                        "'";
+                    break;
+                }
+            }
+        }
+        if (!error.empty())
+            throw edge_list_parse_error(error);
+    }
+
+    const vector<size_t>& _eidx;
+    vector<edge_list_slice<Id> >& _slices;
+    size_t _c;
+    boost::any& _prop;
+};
+
+template <class Id>
+struct fill_edge_columns
+{
+    fill_edge_columns(vector<boost::any>& props): _props(props) {}
+
+    void operator()(const vector<size_t>& eidx,
+                    vector<edge_list_slice<Id> >& slices) const
+    {
+        for (size_t c = 0; c < _props.size(); ++c)
+            mpl::for_each<edge_list_value_types>
+                (fill_edge_column<Id>(eidx, slices, c, _props[c]));
+    }
+
+    vector<boost::any>& _props;
+};
+
+struct do_read_edge_list
+{
+    template <class Graph, class IdMap>
+    void operator()(Graph& g, istream& in, IdMap id_map,
+                    GraphInterface::edge_index_map_t eindex, char delim,
+                    bool skip_first, vector<string>& header,
+                    vector<boost::any>& props) const
+    {
+        typedef typename property_traits<IdMap>::value_type id_t;
+        read_edge_list<id_t>(in, g, id_map, eindex, delim, skip_first,
+                             props.size(), header,
+                             fill_edge_columns<id_t>(props));
+    }
+};
+
+template <class Id>
+python::object read_edge_list_ids(GraphInterface& gi, istream& in,
+                                  char delim, bool skip_first,
+                                  vector<string>& header,
+                                  vector<boost::any>& props)
+{
+    typedef typename property_map_type::apply
+        <Id, GraphInterface::vertex_index_map_t>::type map_t;
+    map_t id_map(gi.GetVertexIndex());
+    gi.RunOnGraph(bind<void>(do_read_edge_list(), _1, ref(in), id_map,
+                             gi.GetEdgeIndex(), delim, skip_first,
+                             ref(header), ref(props)));
+    return python::object(PythonPropertyMap<map_t>(id_map));
+}
+
+// reads an edge list (see edge_list.hh) into the graph, and returns the
+// vertex property map with the vertex identifiers, the list of edge property
+// maps with the values of the remaining columns, and the fields of the header
+python::tuple GraphInterface::ReadEdgeList(string file, python::object pfile,
+                                           string delimiter, bool skip_first,
+                                           string id_type,
+                                           python::list column_types)
+{
+    if (delimiter.size() > 1)
+        throw ValueException("the delimiter must be a single character");
+    char delim = delimiter.empty() ? 0 : delimiter[0];
+
+    vector<boost::any> props(python::len(column_types));
+    python::list eprops;
+    for (size_t c = 0; c < props.size(); ++c)
+    {
+        string type_name = python::extract<string>(column_types[c]);
+        python::object pprop;
+        mpl::for_each<edge_list_value_types>
+            (bind<void>(new_edge_column(), _1, cref(type_name),
+                        ref(*this), ref(props[c]), ref(pprop)));
+        if (props[c].empty())
+            throw ValueException("invalid value type for edge list column: " +
+                                 type_name);
+        eprops.append(pprop);
+    }
+
+    try
+    {
+        boost::iostreams::filtering_stream<boost::iostreams::input>
+            stream;
+        std::ifstream file_stream;
+        build_stream(stream, file, pfile, file_stream);
+
+        vector<string> header;
+        python::object id_map;
+        if (id_type == "string")
+            id_map = read_edge_list_ids<string>(*this, stream, delim,
+                                                skip_first, header, props);
+        else if (id_type == "int64_t")
+            id_map = read_edge_list_ids<int64_t>(*this, stream, delim,
+                                                 skip_first, header, props);
+        else
+            throw ValueException("invalid vertex identifier type: " +
+                                 id_type);
+
+        python::list pheader;
+        for (size_t i = 0; i < header.size(); ++i)
+            pheader.append(header[i]);
+        return python::make_tuple(id_map, eprops, pheader);
+    }
+    catch (ios_base::failure &e)
+    {
+        throw IOException("error reading from file '" + file + "':" + e.what());
+    }
+    catch (edge_list_parse_error &e)
+    {
+        throw IOException("error reading from file '" + file + "':" + e.what());
+    }
+}
+
 template <class IndexMap>
 string graphviz_insert_index(dynamic_properties& dp, IndexMap index_map,
                              bool insert = true)
@@ -397,13 +736,566 @@ string graphviz_insert_index(dynamic_properties& dp, IndexMap index_map,
         return "vertex_id";
 }
 
-// writes a graph to a file
+//
+// Direct GraphML and GML output
+// =============================
+//
+// The following produce exactly the same output as write_graphml() and
+// write_gml() with dynamic_properties, but the values are read from the
+// property maps with their actual types, and formatted directly into a large
+// buffer, instead of being converted one by one through boost::any and
+// lexical_cast<> into temporary strings. They are used whenever all property
+// maps are regular (i.e. vector-based) maps.
+
+// the types handled by write_graphml() and write_gml(), and the GraphML type
+// names (see boost/graph/graphml.hpp and gml.hh)
+typedef mpl::vector23<bool, uint8_t, int8_t, uint16_t, int16_t, uint32_t,
+                      int32_t, uint64_t, int64_t, float, double, long double,
+                      vector<uint8_t>, vector<int32_t>, vector<int64_t>,
+                      vector<double>, vector<long double>, vector<string>,
+                      string, python::object, vector<int8_t>,
+                      vector<uint32_t>, vector<float> >
+    graphml_value_types;
+
+const char* graphml_type_names[] = {"boolean", "boolean", "byte", "short",
+                                    "short", "unsigned_int", "int", "long",
+                                    "long", "float32", "float", "double",
+                                    "vector_boolean", "vector_int",
+                                    "vector_long", "vector_float",
+                                    "vector_double", "vector_string", "string",
+                                    "python_object", "vector_byte",
+                                    "vector_unsigned_int", "vector_float32"};
+
+typedef mpl::vector21<bool, uint8_t, int8_t, uint32_t, int32_t, uint64_t,
+                      int64_t, float, double, long double, vector<uint8_t>,
+                      vector<int32_t>, vector<int64_t>, vector<double>,
+                      vector<long double>, vector<string>, string,
+                      python::object, vector<int8_t>, vector<uint32_t>,
+                      vector<float> >
+    gml_value_types;
+
+template <class T>
+void append_int(string& s, T val)
+{
+    char buf[24];
+    char* pos = buf + sizeof(buf);
+    bool neg = val < 0;
+    uint64_t u = neg ? uint64_t(0) - uint64_t(val) : uint64_t(val);
+    do
+    {
+        *--pos = '0' + (u % 10);
+        u /= 10;
+    }
+    while (u != 0);
+    if (neg)
+        *--pos = '-';
+    s.append(pos, buf + sizeof(buf));
+}
+
+// hexadecimal representation, identical to the one of printf("%a")
+void append_hex_float(string& s, double val)
+{
+    uint64_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    if (bits >> 63)
+        s += '-';
+    int exp = int((bits >> 52) & 0x7ff);
+    uint64_t frac = bits & ((uint64_t(1) << 52) - 1);
+    if (exp == 0x7ff)
+    {
+        s += (frac == 0) ? "inf" : "nan";
+        return;
+    }
+    s += (exp == 0) ? "0x0" : "0x1";
+    if (frac != 0)
+    {
+        // 13 digits, without the trailing zeros
+        int n = 13;
+        for (; (frac & 0xf) == 0; frac >>= 4)
+            --n;
+        s += '.';
+        for (int i = n - 1; i >= 0; --i)
+            s += "0123456789abcdef"[(frac >> (4 * i)) & 0xf];
+    }
+    else if (exp == 0)
+    {
+        s += "p+0";
+        return;
+    }
+    exp = (exp == 0) ? -1022 : exp - 1023;
+    s += (exp < 0) ? "p-" : "p+";
+    append_int(s, exp < 0 ? -exp : exp);
+}
+
+// appends the same representation as lexical_cast<string>()
+
+template <class T>
+void append_value(string& s, const T& val)
+{
+    append_int(s, val);
+}
+
+void append_value(string& s, const float& val)
+{
+    append_hex_float(s, val);
+}
+
+void append_value(string& s, const double& val)
+{
+    append_hex_float(s, val);
+}
+
+void append_value(string& s, const long double& val)
+{
+    s += lexical_cast<string>(val);
+}
+
+void append_value(string& s, const string& val)
+{
+    s += val;
+}
+
+void append_value(string& s, const python::object& val)
+{
+    s += lexical_cast<string>(val);
+}
+
+void append_value(string& s, const vector<string>& val)
+{
+    for (size_t i = 0; i < val.size(); ++i)
+    {
+        // escape separators
+        for (size_t j = 0; j < val[i].size(); ++j)
+        {
+            if (val[i][j] == '\\')
+                s += "\\\\";
+            else if (val[i][j] == ',' && j + 1 < val[i].size() &&
+                     val[i][j + 1] == ' ')
+                s += ",\\";
+            else
+                s += val[i][j];
+        }
+        if (i < val.size() - 1)
+            s += ", ";
+    }
+}
+
+template <class T>
+void append_value(string& s, const vector<T>& val)
+{
+    for (size_t i = 0; i < val.size(); ++i)
+    {
+        append_value(s, val[i]);
+        if (i < val.size() - 1)
+            s += ", ";
+    }
+}
+
+// appends the representation used by write_gml(), which writes the scalars
+// with operator<<, except for int8_t
+
+template <class T>
+void append_gml_value(string& s, const T& val, stringstream&)
+{
+    append_value(s, val);
+}
+
+void append_gml_value(string& s, const uint8_t& val, stringstream&)
+{
+    s += char(val);
+}
+
+template <class T>
+void append_gml_float(string& s, const T& val, stringstream& fs)
+{
+    fs.str("");
+    fs << val;
+    s += fs.str();
+}
+
+void append_gml_value(string& s, const float& val, stringstream& fs)
+{
+    append_gml_float(s, val, fs);
+}
+
+void append_gml_value(string& s, const double& val, stringstream& fs)
+{
+    append_gml_float(s, val, fs);
+}
+
+void append_gml_value(string& s, const long double& val, stringstream& fs)
+{
+    append_gml_float(s, val, fs);
+}
+
+// the values of a property map, for the vertices, edges or the graph
+template <class Key>
+class text_value
+{
+public:
+    virtual ~text_value() {}
+    virtual void format(string& s, const Key& k, bool gml) const = 0;
+};
+
+template <class Key, class PropertyMap>
+class typed_text_value: public text_value<Key>
+{
+public:
+    typed_text_value(PropertyMap pmap): _pmap(pmap) {}
+
+    virtual void format(string& s, const Key& k, bool gml) const
+    {
+        if (gml)
+            append_gml_value(s, _pmap[k], _fs);
+        else
+            append_value(s, _pmap[k]);
+    }
+
+private:
+    PropertyMap _pmap;
+    mutable stringstream _fs;
+};
+
+struct text_property
+{
+    string name;
+    const char* graphml_type; // null if the values are not written
+    bool gml;                 // whether the values are written in GML
+    bool scalar;
+    boost::shared_ptr<text_value<GraphInterface::vertex_t> > vertex;
+    boost::shared_ptr<text_value<GraphInterface::edge_t> > edge;
+    boost::shared_ptr<text_value<graph_property_tag> > graph;
+
+    bool operator<(const text_property& p) const { return name < p.name; }
+};
+
+typedef vector<text_property> text_properties;
+
+struct get_text_property
+{
+    template <class ValueType>
+    void operator()(ValueType, boost::any& map, text_property& p) const
+    {
+        typedef typename property_map_type::apply
+            <ValueType, GraphInterface::vertex_index_map_t>::type vmap_t;
+        typedef typename property_map_type::apply
+            <ValueType, GraphInterface::edge_index_map_t>::type emap_t;
+        typedef typename property_map_type::apply
+            <ValueType, GraphInterface::graph_index_map_t>::type gmap_t;
+
+        if (vmap_t* pmap = any_cast<vmap_t>(&map))
+            p.vertex.reset(new typed_text_value<GraphInterface::vertex_t,
+                                                vmap_t>(*pmap));
+        else if (emap_t* pmap = any_cast<emap_t>(&map))
+            p.edge.reset(new typed_text_value<GraphInterface::edge_t,
+                                              emap_t>(*pmap));
+        else if (gmap_t* pmap = any_cast<gmap_t>(&map))
+            p.graph.reset(new typed_text_value<graph_property_tag,
+                                               gmap_t>(*pmap));
+        else
+            return;
+
+        typedef typename mpl::find<graphml_value_types, ValueType>::type iter;
+        if (is_same<iter, typename mpl::end<graphml_value_types>::type>::value)
+            p.graphml_type = 0;
+        else
+            p.graphml_type = graphml_type_names[iter::pos::value];
+        p.gml = mpl::contains<gml_value_types, ValueType>::value;
+        p.scalar = is_scalar<ValueType>::value;
+    }
+};
+
+// returns false if some of the property maps cannot be written directly, in
+// which case dynamic_properties must be used
+bool get_text_properties(python::list props, text_properties& tprops)
+{
+    for (int i = 0; i < python::len(props); ++i)
+    {
+        text_property p;
+        p.name = python::extract<string>(props[i][0]);
+        if (p.name == "_graphml_vertex_id" || p.name == "_graphml_edge_id")
+            return false;
+        boost::any map =
+            python::extract<boost::any>(props[i][1].attr("get_map")());
+        mpl::for_each<value_types>(boost::bind<void>(get_text_property(), _1,
+                                                     boost::ref(map),
+                                                     boost::ref(p)));
+        if (!p.vertex && !p.edge && !p.graph)
+            return false;
+        tprops.push_back(p);
+    }
+    // same order as dynamic_properties, which is sorted by name
+    stable_sort(tprops.begin(), tprops.end());
+    return true;
+}
+
+// output buffer, which is written to the stream in large blocks
+class text_buffer
+{
+public:
+    text_buffer(ostream& s): _s(s) { _buf.reserve(2 * block_size); }
+
+    text_buffer& operator<<(const char* s) { _buf += s; return check(); }
+    text_buffer& operator<<(const string& s) { _buf += s; return check(); }
+    text_buffer& operator<<(size_t i) { append_int(_buf, i); return check(); }
+
+    void put_xml(const string& s)
+    {
+        // same as protect_xml_string()
+        for (size_t i = 0; i < s.size(); ++i)
+        {
+            switch (s[i])
+            {
+            case '<': _buf += "&lt;"; break;
+            case '>': _buf += "&gt;"; break;
+            case '&': _buf += "&amp;"; break;
+            case '"': _buf += "&quot;"; break;
+            case '\'': _buf += "&apos;"; break;
+            default: _buf += s[i];
+            }
+        }
+        check();
+    }
+
+    void put_quoted(const string& s)
+    {
+        _buf += '"';
+        for (size_t i = 0; i < s.size(); ++i)
+        {
+            if (s[i] == '"')
+                _buf += '\\';
+            _buf += s[i];
+        }
+        _buf += '"';
+        check();
+    }
+
+    void flush()
+    {
+        _s.write(_buf.data(), _buf.size());
+        _buf.clear();
+    }
+
+private:
+    text_buffer& check()
+    {
+        if (_buf.size() >= block_size)
+            flush();
+        return *this;
+    }
+
+    static const size_t block_size = 1 << 20;
+    ostream& _s;
+    string _buf;
+};
+
+// indexes of the property maps with the given key type
+template <class Key>
+vector<size_t> text_properties_of(const text_properties& props,
+                                  boost::shared_ptr<text_value<Key> >
+                                      text_property::* value)
+{
+    vector<size_t> idx;
+    for (size_t i = 0; i < props.size(); ++i)
+        if (props[i].*value)
+            idx.push_back(i);
+    return idx;
+}
+
+template <class Graph, class IndexMap>
+void write_graphml_direct(ostream& out, const Graph& g, IndexMap vertex_index,
+                          const text_properties& props)
+{
+    typedef typename graph_traits<Graph>::directed_category directed_category;
+    bool graph_is_directed = is_convertible<directed_category*,
+                                            directed_tag*>::value;
+
+    text_buffer buf(out);
+    buf << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        << "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\"\n"
+           "         xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n"
+           "         xsi:schemaLocation=\"http://graphml.graphdrawing.org/xmlns"
+           " http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd\">\n\n";
+
+    buf << "  <!-- property keys -->\n";
+    vector<string> key_ids;
+    for (size_t i = 0; i < props.size(); ++i)
+    {
+        const text_property& p = props[i];
+        key_ids.push_back("key" + lexical_cast<string>(i));
+        buf << "  <key id=\"" << key_ids.back() << "\" for=\""
+            << (p.graph ? "graph" : (p.vertex ? "node" : "edge")) << "\""
+            << " attr.name=\"";
+        buf.put_xml(p.name);
+        buf << "\" attr.type=\""
+            << (p.graphml_type != 0 ? p.graphml_type : "string")
+            << "\" />\n";
+    }
+
+    buf << "\n  <graph id=\"G\" edgedefault=\""
+        << (graph_is_directed ? "directed" : "undirected") << "\""
+        << " parse.nodeids=\"canonical\" parse.edgeids=\"canonical\""
+        << " parse.order=\"nodesfirst\">\n\n";
+
+    string val;
+    buf << "   <!-- graph properties -->\n";
+    vector<size_t> gprops = text_properties_of(props, &text_property::graph);
+    for (size_t i = 0; i < gprops.size(); ++i)
+    {
+        const text_property& p = props[gprops[i]];
+        val.clear();
+        if (p.graphml_type != 0)
+            p.graph->format(val, graph_property_tag(), false);
+        if (val.empty())
+            continue;
+        buf << "   <data key=\"" << key_ids[gprops[i]] << "\">";
+        buf.put_xml(val);
+        buf << "</data>\n";
+    }
+
+    buf << "\n   <!-- vertices -->\n";
+    vector<size_t> vprops = text_properties_of(props, &text_property::vertex);
+    typename graph_traits<Graph>::vertex_iterator v, v_end;
+    for (tie(v, v_end) = vertices(g); v != v_end; ++v)
+    {
+        buf << "    <node id=\"n" << size_t(get(vertex_index, *v)) << "\">\n";
+        for (size_t i = 0; i < vprops.size(); ++i)
+        {
+            const text_property& p = props[vprops[i]];
+            val.clear();
+            if (p.graphml_type != 0)
+                p.vertex->format(val, *v, false);
+            if (val.empty())
+                continue;
+            buf << "      <data key=\"" << key_ids[vprops[i]] << "\">";
+            buf.put_xml(val);
+            buf << "</data>\n";
+        }
+        buf << "    </node>\n";
+    }
+
+    buf << "\n   <!-- edges -->\n";
+    vector<size_t> eprops = text_properties_of(props, &text_property::edge);
+    typename graph_traits<Graph>::edge_iterator e, e_end;
+    size_t edge_count = 0;
+    for (tie(e, e_end) = edges(g); e != e_end; ++e)
+    {
+        buf << "    <edge id=\"e" << edge_count++
+            << "\" source=\"n" << size_t(get(vertex_index, source(*e, g)))
+            << "\" target=\"n" << size_t(get(vertex_index, target(*e, g)))
+            << "\">\n";
+        for (size_t i = 0; i < eprops.size(); ++i)
+        {
+            const text_property& p = props[eprops[i]];
+            val.clear();
+            if (p.graphml_type != 0)
+                p.edge->format(val, *e, false);
+            if (val.empty())
+                continue;
+            buf << "      <data key=\"" << key_ids[eprops[i]] << "\">";
+            buf.put_xml(val);
+            buf << "</data>\n";
+        }
+        buf << "    </edge>\n";
+    }
+
+    buf << "\n  </graph>\n"
+        << "</graphml>\n";
+    buf.flush();
+}
+
+template <class Graph, class IndexMap>
+void write_gml_direct(ostream& out, const Graph& g, IndexMap vertex_index,
+                      const text_properties& props)
+{
+    typedef typename graph_traits<Graph>::directed_category directed_category;
+    bool graph_is_directed = is_convertible<directed_category*,
+                                            directed_tag*>::value;
+
+    text_buffer buf(out);
+    buf << "graph [\n";
+    if (graph_is_directed)
+        buf << "   directed 1\n";
+
+    string val;
+    vector<size_t> gprops = text_properties_of(props, &text_property::graph);
+    for (size_t i = 0; i < gprops.size(); ++i)
+    {
+        const text_property& p = props[gprops[i]];
+        if (!p.gml)
+            continue;
+        val.clear();
+        p.graph->format(val, graph_property_tag(), true);
+        buf << "   " << p.name << " ";
+        if (p.scalar)
+            buf << val;
+        else
+            buf.put_quoted(val);
+        buf << "\n";
+    }
+
+    vector<size_t> vprops = text_properties_of(props, &text_property::vertex);
+    typename graph_traits<Graph>::vertex_iterator v, v_end;
+    for (tie(v, v_end) = vertices(g); v != v_end; ++v)
+    {
+        buf << "   node [\n"
+            << "      id " << size_t(get(vertex_index, *v)) << "\n";
+        for (size_t i = 0; i < vprops.size(); ++i)
+        {
+            const text_property& p = props[vprops[i]];
+            if (!p.gml)
+                continue;
+            val.clear();
+            p.vertex->format(val, *v, true);
+            buf << "      " << p.name << " ";
+            if (p.scalar)
+                buf << val;
+            else
+                buf.put_quoted(val);
+            buf << "\n";
+        }
+        buf << "   ]\n";
+    }
+
+    vector<size_t> eprops = text_properties_of(props, &text_property::edge);
+    typename graph_traits<Graph>::edge_iterator e, e_end;
+    size_t edge_count = 0;
+    for (tie(e, e_end) = edges(g); e != e_end; ++e)
+    {
+        buf << "   edge [\n"
+            << "      id " << edge_count++ << "\n"
+            << "      source " << size_t(get(vertex_index, source(*e, g)))
+            << "\n"
+            << "      target " << size_t(get(vertex_index, target(*e, g)))
+            << "\n";
+        for (size_t i = 0; i < eprops.size(); ++i)
+        {
+            const text_property& p = props[eprops[i]];
+            if (!p.gml)
+                continue;
+            val.clear();
+            p.edge->format(val, *e, true);
+            buf << "      " << p.name << " ";
+            if (p.scalar)
+                buf << val;
+            else
+                buf.put_quoted(val);
+            buf << "\n";
+        }
+        buf << "   ]\n";
+    }
+    buf << "]\n";
+    buf.flush();
+}
+
+// writes a graph to a file; if tprops is given, it is used instead of dp
 
 struct write_to_file
 {
     template <class Graph, class IndexMap>
     void operator()(ostream& stream, Graph& g, IndexMap index_map,
-                    dynamic_properties& dp, const string& format) const
+                    dynamic_properties& dp, const text_properties* tprops,
+                    const string& format) const
     {
         typedef typename graph_traits<Graph>::vertex_descriptor vertex_t;
 
@@ -414,11 +1306,17 @@ struct write_to_file
         }
         else if (format == "xml")
         {
-            write_graphml(stream, g, index_map, dp, true);
+            if (tprops != 0)
+                write_graphml_direct(stream, g, index_map, *tprops);
+            else
+                write_graphml(stream, g, index_map, dp, true);
         }
         else if (format == "gml")
         {
-            write_gml(stream, g, index_map, dp);
+            if (tprops != 0)
+                write_gml_direct(stream, g, index_map, *tprops);
+            else
+                write_gml(stream, g, index_map, dp);
         }
     }
 };
@@ -427,11 +1325,12 @@ struct write_to_file_fake_undir: public write_to_file
 {
     template <class Graph, class IndexMap>
     void operator()(ostream& stream, Graph& g, IndexMap index_map,
-                    dynamic_properties& dp, const string& format) const
+                    dynamic_properties& dp, const text_properties* tprops,
+                    const string& format) const
     {
         typedef typename Graph::original_graph_t graph_t;
         FakeUndirGraph<graph_t> ug(g);
-        write_to_file(*this)(stream, ug, index_map, dp, format);
+        write_to_file(*this)(stream, ug, index_map, dp, tprops, format);
     }
 };
 
@@ -448,11 +1347,21 @@ struct generate_index
 };
 
 void GraphInterface::WriteToFile(string file, python::object pfile,
-                                 string format, python::list props)
+                                 string format, python::list props,
+                                 int threads)
 {
-    if (format != "xml" && format != "dot" && format != "gml")
+    if (format != "xml" && format != "dot" && format != "gml" &&
+        format != "gt" && format != "gti")
         throw ValueException("error writing to file '" + file +
                              "': requested invalid format '" + format + "'");
+    if (format == "gti" && (boost::ends_with(file, ".gz") ||
+                            boost::ends_with(file, ".bz2")))
+        throw ValueException("error writing to file '" + file +
+                             "': the 'gti' format cannot be compressed");
+    if (threads < 1)
+        throw ValueException("error writing to file '" + file +
+                             "': invalid number of threads: " +
+                             lexical_cast<string>(threads));
     try
     {
         boost::iostreams::filtering_stream<boost::iostreams::output> stream;
@@ -466,9 +1375,13 @@ void GraphInterface::WriteToFile(string file, python::object pfile,
                 file_stream.open(file.c_str(), std::ios_base::out |
                                  std::ios_base::binary);
                 file_stream.exceptions(ios_base::badbit | ios_base::failbit);
-                if (boost::ends_with(file,".gz"))
+                bool gz = boost::ends_with(file,".gz");
+                bool bz2 = boost::ends_with(file,".bz2");
+                if ((gz || bz2) && threads > 1)
+                    stream.push(parallel_compressor(bz2, threads));
+                else if (gz)
                     stream.push(boost::iostreams::gzip_compressor());
-                if (boost::ends_with(file,".bz2"))
+                else if (bz2)
                     stream.push(boost::iostreams::bzip2_compressor());
                 stream.push(file_stream);
             }
@@ -480,8 +1393,26 @@ void GraphInterface::WriteToFile(string file, python::object pfile,
         }
         stream.exceptions(ios_base::badbit | ios_base::failbit);
 
+        if (format == "gt")
+        {
+            WriteBinary(stream, props);
+            stream.reset();
+            return;
+        }
+        if (format == "gti")
+        {
+            WriteImage(stream, props);
+            stream.reset();
+            return;
+        }
+
+        // the property maps are written directly if possible, otherwise via
+        // dynamic_properties
+        text_properties tprops;
+        bool direct = (format != "dot" && get_text_properties(props, tprops));
+
         dynamic_properties dp;
-        for (int i = 0; i < len(props); ++i)
+        for (int i = 0; !direct && i < len(props); ++i)
         {
             dynamic_property_map* pmap =
                 any_cast<dynamic_property_map*>
@@ -507,12 +1438,14 @@ void GraphInterface::WriteToFile(string file, python::object pfile,
                     (*this, boost::bind<void>(write_to_file(),
                                               boost::ref(stream), _1,
                                               index_map, boost::ref(dp),
+                                              direct ? &tprops : 0,
                                               format))();
             else
                 run_action<detail::never_directed>()
                     (*this,boost::bind<void>(write_to_file_fake_undir(),
                                              boost::ref(stream), _1, index_map,
-                                             boost::ref(dp), format))();
+                                             boost::ref(dp),
+                                             direct ? &tprops : 0, format))();
         }
         else
         {
@@ -524,13 +1457,14 @@ void GraphInterface::WriteToFile(string file, python::object pfile,
                     (*this, boost::bind<void>(write_to_file(),
                                               boost::ref(stream), _1,
                                               _vertex_index,  boost::ref(dp),
+                                              direct ? &tprops : 0,
                                               format))();
             else
                 run_action<detail::never_directed>()
                     (*this,boost::bind<void>(write_to_file_fake_undir(),
                                              boost::ref(stream), _1,
                                              _vertex_index, boost::ref(dp),
-                                             format))();
+                                             direct ? &tprops : 0, format))();
         }
         stream.reset();
     }
@@ -539,3 +1473,70 @@ void GraphInterface::WriteToFile(string file, python::object pfile,
         throw IOException("error writing to file '" + file + "':" + e.what());
     }
 }
+
+//
+// In-memory serialization (used for pickling)
+// ===========================================
+//
+// The graph is written in the binary "gt" format to a memory buffer, which is
+// returned as a python bytes object, without the need of a file-like object in
+// between. If requested, the buffer is gzip-compressed (with the fastest
+// compression level), which is detected automatically when it is read back.
+
+python::object GraphInterface::WriteToBlob(python::list props, bool compress)
+{
+    vector<char> buf;
+    try
+    {
+        boost::iostreams::filtering_stream<boost::iostreams::output> stream;
+        if (compress)
+            stream.push(boost::iostreams::gzip_compressor
+                        (boost::iostreams::gzip::best_speed));
+        stream.push(boost::iostreams::back_inserter(buf));
+        stream.exceptions(ios_base::badbit | ios_base::failbit);
+        WriteBinary(stream, props);
+        stream.reset();
+    }
+    catch (ios_base::failure &e)
+    {
+        throw IOException(string("error serializing graph: ") + e.what());
+    }
+    const char* data = buf.empty() ? "" : &buf[0];
+#if (PY_MAJOR_VERSION >= 3)
+    return python::object(python::handle<>
+                          (PyBytes_FromStringAndSize(data, buf.size())));
+#else
+    return python::object(python::handle<>
+                          (PyString_FromStringAndSize(data, buf.size())));
+#endif
+}
+
+python::tuple GraphInterface::ReadFromBlob(python::object blob)
+{
+    char* data;
+    Py_ssize_t size;
+#if (PY_MAJOR_VERSION >= 3)
+    if (PyBytes_AsStringAndSize(blob.ptr(), &data, &size) != 0)
+#else
+    if (PyString_AsStringAndSize(blob.ptr(), &data, &size) != 0)
+#endif
+    {
+        PyErr_Clear();
+        throw ValueException("error deserializing graph: invalid data");
+    }
+    try
+    {
+        boost::iostreams::filtering_stream<boost::iostreams::input> stream;
+        if (size >= 2 && (unsigned char)(data[0]) == 0x1f &&
+            (unsigned char)(data[1]) == 0x8b)
+            stream.push(boost::iostreams::gzip_decompressor());
+        stream.push(boost::iostreams::array_source(data, size));
+        stream.exceptions(ios_base::badbit | ios_base::failbit);
+        set<string> ivp, iep, igp;
+        return ReadBinary(stream, ivp, iep, igp, false);
+    }
+    catch (ios_base::failure &e)
+    {
+        throw IOException(string("error deserializing graph: ") + e.what());
+    }
+}
@@ -0,0 +1,1046 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2013 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include "graph.hh"
+#include "graph_filtering.hh"
+#include "graph_properties.hh"
+#include "graph_util.hh"
+
+#include "graph_python_interface.hh"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <boost/type_traits/is_scalar.hpp>
+#include <boost/python/extract.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <boost/iostreams/categories.hpp>
+#include <boost/iostreams/device/array.hpp>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace boost;
+using namespace graph_tool;
+
+namespace graph_tool
+{
+extern python::object object_pickler;
+extern python::object object_unpickler;
+}
+
+//
+// Binary graph format
+// ===================
+//
+// The "gt" format stores the graph and its property maps in a compact binary
+// form, which is read and written directly from and to the adjacency list and
+// the property map storage, without any parsing or lexical conversion. The
+// layout is the following:
+//
+//   magic            6 bytes: "\xe2\x9b\xbe gt"
+//   version          uint8_t (currently 1)
+//   byte order       uint8_t (0: little endian, 1: big endian)
+//   directed         uint8_t
+//   index width      uint8_t: number of bytes d of each vertex index in the
+//                    edge list (1, 2, 4 or 8, the smallest which fits N)
+//   N                uint64_t: number of vertices
+//   E                uint64_t: number of edges
+//   edge list        E pairs (source, target), d bytes each
+//   property count   uint64_t
+//   property maps    for each map:
+//                        key type     uint8_t (0: graph, 1: vertex, 2: edge)
+//                        name         string
+//                        value type   string (e.g. "vector<double>")
+//                        values       1, N or E values, in the order of the
+//                                     vertices or of the edge list
+//   property index   uint64_t for each map: its position, relative to the
+//                    beginning of the property count
+//   index position   uint64_t: the position of the property index, relative
+//                    to the beginning of the property count
+//   index magic      8 bytes: "gt index"
+//
+// The property index, which was added later, lies at the end of the file, and
+// is ignored by older readers. It allows the property maps to be read lazily,
+// i.e. only when they are first accessed (see GraphInterface::ReadProperty()),
+// if the file is uncompressed.
+//
+// Strings are stored as their length (uint64_t) followed by their bytes, and
+// vectors as their length followed by their elements. Scalars are stored in
+// their native representation, and python::object values are pickled into
+// strings. Files written with a different byte order are rejected.
+//
+// Memory-mapped images
+// ====================
+//
+// The "gti" format is an image of the frozen CSR snapshot of the graph (see
+// graph_csr.hh), which is not read, but mapped into memory, and used in place
+// as the adjacency of the graph. The pages are therefore only read from disk
+// when they are accessed, and are shared via the page cache between all the
+// processes which map the same file. The layout is the following:
+//
+//   magic            7 bytes: "\xe2\x9b\xbe gti"
+//   version          uint8_t (currently 1)
+//   byte order       uint8_t
+//   directed         uint8_t
+//   padding          6 bytes
+//   N                uint64_t: number of vertices
+//   E                uint64_t: number of edges
+//   M                uint64_t: number of edge indexes
+//   offsets          7 uint64_t: the positions in the file of the six CSR
+//                    arrays (in the order of csr_graph::map()), and of the
+//                    property maps
+//   CSR arrays       uint32_t values, each starting at a page boundary
+//   property maps    as in the "gt" format (including the index), except
+//                    that the vertex and edge values are stored in the order
+//                    of their indexes, with N and M values, respectively
+//
+// The property maps are copied into regular property maps when the file is
+// loaded, so that they can be used (and modified) as usual.
+
+namespace
+{
+
+const char gt_magic[] = "\xe2\x9b\xbe gt";
+const size_t gt_magic_size = 6;
+const uint8_t gt_version = 1;
+
+const char gt_index_magic[] = "gt index";
+const size_t gt_index_magic_size = 8;
+
+// number of values which are buffered before they are written
+const size_t chunk_size = 1 << 16;
+
+uint8_t native_byte_order()
+{
+    uint16_t i = 1;
+    return (*reinterpret_cast<uint8_t*>(&i) == 1) ? 0 : 1;
+}
+
+// low-level value IO
+
+template <class T>
+void write_raw(ostream& s, const T& v)
+{
+    s.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <class T>
+void read_raw(istream& s, T& v)
+{
+    s.read(reinterpret_cast<char*>(&v), sizeof(T));
+}
+
+template <class T>
+void write_array(ostream& s, const T* v, size_t n, mpl::true_)
+{
+    if (n > 0)
+        s.write(reinterpret_cast<const char*>(v), n * sizeof(T));
+}
+
+template <class T>
+void read_array(istream& s, T* v, size_t n, mpl::true_)
+{
+    if (n > 0)
+        s.read(reinterpret_cast<char*>(v), n * sizeof(T));
+}
+
+template <class T>
+void write_value(ostream& s, const T& v)
+{
+    write_raw(s, v);
+}
+
+template <class T>
+void read_value(istream& s, T& v)
+{
+    read_raw(s, v);
+}
+
+void write_value(ostream& s, const string& v)
+{
+    write_raw(s, uint64_t(v.size()));
+    s.write(v.data(), v.size());
+}
+
+void read_value(istream& s, string& v)
+{
+    uint64_t n = 0;
+    read_raw(s, n);
+    if (!s)
+        return;
+    v.resize(n);
+    if (n > 0)
+        s.read(&v[0], n);
+}
+
+void write_value(ostream& s, const python::object& v)
+{
+    stringstream buf;
+    object_pickler(OStream(buf), v);
+    write_value(s, buf.str());
+}
+
+void read_value(istream& s, python::object& v)
+{
+    string str;
+    read_value(s, str);
+    stringstream buf(str);
+    v = object_unpickler(IStream(buf));
+}
+
+template <class T>
+void write_array(ostream& s, const T* v, size_t n, mpl::false_)
+{
+    for (size_t i = 0; i < n; ++i)
+        write_value(s, v[i]);
+}
+
+template <class T>
+void read_array(istream& s, T* v, size_t n, mpl::false_)
+{
+    for (size_t i = 0; i < n; ++i)
+        read_value(s, v[i]);
+}
+
+template <class T>
+void write_value(ostream& s, const vector<T>& v)
+{
+    write_raw(s, uint64_t(v.size()));
+    write_array(s, v.empty() ? 0 : &v[0], v.size(),
+                typename is_scalar<T>::type());
+}
+
+template <class T>
+void read_value(istream& s, vector<T>& v)
+{
+    uint64_t n = 0;
+    read_raw(s, n);
+    if (!s)
+        return;
+    v.resize(n);
+    read_array(s, v.empty() ? 0 : &v[0], n, typename is_scalar<T>::type());
+}
+
+// writes the values of pmap for the descriptors in the range [begin, end);
+// scalar values are gathered in chunks and written as raw blocks
+template <class Iterator, class PropertyMap>
+void write_values(ostream& s, Iterator begin, Iterator end, PropertyMap pmap)
+{
+    typedef typename property_traits<PropertyMap>::value_type val_t;
+    typedef typename is_scalar<val_t>::type is_scalar_t;
+    vector<val_t> buf;
+    buf.reserve(chunk_size);
+    for (; begin != end; ++begin)
+    {
+        buf.push_back(get(pmap, *begin));
+        if (buf.size() == chunk_size)
+        {
+            write_array(s, &buf[0], buf.size(), is_scalar_t());
+            buf.clear();
+        }
+    }
+    write_array(s, buf.empty() ? 0 : &buf[0], buf.size(), is_scalar_t());
+}
+
+//
+// Writing
+//
+
+template <class Index, class Graph, class VertexPos>
+void write_edge_list(ostream& s, const Graph& g, VertexPos pos)
+{
+    vector<Index> buf;
+    buf.reserve(2 * chunk_size);
+    typename graph_traits<Graph>::edge_iterator e, e_end;
+    for (tie(e, e_end) = edges(g); e != e_end; ++e)
+    {
+        buf.push_back(pos[source(*e, g)]);
+        buf.push_back(pos[target(*e, g)]);
+        if (buf.size() == 2 * chunk_size)
+        {
+            write_array(s, &buf[0], buf.size(), mpl::true_());
+            buf.clear();
+        }
+    }
+    write_array(s, buf.empty() ? 0 : &buf[0], buf.size(), mpl::true_());
+}
+
+// writes the values of a single property map, if it has the given value type;
+// if by_index is true, the edge values are written in the order of the edge
+// indexes, for all M indexes
+template <class Graph>
+struct write_property_values
+{
+    write_property_values(ostream& s, const Graph& g, size_t N,
+                          bool contiguous, bool by_index, size_t M,
+                          const string& name, boost::any& map, bool& found)
+        : _s(s), _g(g), _N(N), _contiguous(contiguous), _by_index(by_index),
+          _M(M), _name(name), _map(map), _found(found) {}
+
+    template <class ValueType>
+    void operator()(ValueType) const
+    {
+        typedef typename property_map_type::apply
+            <ValueType, GraphInterface::vertex_index_map_t>::type vmap_t;
+        typedef typename property_map_type::apply
+            <ValueType, GraphInterface::edge_index_map_t>::type emap_t;
+        typedef typename property_map_type::apply
+            <ValueType, GraphInterface::graph_index_map_t>::type gmap_t;
+
+        if (_found)
+            return;
+        if (vmap_t* pmap = any_cast<vmap_t>(&_map))
+        {
+            write_header(1, typeid(ValueType));
+            if (_contiguous)
+            {
+                // the vertices are the first N entries of the storage
+                write_storage(*pmap, _N);
+            }
+            else
+            {
+                typename graph_traits<Graph>::vertex_iterator v, v_end;
+                tie(v, v_end) = vertices(_g);
+                write_values(_s, v, v_end, pmap->get_unchecked());
+            }
+        }
+        else if (emap_t* pmap = any_cast<emap_t>(&_map))
+        {
+            write_header(2, typeid(ValueType));
+            if (_by_index)
+            {
+                write_storage(*pmap, _M);
+            }
+            else
+            {
+                typename graph_traits<Graph>::edge_iterator e, e_end;
+                tie(e, e_end) = edges(_g);
+                write_values(_s, e, e_end, *pmap);
+            }
+        }
+        else if (gmap_t* pmap = any_cast<gmap_t>(&_map))
+        {
+            write_header(0, typeid(ValueType));
+            write_value(_s, (*pmap)[graph_property_tag()]);
+        }
+    }
+
+    void write_header(uint8_t key, const std::type_info& type) const
+    {
+        _found = true;
+        write_raw(_s, key);
+        write_value(_s, _name);
+        write_value(_s, get_type_name<>()(type));
+    }
+
+    // writes the first n entries of the storage
+    template <class PropertyMap>
+    void write_storage(PropertyMap pmap, size_t n) const
+    {
+        typedef typename property_traits<PropertyMap>::value_type val_t;
+        pmap.reserve(n);
+        vector<val_t>& vals = pmap.get_storage();
+        write_array(_s, n == 0 ? 0 : &vals[0], n,
+                    typename is_scalar<val_t>::type());
+    }
+
+    ostream& _s;
+    const Graph& _g;
+    size_t _N;
+    bool _contiguous;
+    bool _by_index;
+    size_t _M;
+    const string& _name;
+    boost::any& _map;
+    bool& _found;
+};
+
+// output device which forwards the data to a stream, and counts it
+class counting_sink
+{
+public:
+    typedef char char_type;
+    typedef iostreams::sink_tag category;
+
+    counting_sink(ostream& s, uint64_t& count): _s(s), _count(count) {}
+
+    std::streamsize write(const char* s, std::streamsize n)
+    {
+        _s.write(s, n);
+        _count += n;
+        return n;
+    }
+
+private:
+    ostream& _s;
+    uint64_t& _count;
+};
+
+// writes the property maps section, followed by its index
+template <class Graph>
+void write_properties(ostream& os, const Graph& g, size_t N, bool contiguous,
+                      bool by_index, size_t M, python::list props)
+{
+    uint64_t pos = 0;
+    counting_sink sink(os, pos);
+    iostreams::stream<counting_sink> s(sink);
+    s.exceptions(ios_base::badbit | ios_base::failbit);
+
+    vector<uint64_t> index;
+    write_raw(s, uint64_t(python::len(props)));
+    for (int i = 0; i < python::len(props); ++i)
+    {
+        s.flush();
+        index.push_back(pos);
+        string name = python::extract<string>(props[i][0]);
+        boost::any map =
+            python::extract<boost::any>(props[i][1].attr("get_map")());
+        bool found = false;
+        mpl::for_each<value_types>
+            (write_property_values<Graph>(s, g, N, contiguous, by_index, M,
+                                          name, map, found));
+        if (!found)
+            throw ValueException("property map '" + name + "' cannot be"
+                                 " written in the binary format");
+    }
+
+    s.flush();
+    uint64_t index_pos = pos;
+    write_array(s, index.empty() ? 0 : &index[0], index.size(), mpl::true_());
+    write_raw(s, index_pos);
+    s.write(gt_index_magic, gt_index_magic_size);
+    s.flush();
+}
+
+struct write_binary
+{
+    template <class Graph>
+    void operator()(const Graph& g, ostream& s, bool directed,
+                    python::list props) const
+    {
+        typedef typename graph_traits<Graph>::vertex_descriptor vertex_t;
+
+        // the vertices are written contiguously, in the order of their
+        // indexes; if some are filtered out, their positions must be
+        // computed
+        size_t N = 0;
+        bool contiguous = true;
+        typename graph_traits<Graph>::vertex_iterator v, v_end;
+        for (tie(v, v_end) = vertices(g); v != v_end; ++v)
+        {
+            if (*v != vertex_t(N))
+                contiguous = false;
+            ++N;
+        }
+        unchecked_vector_property_map<size_t,
+                                      GraphInterface::vertex_index_map_t> pos;
+        if (!contiguous)
+        {
+            pos.reserve(num_vertices(g));
+            size_t i = 0;
+            for (tie(v, v_end) = vertices(g); v != v_end; ++v)
+                pos[*v] = i++;
+        }
+        size_t E = 0;
+        typename graph_traits<Graph>::edge_iterator e, e_end;
+        for (tie(e, e_end) = edges(g); e != e_end; ++e)
+            ++E;
+
+        uint8_t d = 8;
+        if (N <= (size_t(1) << 8))
+            d = 1;
+        else if (N <= (size_t(1) << 16))
+            d = 2;
+        else if (N <= (size_t(1) << 32))
+            d = 4;
+
+        s.write(gt_magic, gt_magic_size);
+        write_raw(s, gt_version);
+        write_raw(s, native_byte_order());
+        write_raw(s, uint8_t(directed));
+        write_raw(s, d);
+        write_raw(s, uint64_t(N));
+        write_raw(s, uint64_t(E));
+
+        switch (d)
+        {
+        case 1:
+            if (contiguous)
+                write_edge_list<uint8_t>(s, g, identity_property_map());
+            else
+                write_edge_list<uint8_t>(s, g, pos);
+            break;
+        case 2:
+            if (contiguous)
+                write_edge_list<uint16_t>(s, g, identity_property_map());
+            else
+                write_edge_list<uint16_t>(s, g, pos);
+            break;
+        case 4:
+            if (contiguous)
+                write_edge_list<uint32_t>(s, g, identity_property_map());
+            else
+                write_edge_list<uint32_t>(s, g, pos);
+            break;
+        default:
+            if (contiguous)
+                write_edge_list<uint64_t>(s, g, identity_property_map());
+            else
+                write_edge_list<uint64_t>(s, g, pos);
+        }
+
+        write_properties(s, g, N, contiguous, false, 0, props);
+    }
+};
+
+//
+// Reading
+//
+
+template <class Index, class Graph>
+void read_edge_list(Graph& g, istream& s, size_t N, size_t E)
+{
+    typedef typename graph_traits<Graph>::vertex_descriptor vertex_t;
+    for (size_t i = 0; i < N; ++i)
+        add_vertex(g);
+
+    vector<Index> buf;
+    for (size_t i = 0; i < E; i += chunk_size)
+    {
+        buf.resize(2 * min(chunk_size, E - i));
+        read_array(s, &buf[0], buf.size(), mpl::true_());
+        if (!s)
+            throw IOException("unexpected end of file");
+        for (size_t j = 0; j < buf.size(); j += 2)
+        {
+            size_t u = buf[j], v = buf[j + 1];
+            if (u >= N || v >= N)
+                throw IOException("invalid vertex index in edge list: " +
+                                  lexical_cast<string>(max(u, v)));
+            add_edge(vertex_t(u), vertex_t(v), g);
+        }
+    }
+}
+
+struct read_binary_edges
+{
+    template <class Graph>
+    void operator()(Graph& g, istream& s, uint8_t d, size_t N, size_t E) const
+    {
+        switch (d)
+        {
+        case 1:
+            read_edge_list<uint8_t>(g, s, N, E);
+            break;
+        case 2:
+            read_edge_list<uint16_t>(g, s, N, E);
+            break;
+        case 4:
+            read_edge_list<uint32_t>(g, s, N, E);
+            break;
+        case 8:
+            read_edge_list<uint64_t>(g, s, N, E);
+            break;
+        default:
+            throw IOException("invalid index width: " +
+                              lexical_cast<string>(int(d)));
+        }
+    }
+};
+
+// reads the values of a property map with the given value type name directly
+// into the storage of a new property map; the vertices and edges are indexed
+// contiguously, in the order in which they were read
+struct read_property_values
+{
+    template <class ValueType>
+    void operator()(ValueType, istream& s, const string& type_name,
+                    uint8_t key, size_t N, size_t E, GraphInterface& gi,
+                    python::object& pmap) const
+    {
+        size_t pos = mpl::find<value_types, ValueType>::type::pos::value;
+        if (pmap.ptr() != Py_None || type_name != type_names[pos])
+            return;
+        switch (key)
+        {
+        case 0:
+            {
+                typedef typename property_map_type::apply
+                    <ValueType, GraphInterface::graph_index_map_t>::type map_t;
+                map_t map(gi.GetGraphIndex());
+                read_value(s, map[graph_property_tag()]);
+                pmap = python::object(PythonPropertyMap<map_t>(map));
+            }
+            break;
+        case 1:
+            pmap = read_values(s, N, gi.GetVertexIndex(), ValueType());
+            break;
+        case 2:
+            pmap = read_values(s, E, gi.GetEdgeIndex(), ValueType());
+            break;
+        default:
+            throw IOException("invalid property key type: " +
+                              lexical_cast<string>(int(key)));
+        }
+    }
+
+    template <class IndexMap, class ValueType>
+    python::object read_values(istream& s, size_t n, IndexMap index,
+                               ValueType) const
+    {
+        typedef typename property_map_type::apply<ValueType, IndexMap>::type
+            map_t;
+        map_t map(index);
+        map.reserve(n);
+        vector<ValueType>& vals = map.get_storage();
+        read_array(s, n == 0 ? 0 : &vals[0], n,
+                   typename is_scalar<ValueType>::type());
+        return python::object(PythonPropertyMap<map_t>(map));
+    }
+};
+
+void read_property_header(istream& s, uint8_t& key, string& name,
+                          string& type_name)
+{
+    read_raw(s, key);
+    read_value(s, name);
+    read_value(s, type_name);
+    if (!s)
+        throw IOException("unexpected end of file");
+}
+
+// reads the values of a single property map, after its header
+python::object read_property(istream& s, GraphInterface& gi, uint8_t key,
+                             const string& name, const string& type_name,
+                             size_t N, size_t M)
+{
+    python::object pmap;
+    mpl::for_each<value_types>
+        (boost::bind<void>(read_property_values(), _1, boost::ref(s),
+                           boost::ref(type_name), key, N, M,
+                           boost::ref(gi), boost::ref(pmap)));
+    if (pmap.ptr() == Py_None)
+        throw IOException("invalid value type for property map '" + name +
+                          "': " + type_name);
+    if (!s)
+        throw IOException("unexpected end of file");
+    return pmap;
+}
+
+// reads the property maps section, with N vertex and M edge values per map
+python::tuple read_properties(istream& s, GraphInterface& gi, size_t N,
+                              size_t M, const set<string>& ivp,
+                              const set<string>& iep, const set<string>& igp)
+{
+    uint64_t n_props = 0;
+    read_raw(s, n_props);
+    python::dict vprops, eprops, gprops;
+    for (size_t i = 0; i < n_props; ++i)
+    {
+        uint8_t key = 0;
+        string name, type_name;
+        read_property_header(s, key, name, type_name);
+        python::object pmap = read_property(s, gi, key, name, type_name, N, M);
+
+        // ignored properties are read, but discarded
+        switch (key)
+        {
+        case 0:
+            if (igp.find(name) == igp.end())
+                gprops[name] = pmap;
+            break;
+        case 1:
+            if (ivp.find(name) == ivp.end())
+                vprops[name] = pmap;
+            break;
+        default:
+            if (iep.find(name) == iep.end())
+                eprops[name] = pmap;
+        }
+    }
+    return python::make_tuple(vprops, eprops, gprops);
+}
+
+// reads the index of the property maps section which begins at the position
+// begin of the (seekable) stream; returns false if there is no index, i.e. if
+// the file was written by an older version
+bool read_property_index(istream& s, uint64_t begin, vector<uint64_t>& index)
+{
+    const uint64_t trailer_size = sizeof(uint64_t) + gt_index_magic_size;
+    s.seekg(0, ios_base::end);
+    uint64_t size = s.tellg();
+    if (!s || size < begin + sizeof(uint64_t) + trailer_size)
+        return false;
+
+    uint64_t n_props = 0, index_pos = 0;
+    char magic[gt_index_magic_size];
+    s.seekg(size - trailer_size);
+    read_raw(s, index_pos);
+    s.read(magic, gt_index_magic_size);
+    if (!s || memcmp(magic, gt_index_magic, gt_index_magic_size) != 0)
+        return false;
+    s.seekg(begin);
+    read_raw(s, n_props);
+    if (!s || index_pos > size - begin - trailer_size ||
+        n_props != (size - begin - trailer_size - index_pos) /
+        sizeof(uint64_t))
+        throw IOException("corrupted property index");
+
+    index.resize(n_props);
+    s.seekg(begin + index_pos);
+    read_array(s, index.empty() ? 0 : &index[0], n_props, mpl::true_());
+    if (!s)
+        throw IOException("unexpected end of file");
+    for (size_t i = 0; i < n_props; ++i)
+        if (index[i] >= index_pos)
+            throw IOException("corrupted property index");
+    return true;
+}
+
+// reads the property maps section, which begins at the current position of
+// the (seekable) stream, using its index: the graph properties are read, but
+// for the vertex and edge properties only a tuple (value type, position,
+// number of values) is returned, which can be passed later to
+// GraphInterface::ReadProperty(); without an index, all maps are read
+python::tuple read_lazy_properties(istream& s, GraphInterface& gi, size_t N,
+                                   size_t M, const set<string>& ivp,
+                                   const set<string>& iep,
+                                   const set<string>& igp)
+{
+    uint64_t begin = s.tellg();
+    vector<uint64_t> index;
+    if (!read_property_index(s, begin, index))
+    {
+        s.clear();
+        s.seekg(begin);
+        return read_properties(s, gi, N, M, ivp, iep, igp);
+    }
+
+    python::dict vprops, eprops, gprops;
+    for (size_t i = 0; i < index.size(); ++i)
+    {
+        uint64_t pos = begin + index[i];
+        s.seekg(pos);
+        uint8_t key = 0;
+        string name, type_name;
+        read_property_header(s, key, name, type_name);
+        switch (key)
+        {
+        case 0:
+            if (igp.find(name) == igp.end())
+                gprops[name] = read_property(s, gi, key, name, type_name, N,
+                                             M);
+            break;
+        case 1:
+            if (ivp.find(name) == ivp.end())
+                vprops[name] = python::make_tuple(type_name, pos, N);
+            break;
+        case 2:
+            if (iep.find(name) == iep.end())
+                eprops[name] = python::make_tuple(type_name, pos, M);
+            break;
+        default:
+            throw IOException("invalid property key type: " +
+                              lexical_cast<string>(int(key)));
+        }
+    }
+    return python::make_tuple(vprops, eprops, gprops);
+}
+
+//
+// Memory-mapped images
+//
+
+const char gti_magic[] = "\xe2\x9b\xbe gti";
+const size_t gti_magic_size = 7;
+const uint8_t gti_version = 1;
+
+// the adjacency arrays start at page boundaries (of the usual page size)
+const size_t gti_alignment = 4096;
+
+const size_t gti_header_size = 16 + 3 * sizeof(uint64_t) +
+    (GraphInterface::csr_graph_t::n_arrays + 1) * sizeof(uint64_t);
+
+size_t gti_align(size_t pos)
+{
+    return (pos + gti_alignment - 1) / gti_alignment * gti_alignment;
+}
+
+// number of values of each adjacency array of a CSR graph, in the order of
+// csr_graph::map()
+size_t gti_array_size(size_t i, size_t N, size_t E)
+{
+    return (i % 3 == 0) ? N + 1 : E;
+}
+
+void write_padding(ostream& s, size_t n)
+{
+    static const char zeros[gti_alignment] = {0};
+    s.write(zeros, n);
+}
+
+struct build_csr
+{
+    template <class Graph>
+    void operator()(const Graph& g, GraphInterface::csr_graph_t& csr) const
+    {
+        csr.build(g);
+    }
+};
+
+struct write_image
+{
+    template <class Graph>
+    void operator()(const Graph& g, ostream& s,
+                    const GraphInterface::csr_graph_t& csr, bool directed,
+                    python::list props) const
+    {
+        typedef GraphInterface::csr_graph_t csr_graph_t;
+        typedef csr_graph_t::index_t index_t;
+        const size_t n_arrays = csr_graph_t::n_arrays;
+        size_t N = num_vertices(csr);
+        size_t E = num_edges(csr);
+        size_t M = csr.get_last_index();
+
+        uint64_t offsets[n_arrays + 1];
+        size_t pos = gti_header_size;
+        for (size_t i = 0; i < n_arrays; ++i)
+        {
+            offsets[i] = gti_align(pos);
+            pos = offsets[i] + gti_array_size(i, N, E) * sizeof(index_t);
+        }
+        offsets[n_arrays] = gti_align(pos);
+
+        s.write(gti_magic, gti_magic_size);
+        write_raw(s, gti_version);
+        write_raw(s, native_byte_order());
+        write_raw(s, uint8_t(directed));
+        write_padding(s, 6);
+        write_raw(s, uint64_t(N));
+        write_raw(s, uint64_t(E));
+        write_raw(s, uint64_t(M));
+        write_array(s, offsets, n_arrays + 1, mpl::true_());
+
+        pos = gti_header_size;
+        for (size_t i = 0; i < n_arrays; ++i)
+        {
+            write_padding(s, offsets[i] - pos);
+            const csr_array<index_t>& a = csr.get_array(i);
+            write_array(s, a.empty() ? 0 : &a[0], a.size(), mpl::true_());
+            pos = offsets[i] + a.size() * sizeof(index_t);
+        }
+        write_padding(s, offsets[n_arrays] - pos);
+
+        // the vertex and edge values are stored in the order of their indexes
+        write_properties(s, g, N, true, true, M, props);
+    }
+};
+
+struct unmap_image
+{
+    unmap_image(size_t size): _size(size) {}
+    void operator()(void* p) const { ::munmap(p, _size); }
+    size_t _size;
+};
+
+} // anonymous namespace
+
+void GraphInterface::WriteBinary(ostream& s, python::list props)
+{
+    // the edges are always written in their stored direction
+    bool directed = _directed;
+    _directed = true;
+    try
+    {
+        run_action<>()(*this, boost::bind<void>(write_binary(), _1,
+                                                boost::ref(s), directed,
+                                                props))();
+    }
+    catch (...)
+    {
+        _directed = directed;
+        throw;
+    }
+    _directed = directed;
+}
+
+python::tuple GraphInterface::ReadBinary(istream& s, const set<string>& ivp,
+                                         const set<string>& iep,
+                                         const set<string>& igp, bool lazy)
+{
+    char magic[gt_magic_size];
+    s.read(magic, gt_magic_size);
+    if (!s || memcmp(magic, gt_magic, gt_magic_size) != 0)
+        throw IOException("not a graph-tool binary file");
+    uint8_t version = 0, byte_order = 0, directed = 0, d = 0;
+    uint64_t N = 0, E = 0;
+    read_raw(s, version);
+    read_raw(s, byte_order);
+    read_raw(s, directed);
+    read_raw(s, d);
+    read_raw(s, N);
+    read_raw(s, E);
+    if (!s)
+        throw IOException("unexpected end of file");
+    if (version > gt_version)
+        throw IOException("unsupported binary format version: " +
+                          lexical_cast<string>(int(version)));
+    if (byte_order != native_byte_order())
+        throw IOException("binary file was written with a different byte "
+                          "order");
+
+    *_mg = multigraph_t();
+    if (_index32)
+        *_mg32 = multigraph32_t();
+    RunOnGraph(boost::bind<void>(read_binary_edges(), _1, boost::ref(s), d,
+                                 N, E));
+    _directed = directed;
+
+    if (lazy)
+        return read_lazy_properties(s, *this, N, E, ivp, iep, igp);
+    return read_properties(s, *this, N, E, ivp, iep, igp);
+}
+
+void GraphInterface::WriteImage(ostream& s, python::list props)
+{
+    // a frozen graph already has the snapshot which is written
+    csr_graph_t csr;
+    if (!_csr->is_valid())
+        RunOnGraph(boost::bind<void>(build_csr(), _1, boost::ref(csr)));
+    RunOnGraph(boost::bind<void>(write_image(), _1, boost::ref(s),
+                                 boost::cref(_csr->is_valid() ? *_csr : csr),
+                                 _directed, props));
+}
+
+python::tuple GraphInterface::ReadImage(const string& file,
+                                        const set<string>& ivp,
+                                        const set<string>& iep,
+                                        const set<string>& igp, bool lazy)
+{
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw IOException("error opening file '" + file + "': " +
+                          strerror(errno));
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        throw IOException("error reading file '" + file + "': " +
+                          strerror(errno));
+    }
+    size_t size = st.st_size;
+    if (size < gti_header_size)
+    {
+        ::close(fd);
+        throw IOException("not a graph-tool image file: " + file);
+    }
+    // the mapping is shared, so that the pages are shared via the page cache
+    // with all processes which map the same file
+    void* p = ::mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+        throw IOException("error mapping file '" + file + "': " +
+                          strerror(errno));
+    shared_ptr<void> image(p, unmap_image(size));
+    const char* data = static_cast<const char*>(p);
+
+    iostreams::stream<iostreams::array_source> s(data, size);
+    char magic[gti_magic_size];
+    s.read(magic, gti_magic_size);
+    if (memcmp(magic, gti_magic, gti_magic_size) != 0)
+        throw IOException("not a graph-tool image file: " + file);
+    uint8_t version = 0, byte_order = 0, directed = 0;
+    uint64_t N = 0, E = 0, M = 0;
+    const size_t n_arrays = csr_graph_t::n_arrays;
+    uint64_t offsets[n_arrays + 1];
+    read_raw(s, version);
+    read_raw(s, byte_order);
+    read_raw(s, directed);
+    s.ignore(6);
+    read_raw(s, N);
+    read_raw(s, E);
+    read_raw(s, M);
+    read_array(s, offsets, n_arrays + 1, mpl::true_());
+    if (!s)
+        throw IOException("unexpected end of file");
+    if (version > gti_version)
+        throw IOException("unsupported image format version: " +
+                          lexical_cast<string>(int(version)));
+    if (byte_order != native_byte_order())
+        throw IOException("image file was written with a different byte "
+                          "order");
+
+    // the arrays are used in place, so they must lie within the file, and be
+    // properly aligned; their contents are not verified, since that would
+    // require reading all of them
+    typedef csr_graph_t::index_t index_t;
+    const index_t* arrays[n_arrays];
+    for (size_t i = 0; i < n_arrays; ++i)
+    {
+        size_t n = gti_array_size(i, N, E);
+        if (offsets[i] % sizeof(index_t) != 0 || offsets[i] > size ||
+            n > (size - offsets[i]) / sizeof(index_t))
+            throw IOException("corrupted image file: " + file);
+        arrays[i] = reinterpret_cast<const index_t*>(data + offsets[i]);
+    }
+    if (arrays[0][N] != E || arrays[3][N] != E || offsets[n_arrays] > size)
+        throw IOException("corrupted image file: " + file);
+
+    *_mg = multigraph_t();
+    if (_index32)
+        *_mg32 = multigraph32_t();
+    _csr->map(arrays, N, E, M, image);
+    _filter_cache.valid = false;
+    _directed = directed;
+
+    // the property values are copied into regular property maps
+    s.seekg(offsets[n_arrays]);
+    if (lazy)
+        return read_lazy_properties(s, *this, N, M, ivp, iep, igp);
+    return read_properties(s, *this, N, M, ivp, iep, igp);
+}
+
+python::object GraphInterface::ReadProperty(string file, size_t pos, size_t n)
+{
+    std::ifstream s(file.c_str(), ios_base::in | ios_base::binary);
+    if (!s)
+        throw IOException("error opening file '" + file + "': " +
+                          strerror(errno));
+    try
+    {
+        s.seekg(pos);
+        uint8_t key = 0;
+        string name, type_name;
+        read_property_header(s, key, name, type_name);
+        if (key != 1 && key != 2)
+            throw IOException("invalid property key type: " +
+                              lexical_cast<string>(int(key)));
+        return read_property(s, *this, key, name, type_name, n, n);
+    }
+    catch (IOException& e)
+    {
+        throw IOException("error reading from file '" + file + "': " +
+                          e.what());
+    }
+}
@@ -38,23 +38,29 @@ namespace graph_tool
 
 // global property types' names
 const char* type_names[] =
-    {"bool", "int16_t", "int32_t", "int64_t", "double", "long double",
-     "string", "vector<bool>", "vector<int16_t>", "vector<int32_t>",
-     "vector<int64_t>", "vector<double>", "vector<long double>",
-     "vector<string>", "python::object"};
+    {"bool", "int8_t", "int16_t", "int32_t", "uint32_t", "int64_t", "float",
+     "double", "long double", "string", "vector<bool>", "vector<int8_t>",
+     "vector<int16_t>", "vector<int32_t>", "vector<uint32_t>",
+     "vector<int64_t>", "vector<float>", "vector<double>",
+     "vector<long double>", "vector<string>", "python::object"};
 
 
 struct shift_vertex_property
 {
     template <class PropertyMap>
-    void operator()(PropertyMap, const GraphInterface::multigraph_t& g,
-                    boost::any map, size_t vi, bool& found) const
+    void operator()(PropertyMap, size_t N, boost::any map, size_t vi,
+                    bool& found) const
     {
+        typedef GraphInterface::vertex_t vertex_t;
+        typedef typename property_traits<PropertyMap>::value_type val_t;
         try
         {
             PropertyMap pmap = any_cast<PropertyMap>(map);
-            for (size_t i = vi; i < num_vertices(g)-1; ++i)
-                pmap[vertex(i,g)] = pmap[vertex(i+1,g)];
+            for (size_t i = vi; i < N - 1; ++i)
+            {
+                val_t val = get(pmap, vertex_t(i + 1));
+                put(pmap, vertex_t(i), val);
+            }
             found = true;
         }
         catch (bad_any_cast&) {}
@@ -66,7 +72,13 @@ void GraphInterface::ShiftVertexProperty(boost::any prop, size_t index) const
 {
     bool found = false;
     mpl::for_each<writable_vertex_properties>
-        (bind<void>(shift_vertex_property(), _1, ref(*_mg),
+        (bind<void>(shift_vertex_property(), _1, GetTotalNumberOfVertices(),
+                    prop, index, ref(found)));
+    mpl::for_each<vertex_sparse_scalar_properties>
+        (bind<void>(shift_vertex_property(), _1, GetTotalNumberOfVertices(),
+                    prop, index, ref(found)));
+    mpl::for_each<vertex_mapped_scalar_properties>
+        (bind<void>(shift_vertex_property(), _1, GetTotalNumberOfVertices(),
                     prop, index, ref(found)));
     if (!found)
         throw GraphException("invalid writable property map");
@@ -75,13 +87,16 @@ void GraphInterface::ShiftVertexProperty(boost::any prop, size_t index) const
 struct move_vertex_property
 {
     template <class PropertyMap>
-    void operator()(PropertyMap, const GraphInterface::multigraph_t& g,
-                    boost::any map, size_t vi, size_t back, bool& found) const
+    void operator()(PropertyMap, boost::any map, size_t vi, size_t back,
+                    bool& found) const
     {
+        typedef GraphInterface::vertex_t vertex_t;
+        typedef typename property_traits<PropertyMap>::value_type val_t;
         try
         {
             PropertyMap pmap = any_cast<PropertyMap>(map);
-            pmap[vertex(vi,g)] = pmap[vertex(back,g)];
+            val_t val = get(pmap, vertex_t(back));
+            put(pmap, vertex_t(vi), val);
             found = true;
         }
         catch (bad_any_cast&) {}
@@ -91,11 +106,17 @@ struct move_vertex_property
 // this function will move the back of the property map when a vertex in the middle is to be deleted
 void GraphInterface::MoveVertexProperty(boost::any prop, size_t index) const
 {
-    size_t back = num_vertices(*_mg) - 1;
+    size_t back = GetTotalNumberOfVertices() - 1;
     bool found = false;
     mpl::for_each<writable_vertex_properties>
-        (bind<void>(move_vertex_property(), _1, ref(*_mg),
-                    prop, index, back, ref(found)));
+        (bind<void>(move_vertex_property(), _1, prop, index, back,
+                    ref(found)));
+    mpl::for_each<vertex_sparse_scalar_properties>
+        (bind<void>(move_vertex_property(), _1, prop, index, back,
+                    ref(found)));
+    mpl::for_each<vertex_mapped_scalar_properties>
+        (bind<void>(move_vertex_property(), _1, prop, index, back,
+                    ref(found)));
     if (!found)
         throw GraphException("invalid writable property map");
 }
@@ -104,17 +125,22 @@ void GraphInterface::MoveVertexProperty(boost::any prop, size_t index) const
 struct reindex_vertex_property
 {
     template <class PropertyMap, class IndexMap>
-    void operator()(PropertyMap, const GraphInterface::multigraph_t& g,
-                    boost::any map, IndexMap old_index, bool& found) const
+    void operator()(PropertyMap, size_t N, boost::any map, IndexMap old_index,
+                    bool& found) const
     {
+        typedef GraphInterface::vertex_t vertex_t;
+        typedef typename property_traits<PropertyMap>::value_type val_t;
         try
         {
             PropertyMap pmap = any_cast<PropertyMap>(map);
-            for (size_t i = 0; i < num_vertices(g); ++i)
+            for (size_t i = 0; i < N; ++i)
             {
-                GraphInterface::vertex_t v = vertex(i, g);
+                vertex_t v(i);
                 if (old_index[v] != int(i))
-                    pmap[v] = pmap[vertex(old_index[v], g)];
+                {
+                    val_t val = get(pmap, vertex_t(old_index[v]));
+                    put(pmap, v, val);
+                }
             }
             found = true;
         }
@@ -133,13 +159,78 @@ void GraphInterface::ReIndexVertexProperty(boost::any map,
 
     bool found = false;
     mpl::for_each<writable_vertex_properties>
-        (bind<void>(reindex_vertex_property(), _1, ref(*_mg),
+        (bind<void>(reindex_vertex_property(), _1, GetTotalNumberOfVertices(),
+                    map, old_index, ref(found)));
+    mpl::for_each<vertex_sparse_scalar_properties>
+        (bind<void>(reindex_vertex_property(), _1, GetTotalNumberOfVertices(),
+                    map, old_index, ref(found)));
+    mpl::for_each<vertex_mapped_scalar_properties>
+        (bind<void>(reindex_vertex_property(), _1, GetTotalNumberOfVertices(),
                     map, old_index, ref(found)));
     if (!found)
         throw GraphException("invalid writable property map");
 
 }
 
+// applies a permutation of the vertices to a property map, such that
+// pmap[v] = pmap[old_index[v]], following each cycle of the permutation
+struct permute_vertex_property
+{
+    template <class PropertyMap, class IndexMap>
+    void operator()(PropertyMap, size_t N, boost::any map, IndexMap old_index,
+                    bool& found) const
+    {
+        typedef GraphInterface::vertex_t vertex_t;
+        typedef typename property_traits<PropertyMap>::value_type val_t;
+        try
+        {
+            PropertyMap pmap = any_cast<PropertyMap>(map);
+            vector<bool> done(N, false);
+            for (size_t i = 0; i < N; ++i)
+            {
+                if (done[i])
+                    continue;
+                val_t val = get(pmap, vertex_t(i));
+                size_t j = i;
+                while (size_t(old_index[vertex_t(j)]) != i)
+                {
+                    size_t k = old_index[vertex_t(j)];
+                    val_t kval = get(pmap, vertex_t(k));
+                    put(pmap, vertex_t(j), kval);
+                    done[j] = true;
+                    j = k;
+                }
+                put(pmap, vertex_t(j), val);
+                done[j] = true;
+            }
+            found = true;
+        }
+        catch (bad_any_cast&) {}
+    }
+};
+
+void GraphInterface::PermuteVertexProperty(boost::any map,
+                                           boost::any aold_index) const
+{
+    typedef property_map_type::apply<int64_t,
+                                     GraphInterface::vertex_index_map_t>::type
+        index_prop_t;
+    index_prop_t old_index = any_cast<index_prop_t>(aold_index);
+
+    bool found = false;
+    mpl::for_each<writable_vertex_properties>
+        (bind<void>(permute_vertex_property(), _1, GetTotalNumberOfVertices(),
+                    map, old_index, ref(found)));
+    mpl::for_each<vertex_sparse_scalar_properties>
+        (bind<void>(permute_vertex_property(), _1, GetTotalNumberOfVertices(),
+                    map, old_index, ref(found)));
+    mpl::for_each<vertex_mapped_scalar_properties>
+        (bind<void>(permute_vertex_property(), _1, GetTotalNumberOfVertices(),
+                    map, old_index, ref(found)));
+    if (!found)
+        throw GraphException("invalid writable property map");
+}
+
 } // graph_tool namespace
 
 
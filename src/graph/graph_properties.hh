@@ -39,7 +39,10 @@
 #   include <boost/dynamic_property_map.hpp>
 #endif
 #include "fast_vector_property_map.hh"
+#include "sparse_property_map.hh"
+#include "mapped_property_map.hh"
 #include <boost/mpl/vector.hpp>
+#include <boost/mpl/vector/vector30.hpp>
 #include <boost/mpl/for_each.hpp>
 #include <boost/mpl/transform.hpp>
 #include <boost/mpl/find.hpp>
@@ -66,25 +69,31 @@ using namespace boost;
 // Note: we must avoid a vector<bool> (and bools in general) since it is quite
 //       broken, and use a vector<uint8_t> instead!
 //       see: http://www.gotw.ca/publications/N1211.pdf
-
-typedef mpl::vector<uint8_t, int16_t, int32_t, int64_t, double, long double, string,
-                    vector<uint8_t>, vector<int16_t>, vector<int32_t>, vector<int64_t>,
-                    vector<double>, vector<long double>, vector<string>,
-                    python::object>
+// Note: the numbered form of mpl::vector is used, since the variadic one is
+//       limited to 20 types
+
+typedef mpl::vector21<uint8_t, int8_t, int16_t, int32_t, uint32_t, int64_t,
+                    float, double, long double, string,
+                    vector<uint8_t>, vector<int8_t>, vector<int16_t>,
+                    vector<int32_t>, vector<uint32_t>, vector<int64_t>,
+                    vector<float>, vector<double>, vector<long double>,
+                    vector<string>, python::object>
     value_types;
 
 extern const char* type_names[]; // respective type names (defined in
                                  // graph_properties.cc)
 
 // scalar types: types contained in value_types which are scalar
-typedef mpl::vector<uint8_t, int16_t, int32_t, int64_t, double, long double>
+typedef mpl::vector<uint8_t, int8_t, int16_t, int32_t, uint32_t, int64_t,
+                    float, double, long double>
     scalar_types;
 
 // integer_types: scalar types which are integer
-typedef mpl::vector<uint8_t, int16_t, int32_t, int64_t> integer_types;
+typedef mpl::vector<uint8_t, int8_t, int16_t, int32_t, uint32_t, int64_t>
+    integer_types;
 
 // floating_types: scalar types which are floating point
-typedef mpl::vector<double, long double> floating_types;
+typedef mpl::vector<float, double, long double> floating_types;
 
 struct make_vector
 {
@@ -115,8 +124,28 @@ struct property_map_type
     };
 };
 
+// the same as above, for the hash-backed sparse_property_map
+struct sparse_property_map_type
+{
+    template <class ValueType, class IndexMap>
+    struct apply
+    {
+        typedef sparse_property_map<ValueType,IndexMap> type;
+    };
+};
+
+// the same as above, for the file-backed mapped_vector_property_map
+struct mapped_property_map_type
+{
+    template <class ValueType, class IndexMap>
+    struct apply
+    {
+        typedef mapped_vector_property_map<ValueType,IndexMap> type;
+    };
+};
+
 // metafunction to get the sequence of property map types of ValueTypes and
-// IndexMap
+// IndexMap, generated by MapType
 struct property_map_types
 {
    // this wraps an unary metafunction class Bind into a unary metafunction,
@@ -131,12 +160,13 @@ struct property_map_types
     };
 
     template <class ValueTypes, class IndexMap,
-              class IncludeIndexMap = mpl::bool_<true> >
+              class IncludeIndexMap = mpl::bool_<true>,
+              class MapType = property_map_type>
     struct apply
     {
         typedef typename mpl::transform<
             ValueTypes,
-            bind_wrap1<mpl::bind2<property_map_type,
+            bind_wrap1<mpl::bind2<MapType,
                                   mpl::_1,
                                   IndexMap> >
             >::type scalar_properties;
@@ -303,8 +333,8 @@ struct convert
     {
         T1 operator()(const string& v) const
         {
-            //uint8_t is not char, it is bool!
-            if (is_same<T1, uint8_t>::value)
+            //uint8_t is not char, it is bool! (and int8_t is a small integer)
+            if (is_same<T1, uint8_t>::value || is_same<T1, int8_t>::value)
                 return convert<T1,int>()(lexical_cast<int>(v));
             else
                 return lexical_cast<T1>(v);
@@ -316,8 +346,8 @@ struct convert
     {
         string operator()(const T2& v) const
         {
-            //uint8_t is not char, it is bool!
-            if (is_same<T2, uint8_t>::value)
+            //uint8_t is not char, it is bool! (and int8_t is a small integer)
+            if (is_same<T2, uint8_t>::value || is_same<T2, int8_t>::value)
                 return lexical_cast<string>(convert<int,T2>()(v));
             else
                 return lexical_cast<string>(v);
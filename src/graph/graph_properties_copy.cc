@@ -20,6 +20,7 @@
 #include "graph_properties.hh"
 
 #include <boost/mpl/contains.hpp>
+#include <boost/mpl/joint_view.hpp>
 #include <boost/python/extract.hpp>
 
 using namespace std;
@@ -52,7 +53,7 @@ struct copy_property
                 if (vt == vt_end)
                     throw ValueException("Error copying properties: "
                                          "graphs not compatible");
-                dst_map[*vt] = get(src_map, *vs);
+                put(dst_map, *vt, get(src_map, *vs));
                 ++vt;
             }
         }
@@ -113,14 +114,39 @@ struct graph_views:
     mpl::transform<graph_tool::detail::always_directed_never_reversed,
                    mpl::quote1<add_pointer> >::type {};
 
+// copying from or to sparse and memory-mapped property maps is also supported,
+// which is how they are converted to and from regular ones; since put() does
+// not store default values in sparse maps, the result contains only the
+// non-default entries
+
+struct vertex_extra_properties:
+    mpl::joint_view<vertex_sparse_scalar_properties,
+                    vertex_mapped_scalar_properties> {};
+
+struct edge_extra_properties:
+    mpl::joint_view<edge_sparse_scalar_properties,
+                    edge_mapped_scalar_properties> {};
+
+struct src_vertex_properties:
+    mpl::joint_view<vertex_properties, vertex_extra_properties> {};
+
+struct tgt_vertex_properties:
+    mpl::joint_view<writable_vertex_properties, vertex_extra_properties> {};
+
+struct src_edge_properties:
+    mpl::joint_view<edge_properties, edge_extra_properties> {};
+
+struct tgt_edge_properties:
+    mpl::joint_view<writable_edge_properties, edge_extra_properties> {};
+
 void GraphInterface::CopyVertexProperty(const GraphInterface& src,
                                         boost::any prop_src,
                                         boost::any prop_tgt)
 {
     run_action<>()
-        (*this, boost::bind<void>(copy_property<vertex_selector,vertex_properties>(),
+        (*this, boost::bind<void>(copy_property<vertex_selector,src_vertex_properties>(),
                                   _1, _2, _3, prop_src),
-         graph_views(), writable_vertex_properties())
+         graph_views(), tgt_vertex_properties())
         (src.GetGraphView(), prop_tgt);
 }
 
@@ -129,8 +155,8 @@ void GraphInterface::CopyEdgeProperty(const GraphInterface& src,
                                       boost::any prop_tgt)
 {
     run_action<>()
-        (*this, boost::bind<void>(copy_property<edge_selector,edge_properties>(),
+        (*this, boost::bind<void>(copy_property<edge_selector,src_edge_properties>(),
                                   _1, _2, _3, prop_src),
-         graph_views(), writable_edge_properties())
+         graph_views(), tgt_edge_properties())
         (src.GetGraphView(), prop_tgt);
 }
@@ -0,0 +1,143 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2013 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include "graph.hh"
+#include "graph_properties.hh"
+
+#include "tr1_include.hh"
+#include TR1_HEADER(unordered_map)
+
+#include <limits>
+#include <boost/python/extract.hpp>
+
+using namespace std;
+using namespace boost;
+using namespace graph_tool;
+
+//
+// Dictionary-encoded string properties
+// ====================================
+//
+// An interned string property map is an int32_t property map which holds, for
+// each key, the position of its value in a list of strings which is shared
+// between the property maps (and kept on the python side). The functions below
+// convert between this and the regular string representation. They operate
+// directly on the underlying storage, so all indexes are converted, regardless
+// of filtering.
+
+template <class IndexMap>
+void intern_strings(boost::any aprop, boost::any acodes, python::list strings)
+{
+    typedef typename property_map_type::apply<string, IndexMap>::type
+        prop_t;
+    typedef typename property_map_type::apply<int32_t, IndexMap>::type
+        codes_t;
+
+    prop_t prop = any_cast<prop_t>(aprop);
+    codes_t codes = any_cast<codes_t>(acodes);
+
+    tr1::unordered_map<string, int32_t> dict;
+    size_t M = python::len(strings);
+    for (size_t i = 0; i < M; ++i)
+        dict[python::extract<string>(strings[i])] = i;
+
+    vector<string>& vals = prop.get_storage();
+    codes.reserve(vals.size());
+    vector<int32_t>& cvals = codes.get_storage();
+    for (size_t i = 0; i < vals.size(); ++i)
+    {
+        typeof(dict.begin()) iter = dict.find(vals[i]);
+        if (iter == dict.end())
+        {
+            if (dict.size() >= size_t(numeric_limits<int32_t>::max()))
+                throw ValueException("too many distinct strings to intern");
+            iter = dict.insert(make_pair(vals[i], int32_t(dict.size()))).first;
+            strings.append(vals[i]);
+        }
+        cvals[i] = iter->second;
+    }
+}
+
+template <class IndexMap>
+void unintern_strings(boost::any acodes, python::list strings,
+                      boost::any aprop)
+{
+    typedef typename property_map_type::apply<string, IndexMap>::type
+        prop_t;
+    typedef typename property_map_type::apply<int32_t, IndexMap>::type
+        codes_t;
+
+    codes_t codes = any_cast<codes_t>(acodes);
+    prop_t prop = any_cast<prop_t>(aprop);
+
+    vector<string> dict(python::len(strings));
+    for (size_t i = 0; i < dict.size(); ++i)
+        dict[i] = python::extract<string>(strings[i]);
+
+    vector<int32_t>& cvals = codes.get_storage();
+    for (size_t i = 0; i < cvals.size(); ++i)
+        if (cvals[i] < 0 || size_t(cvals[i]) >= dict.size())
+            throw ValueException("invalid string code: " +
+                                 lexical_cast<string>(cvals[i]));
+
+    prop.reserve(cvals.size());
+    vector<string>& vals = prop.get_storage();
+
+    int i, N = cvals.size();
+    #pragma omp parallel for default(shared) private(i) schedule(static) \
+        if (N > 1000)
+    for (i = 0; i < N; ++i)
+        vals[i] = dict[cvals[i]];
+}
+
+void intern_string_property(GraphInterface&, boost::any prop,
+                            boost::any codes, python::list strings, bool edge)
+{
+    try
+    {
+        if (edge)
+            intern_strings<GraphInterface::edge_index_map_t>(prop, codes,
+                                                             strings);
+        else
+            intern_strings<GraphInterface::vertex_index_map_t>(prop, codes,
+                                                               strings);
+    }
+    catch (bad_any_cast&)
+    {
+        throw ValueException("invalid property maps for string interning");
+    }
+}
+
+void unintern_string_property(GraphInterface&, boost::any codes,
+                              python::list strings, boost::any prop,
+                              bool edge)
+{
+    try
+    {
+        if (edge)
+            unintern_strings<GraphInterface::edge_index_map_t>(codes, strings,
+                                                               prop);
+        else
+            unintern_strings<GraphInterface::vertex_index_map_t>(codes,
+                                                                 strings,
+                                                                 prop);
+    }
+    catch (bad_any_cast&)
+    {
+        throw ValueException("invalid property maps for string interning");
+    }
+}
@@ -126,17 +126,25 @@ python::object get_edges(python::object g)
     return iter;
 }
 
+struct add_new_vertices
+{
+    template <class Graph>
+    void operator()(Graph& g, size_t n, size_t& v) const
+    {
+        for (size_t i = 0; i < n; ++i)
+            v = add_vertex(g);
+    }
+};
+
 python::object add_vertex(python::object g, size_t n)
 {
     GraphInterface& gi = python::extract<GraphInterface&>(g().attr("_Graph__graph"));
 
+    size_t v = 0;
+    gi.RunOnGraph(bind<void>(add_new_vertices(), _1, n, ref(v)));
     if (n > 1)
-    {
-        for (size_t i = 0; i < n; ++i)
-            add_vertex(gi.GetGraph());
         return python::object();
-    }
-    return python::object(PythonVertex(g, add_vertex(gi.GetGraph())));
+    return python::object(PythonVertex(g, v));
 }
 
 struct shift_vertex_property
@@ -155,6 +163,18 @@ struct shift_vertex_property
     }
 };
 
+struct do_remove_vertex
+{
+    template <class Graph>
+    void operator()(Graph& g, size_t v, bool fast) const
+    {
+        if (fast)
+            remove_vertex_fast(v, g);
+        else
+            remove_vertex(v, g);
+    }
+};
+
 void remove_vertex(GraphInterface& gi, const python::object& v, bool fast)
 {
     PythonVertex& pv = python::extract<PythonVertex&>(v);
@@ -162,10 +182,7 @@ void remove_vertex(GraphInterface& gi, const python::object& v, bool fast)
     GraphInterface::vertex_t dv = pv.GetDescriptor();
     pv.SetValid(false);
 
-    if (fast)
-        remove_vertex_fast(dv, gi.GetGraph());
-    else
-        remove_vertex(dv, gi.GetGraph());
+    gi.RunOnGraph(bind<void>(do_remove_vertex(), _1, dv, fast));
 }
 
 struct add_new_edge
@@ -195,6 +212,156 @@ python::object add_edge(python::object g, const python::object& s,
     return new_e;
 }
 
+struct get_edge_st
+{
+    template <class Graph>
+    void operator()(Graph& g, python::object& pg, const PythonVertex& s,
+                    const PythonVertex& t, python::object& ret) const
+    {
+        typename graph_traits<Graph>::edge_descriptor e;
+        bool found;
+        tie(e, found) = edge(s.GetDescriptor(), t.GetDescriptor(), g);
+        if (found)
+            ret = python::object(PythonEdge<Graph>(pg, e));
+    }
+};
+
+// returns an edge from s to t, or None if it does not exist. This is O(1)
+// expected if the edge index is enabled, otherwise O(k(s)).
+python::object get_edge(python::object g, const python::object& s,
+                        const python::object& t)
+{
+    PythonVertex& src = python::extract<PythonVertex&>(s);
+    PythonVertex& tgt = python::extract<PythonVertex&>(t);
+    src.CheckValid();
+    tgt.CheckValid();
+    GraphInterface& gi = python::extract<GraphInterface&>(g().attr("_Graph__graph"));
+    python::object e;
+    run_action<>()(gi, bind<void>(get_edge_st(), _1, ref(g), src, tgt,
+                                  ref(e)))();
+    return e;
+}
+
+// bulk insertion of edges from a (E, 2 + k) numpy array, where the first two
+// columns are the source and target vertex indexes, and the remaining k
+// columns contain the values of k edge property maps
+struct add_edge_list
+{
+    template <class ValueType>
+    void operator()(ValueType, GraphInterface& gi, python::object& aedge_list,
+                    vector<boost::any>& eprops, boost::any& efilt,
+                    bool efilt_val, bool grow, bool& found) const
+    {
+        if (found)
+            return;
+        try
+        {
+            multi_array_ref<ValueType, 2> edge_list =
+                get_array<ValueType, 2>(aedge_list);
+            found = true;
+            gi.RunOnGraph(bind<void>(add_edge_list(), _1, ref(edge_list),
+                                     ref(eprops), ref(efilt), efilt_val,
+                                     grow));
+        }
+        catch (invalid_numpy_conversion&) {}
+    }
+
+    template <class ValueType>
+    size_t get_vertex(ValueType v) const
+    {
+        if (v < 0)
+            throw ValueException("invalid vertex index in edge list: " +
+                                 lexical_cast<string>(v));
+        return size_t(v);
+    }
+
+    template <class Graph, class ValueType>
+    void operator()(Graph& g, multi_array_ref<ValueType, 2>& edge_list,
+                    vector<boost::any>& aeprops, boost::any& aefilt,
+                    bool efilt_val, bool grow) const
+    {
+        typedef DynamicPropertyMapWrap<ValueType, GraphInterface::edge_t>
+            eprop_t;
+        typedef DynamicPropertyMapWrap<uint8_t, GraphInterface::edge_t>
+            efilt_t;
+
+        if (edge_list.shape()[1] < 2)
+            throw ValueException("edge list must have at least two columns");
+        if (edge_list.shape()[1] - 2 < aeprops.size())
+            throw ValueException("edge list has fewer columns than the number"
+                                 " of given edge property maps");
+
+        vector<eprop_t> eprops;
+        for (size_t j = 0; j < aeprops.size(); ++j)
+            eprops.push_back(eprop_t(aeprops[j],
+                                     writable_edge_scalar_properties()));
+        efilt_t efilt;
+        if (!aefilt.empty())
+            efilt = efilt_t(aefilt, writable_edge_scalar_properties());
+
+        size_t E = edge_list.shape()[0];
+        size_t N = num_vertices(g);
+
+        // count the new degrees, so that the edge lists need to be allocated
+        // only once
+        vector<size_t> k_out(N), k_in(N);
+        for (size_t i = 0; i < E; ++i)
+        {
+            size_t s = get_vertex(edge_list[i][0]);
+            size_t t = get_vertex(edge_list[i][1]);
+            size_t u = max(s, t);
+            if (u >= k_out.size())
+            {
+                if (!grow)
+                    throw ValueException("vertex index in edge list is larger"
+                                         " than the number of vertices: " +
+                                         lexical_cast<string>(u));
+                k_out.resize(u + 1);
+                k_in.resize(u + 1);
+            }
+            k_out[s]++;
+            k_in[t]++;
+        }
+
+        while (num_vertices(g) < k_out.size())
+            add_vertex(g);
+
+        for (size_t v = 0; v < k_out.size(); ++v)
+            g.reserve_edges(v, k_out[v], k_in[v]);
+
+        for (size_t i = 0; i < E; ++i)
+        {
+            size_t s = get_vertex(edge_list[i][0]);
+            size_t t = get_vertex(edge_list[i][1]);
+            GraphInterface::edge_t e = add_edge(s, t, g).first;
+            for (size_t j = 0; j < eprops.size(); ++j)
+                put(eprops[j], e, edge_list[i][j + 2]);
+            if (!aefilt.empty())
+                put(efilt, e, uint8_t(efilt_val));
+        }
+    }
+};
+
+void do_add_edge_list(GraphInterface& gi, python::object aedge_list,
+                      python::object oeprops, boost::any efilt, bool efilt_val,
+                      bool grow)
+{
+    typedef mpl::vector<int32_t, int64_t, uint64_t, double> vals_t;
+
+    vector<boost::any> eprops;
+    for (int i = 0; i < python::len(oeprops); ++i)
+        eprops.push_back(python::extract<boost::any>(oeprops[i])());
+
+    bool found = false;
+    mpl::for_each<vals_t>(bind<void>(add_edge_list(), _1, ref(gi),
+                                     ref(aedge_list), ref(eprops), ref(efilt),
+                                     efilt_val, grow, ref(found)));
+    if (!found)
+        throw ValueException("invalid type for edge list; must be a "
+                             "two-dimensional array of int32, int64, uint64 "
+                             "or double values");
+}
+
 struct get_edge_descriptor
 {
     template <class Graph>
@@ -217,15 +384,24 @@ struct get_edge_descriptor
     }
 };
 
+struct do_remove_edge
+{
+    template <class Graph>
+    void operator()(Graph& g, const GraphInterface::edge_t& e) const
+    {
+        remove_edge(e, g);
+    }
+};
+
 void remove_edge(GraphInterface& gi, const python::object& e)
 {
     GraphInterface::edge_t de;
     bool found = false;
     run_action<>()(gi, bind<void>(get_edge_descriptor(), _1, ref(e), ref(de),
                                   ref(found)))();
-    remove_edge(de, gi.GetGraph());
     if (!found)
         throw ValueException("invalid edge descriptor");
+    gi.RunOnGraph(bind<void>(do_remove_edge(), _1, de));
 }
 
 struct get_degree_map
@@ -420,12 +596,22 @@ void export_python_interface()
     def("new_edge_property", &new_property<GraphInterface::edge_index_map_t>);
     def("new_graph_property",
         &new_property<ConstantPropertyMap<size_t,graph_property_tag> >);
+    def("new_sparse_vertex_property",
+        &new_sparse_property<GraphInterface::vertex_index_map_t>);
+    def("new_sparse_edge_property",
+        &new_sparse_property<GraphInterface::edge_index_map_t>);
+    def("new_mapped_vertex_property",
+        &new_mapped_property<GraphInterface::vertex_index_map_t>);
+    def("new_mapped_edge_property",
+        &new_mapped_property<GraphInterface::edge_index_map_t>);
 
     def("get_vertex", get_vertex);
     def("get_vertices", get_vertices);
     def("get_edges", get_edges);
     def("add_vertex", graph_tool::add_vertex);
     def("add_edge", graph_tool::add_edge);
+    def("add_edge_list", graph_tool::do_add_edge_list);
+    def("get_edge", graph_tool::get_edge);
     def("remove_vertex", graph_tool::remove_vertex);
     def("remove_edge", graph_tool::remove_edge);
 
@@ -36,6 +36,7 @@ namespace boost
 #include "graph_filtering.hh"
 #include "graph_selectors.hh"
 #include "numpy_bind.hh"
+#include "ragged_array.hh"
 
 
 // this file includes a simple python interface for the internally kept
@@ -94,7 +95,7 @@ public:
         GraphInterface& gi = python::extract<GraphInterface&>(_g().attr("_Graph__graph"));
         return _valid &&
             (_v != graph_traits<GraphInterface::multigraph_t>::null_vertex()) &&
-            (_v < num_vertices(*gi._mg));
+            (_v < gi.GetTotalNumberOfVertices());
     }
 
     void SetValid(bool valid)
@@ -477,8 +478,11 @@ public:
                            GraphInterface::vertex_index_map_t>,
                    is_same<PropertyMap,
                            GraphInterface::edge_index_map_t> >::type,
-              typename mpl::not_<
-                  typename mpl::has_key<numpy_types, value_type>::type >
+              typename mpl::or_<
+                  typename mpl::not_<
+                      typename mpl::has_key<numpy_types, value_type>::type >
+                  ::type,
+                  is_sparse_property_map<PropertyMap> >::type
             ::type>::type isnt_vector_map;
         return get_array(_pmap, size, isnt_vector_map());
     }
@@ -486,7 +490,20 @@ public:
     python::object get_array(PropertyMap pmap, size_t size, mpl::bool_<false>)
     {
         _pmap.reserve(size);
-        return wrap_vector_not_owned(_pmap.get_storage());
+        return wrap_storage(_pmap.get_storage());
+    }
+
+    template <class ValueType>
+    static python::object wrap_storage(vector<ValueType>& store)
+    {
+        return wrap_vector_not_owned(store);
+    }
+
+    // the array of memory-mapped maps refers directly to the mapped file
+    template <class ValueType>
+    static python::object wrap_storage(mapped_storage<ValueType>& store)
+    {
+        return wrap_array_not_owned(store.begin(), store.size());
     }
 
     python::object get_array(PropertyMap pmap, size_t size, mpl::bool_<true>)
@@ -494,12 +511,89 @@ public:
         return python::object();
     }
 
+    // Returns the values of the first 'size' entries of a vector-valued map
+    // packed in a contiguous numpy array, together with the row offsets, as
+    // described in ragged_array.hh. If all vectors have the same length, the
+    // values are returned as a two-dimensional array and the offsets as None.
+    // For other value types, None is returned.
+    python::object GetPacked(size_t size)
+    {
+        return get_packed(size, (value_type*) 0);
+    }
+
+    template <class ValueType>
+    python::object get_packed(size_t size, ValueType*)
+    {
+        return python::object();
+    }
+
+    python::object get_packed(size_t size, vector<string>*)
+    {
+        return python::object();
+    }
+
+    template <class ValueType>
+    python::object get_packed(size_t size, vector<ValueType>*)
+    {
+        _pmap.reserve(size);
+        vector<vector<ValueType> >& rows = _pmap.get_storage();
+
+        vector<size_t> offsets;
+        size_t width;
+        size_t n = ragged_layout(rows, size, offsets, width);
+
+        int ndim = offsets.empty() ? 2 : 1;
+        npy_intp shape[2];
+        shape[0] = offsets.empty() ? size : n;
+        shape[1] = width;
+        int val_type = mpl::at<numpy_types,ValueType>::type::value;
+        PyArrayObject* ndarray =
+            (PyArrayObject*) PyArray_SimpleNew(ndim, shape, val_type);
+        ragged_copy(rows, size, offsets, width,
+                    (ValueType*) PyArray_DATA(ndarray));
+        handle<> x((PyObject*) ndarray);
+        python::object values(x);
+
+        if (offsets.empty())
+            return python::make_tuple(values, python::object());
+        return python::make_tuple(values, wrap_vector_owned(offsets));
+    }
+
     bool IsWritable() const
     {
         return is_convertible<typename property_traits<PropertyMap>::category,
                               writable_property_map_tag>::value;
     }
 
+    bool IsSparse() const
+    {
+        return is_sparse_property_map<PropertyMap>::value;
+    }
+
+    bool IsMapped() const
+    {
+        return is_mapped_property_map<PropertyMap>::value;
+    }
+
+    // the default value of sparse maps, or None otherwise
+    python::object GetDefault() const
+    {
+        return get_default(_pmap);
+    }
+
+    template <class PMap>
+    static python::object get_default(const PMap&)
+    {
+        return python::object();
+    }
+
+    template <class Type, class Index>
+    static python::object
+    get_default(const sparse_property_map<Type, Index>& pmap)
+    {
+        return python::object(pmap.get_default());
+    }
+
 private:
     PropertyMap _pmap; // hold an internal copy, since it's cheap
 };
@@ -545,6 +639,81 @@ python::object new_property(const string& type, IndexMap index_map,
     return prop;
 }
 
+struct new_sparse_property_map
+{
+    template <class ValueType, class IndexMap>
+    void operator()(ValueType, IndexMap index, const string& type_name,
+                    python::object val, python::object& new_prop,
+                    bool& found) const
+    {
+        size_t i = mpl::find<value_types,ValueType>::type::pos::value;
+        if (type_name == type_names[i])
+        {
+            typedef typename sparse_property_map_type::apply<ValueType,
+                                                             IndexMap>::type
+                map_t;
+            ValueType def = ValueType();
+            if (val.ptr() != Py_None)
+                def = python::extract<ValueType>(val);
+            new_prop = python::object(PythonPropertyMap<map_t>(map_t(index,
+                                                                     def)));
+            found = true;
+        }
+    }
+};
+
+// creates a sparse property map with the given default value (None means the
+// default-constructed value); only scalar value types are supported
+template <class IndexMap>
+python::object new_sparse_property(const string& type, IndexMap index_map,
+                                   python::object val)
+{
+    python::object prop;
+    bool found = false;
+    mpl::for_each<scalar_types>(bind<void>(new_sparse_property_map(), _1,
+                                           index_map, ref(type), val,
+                                           ref(prop), ref(found)));
+    if (!found)
+        throw ValueException("Invalid sparse property type: " + type);
+    return prop;
+}
+
+struct new_mapped_property_map
+{
+    template <class ValueType, class IndexMap>
+    void operator()(ValueType, IndexMap index, const string& type_name,
+                    const string& path, python::object& new_prop,
+                    bool& found) const
+    {
+        size_t i = mpl::find<value_types,ValueType>::type::pos::value;
+        if (type_name == type_names[i])
+        {
+            typedef typename mapped_property_map_type::apply<ValueType,
+                                                             IndexMap>::type
+                map_t;
+            new_prop = python::object(PythonPropertyMap<map_t>(map_t(path,
+                                                                     index)));
+            found = true;
+        }
+    }
+};
+
+// creates a property map stored in the memory-mapped file 'path', which is
+// created if it does not exist; only scalar value types are supported
+template <class IndexMap>
+python::object new_mapped_property(const string& type, IndexMap index_map,
+                                   const string& path)
+{
+    python::object prop;
+    bool found = false;
+    mpl::for_each<scalar_types>(bind<void>(new_mapped_property_map(), _1,
+                                           index_map, ref(type), ref(path),
+                                           ref(prop), ref(found)));
+    if (!found)
+        throw ValueException("Invalid memory-mapped property type: " + type);
+    return prop;
+}
+
 } //graph_tool namespace
 
 #endif
@@ -48,6 +48,10 @@ struct export_vertex_property_map
                 type_names[mpl::find<value_types,typename pmap_t::value_type>
                            ::type::pos::value];
         string class_name = "VertexPropertyMap<" + type_name + ">";
+        if (is_sparse_property_map<PropertyMap>::value)
+            class_name = "Sparse" + class_name;
+        if (is_mapped_property_map<PropertyMap>::value)
+            class_name = "Mapped" + class_name;
 
         typedef typename mpl::if_<
             typename return_reference::apply<typename pmap_t::value_type>::type,
@@ -65,7 +69,11 @@ struct export_vertex_property_map
             .def("get_map", &pmap_t::GetMap)
             .def("get_dynamic_map", &pmap_t::GetDynamicMap)
             .def("get_array", &pmap_t::GetArray)
-            .def("is_writable", &pmap_t::IsWritable);
+            .def("get_packed", &pmap_t::GetPacked)
+            .def("is_writable", &pmap_t::IsWritable)
+            .def("is_sparse", &pmap_t::IsSparse)
+            .def("is_mapped", &pmap_t::IsMapped)
+            .def("get_default", &pmap_t::GetDefault);
     }
 };
 
@@ -117,6 +125,10 @@ struct export_edge_property_map
                 type_names[mpl::find<value_types,typename pmap_t::value_type>
                            ::type::pos::value];
         string class_name = "EdgePropertyMap<" + type_name + ">";
+        if (is_sparse_property_map<PropertyMap>::value)
+            class_name = "Sparse" + class_name;
+        if (is_mapped_property_map<PropertyMap>::value)
+            class_name = "Mapped" + class_name;
 
         python::class_<pmap_t> pclass(class_name.c_str(),
                                       python::no_init);
@@ -125,7 +137,11 @@ struct export_edge_property_map
             .def("get_map", &pmap_t::GetMap)
             .def("get_dynamic_map", &pmap_t::GetDynamicMap)
             .def("get_array", &pmap_t::GetArray)
-            .def("is_writable", &pmap_t::IsWritable);
+            .def("get_packed", &pmap_t::GetPacked)
+            .def("is_writable", &pmap_t::IsWritable)
+            .def("is_sparse", &pmap_t::IsSparse)
+            .def("is_mapped", &pmap_t::IsMapped)
+            .def("get_default", &pmap_t::GetDefault);
 
 
         typedef mpl::transform<graph_tool::detail::all_graph_views,
@@ -163,7 +179,10 @@ struct export_graph_property_map
             .def("get_map", &pmap_t::GetMap)
             .def("get_dynamic_map", &pmap_t::GetDynamicMap)
             .def("get_array", &pmap_t::GetArray)
-            .def("is_writable", &pmap_t::IsWritable);
+            .def("is_writable", &pmap_t::IsWritable)
+            .def("is_sparse", &pmap_t::IsSparse)
+            .def("is_mapped", &pmap_t::IsMapped)
+            .def("get_default", &pmap_t::GetDefault);
     }
 };
 
@@ -186,6 +205,12 @@ void export_python_properties()
         >::type graph_property_maps;
 
     mpl::for_each<vertex_property_maps>(export_vertex_property_map());
+    mpl::for_each<vertex_sparse_scalar_properties>
+        (export_vertex_property_map());
     mpl::for_each<edge_property_maps>(export_edge_property_map());
+    mpl::for_each<vertex_mapped_scalar_properties>
+        (export_vertex_property_map());
+    mpl::for_each<edge_sparse_scalar_properties>(export_edge_property_map());
+    mpl::for_each<edge_mapped_scalar_properties>(export_edge_property_map());
     mpl::for_each<graph_property_maps>(export_graph_property_map());
 }
@@ -0,0 +1,145 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2013 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_REORDER_HH
+#define GRAPH_REORDER_HH
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "graph_exceptions.hh"
+
+namespace graph_tool
+{
+using namespace std;
+using namespace boost;
+
+// orders vertices by their total (in + out) degree
+template <class Graph>
+struct total_degree_cmp
+{
+    total_degree_cmp(const Graph& g, bool ascending)
+        : g(g), ascending(ascending) {}
+    const Graph& g;
+    bool ascending;
+
+    bool operator()(size_t u, size_t v) const
+    {
+        size_t ku = out_degree(u, g) + in_degree(u, g);
+        size_t kv = out_degree(v, g) + in_degree(v, g);
+        return ascending ? ku < kv : ku > kv;
+    }
+};
+
+// Computes a vertex ordering of an adj_list which improves the memory locality
+// of traversals, given as order[v] = new index of v. The edge directions are
+// ignored. The methods are:
+//
+//   "bfs":    breadth-first search order, starting from the lowest vertex of
+//             each component
+//   "rcm":    reverse Cuthill-McKee order; the search starts from a vertex of
+//             minimum degree in each component, and neighbours are visited in
+//             order of increasing degree, which minimizes the bandwidth of the
+//             adjacency matrix
+//   "degree": vertices sorted by decreasing degree, so that the hubs, which
+//             are the most often visited, are stored together
+
+struct get_locality_order
+{
+    template <class Graph>
+    void operator()(const Graph& g, const string& method,
+                    vector<size_t>& order) const
+    {
+        size_t N = num_vertices(g);
+        vector<size_t> seq;  // vertices in their new order
+        seq.reserve(N);
+
+        if (method == "degree")
+        {
+            for (size_t v = 0; v < N; ++v)
+                seq.push_back(v);
+            stable_sort(seq.begin(), seq.end(),
+                        total_degree_cmp<Graph>(g, false));
+        }
+        else if (method == "bfs" || method == "rcm")
+        {
+            bool rcm = (method == "rcm");
+            total_degree_cmp<Graph> cmp(g, true);
+
+            vector<size_t> roots;
+            roots.reserve(N);
+            for (size_t v = 0; v < N; ++v)
+                roots.push_back(v);
+            if (rcm)
+                stable_sort(roots.begin(), roots.end(), cmp);
+
+            vector<bool> visited(N, false);
+            for (size_t r = 0; r < N; ++r)
+            {
+                size_t root = roots[r];
+                if (visited[root])
+                    continue;
+                visited[root] = true;
+                seq.push_back(root);
+                for (size_t head = seq.size() - 1; head < seq.size(); ++head)
+                {
+                    size_t v = seq[head];
+                    size_t first = seq.size();
+
+                    typename graph_traits<Graph>::out_edge_iterator e, e_end;
+                    for (tie(e, e_end) = out_edges(v, g); e != e_end; ++e)
+                    {
+                        size_t u = target(*e, g);
+                        if (!visited[u])
+                        {
+                            visited[u] = true;
+                            seq.push_back(u);
+                        }
+                    }
+                    typename graph_traits<Graph>::in_edge_iterator ie, ie_end;
+                    for (tie(ie, ie_end) = in_edges(v, g); ie != ie_end; ++ie)
+                    {
+                        size_t u = source(*ie, g);
+                        if (!visited[u])
+                        {
+                            visited[u] = true;
+                            seq.push_back(u);
+                        }
+                    }
+
+                    if (rcm)
+                        stable_sort(seq.begin() + first, seq.end(), cmp);
+                }
+            }
+            if (rcm)
+                reverse(seq.begin(), seq.end());
+        }
+        else
+        {
+            throw ValueException("invalid vertex ordering method: " + method);
+        }
+
+        order.resize(N);
+        for (size_t i = 0; i < N; ++i)
+            order[seq[i]] = i;
+    }
+};
+
+} // graph_tool namespace
+
+#endif // GRAPH_REORDER_HH
@@ -42,6 +42,9 @@ boost::any graph_tool::degree_selector(GraphInterface::deg_t deg)
         mpl::for_each<vertex_properties>
             (bind<void>(get_scalar_selector(), _1, *d, ref(sel),
                         ref(found)));
+        mpl::for_each<vertex_mapped_scalar_properties>
+            (bind<void>(get_scalar_selector(), _1, *d, ref(sel),
+                        ref(found)));
         if (!found)
             throw ValueException("invalid degree selector");
     }
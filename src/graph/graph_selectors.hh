@@ -26,6 +26,7 @@
 #include <boost/mpl/find.hpp>
 #include <boost/mpl/not.hpp>
 #include <boost/mpl/logical.hpp>
+#include <boost/mpl/joint_view.hpp>
 
 #include "graph_adaptor.hh"
 #include "graph_properties.hh"
@@ -507,6 +508,33 @@ typedef property_map_types::apply<floating_vector_types,
                                   mpl::bool_<false> >::type
     edge_floating_vector_properties;
 
+// sparse property maps are available only for scalar types, and must be
+// explicitly included in the dispatch of the functions which accept them
+typedef property_map_types::apply<scalar_types,
+                                  GraphInterface::vertex_index_map_t,
+                                  mpl::bool_<false>,
+                                  sparse_property_map_type>::type
+    vertex_sparse_scalar_properties;
+
+typedef property_map_types::apply<scalar_types,
+                                  GraphInterface::edge_index_map_t,
+                                  mpl::bool_<false>,
+                                  sparse_property_map_type>::type
+    edge_sparse_scalar_properties;
+
+// the same holds for memory-mapped property maps
+typedef property_map_types::apply<scalar_types,
+                                  GraphInterface::vertex_index_map_t,
+                                  mpl::bool_<false>,
+                                  mapped_property_map_type>::type
+    vertex_mapped_scalar_properties;
+
+typedef property_map_types::apply<scalar_types,
+                                  GraphInterface::edge_index_map_t,
+                                  mpl::bool_<false>,
+                                  mapped_property_map_type>::type
+    edge_mapped_scalar_properties;
+
 struct vertex_scalar_selectors:
     mpl::transform<vertex_scalar_properties,
                    scalar_selector_type>::type {};
@@ -521,6 +549,18 @@ struct scalar_selectors:
                    scalar_selector_type,
                    mpl::back_inserter<degree_selectors> >::type {};
 
+struct mapped_scalar_selectors:
+    mpl::transform<vertex_mapped_scalar_properties,
+                   scalar_selector_type>::type {};
+
+// the regular scalar selectors and properties, together with the
+// memory-mapped ones
+struct mapped_and_scalar_selectors:
+    mpl::joint_view<scalar_selectors, mapped_scalar_selectors> {};
+
+struct mapped_and_edge_scalar_properties:
+    mpl::joint_view<edge_scalar_properties, edge_mapped_scalar_properties> {};
+
 } //namespace graph_tool
 
 #endif
@@ -37,6 +37,9 @@
 #include "tr1_include.hh"
 #include TR1_HEADER(random)
 
+#include "graph_adjacency.hh"
+#include "graph_adaptor.hh"
+
 namespace graph_tool
 {
 using namespace boost;
@@ -119,6 +122,23 @@ bool is_adjacent(typename graph_traits<Graph>::vertex_descriptor u,
     return false;
 }
 
+// this is O(1) expected if the edge index of the adjacency list is enabled,
+// otherwise O(k(u))
+template <class Vertex, class Index>
+bool is_adjacent(Vertex u, Vertex v, const adj_list<Vertex, Index>& g)
+{
+    return edge(u, v, g).second;
+}
+
+template <class Graph>
+bool is_adjacent(typename graph_traits<UndirectedAdaptor<Graph> >::vertex_descriptor u,
+                 typename graph_traits<UndirectedAdaptor<Graph> >::vertex_descriptor v,
+                 const UndirectedAdaptor<Graph>& g)
+{
+    return (is_adjacent(u, v, g.OriginalGraph()) ||
+            is_adjacent(v, u, g.OriginalGraph()));
+}
+
 // computes the out-degree of a graph, ignoring self-edges
 template <class Graph>
 inline size_t
@@ -340,6 +360,14 @@ string lexical_cast<string,uint8_t>(const uint8_t& val);
 template <>
 uint8_t lexical_cast<uint8_t,string>(const string& val);
 template <>
+string lexical_cast<string,int8_t>(const int8_t& val);
+template <>
+int8_t lexical_cast<int8_t,string>(const string& val);
+template <>
+string lexical_cast<string,float>(const float& val);
+template <>
+float lexical_cast<float,string>(const string& val);
+template <>
 string lexical_cast<string,double>(const double& val);
 template <>
 double lexical_cast<double,string>(const string& val);
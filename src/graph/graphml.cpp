@@ -12,6 +12,9 @@
 #include <boost/python.hpp>
 #include <boost/variant.hpp>
 #include <expat.h>
+#include <cstring>
+#include <algorithm>
+#include <vector>
 #include <boost/graph/graphml.hpp>
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/archive/iterators/xml_escape.hpp>
@@ -31,38 +34,243 @@ std::string protect_xml_string(const std::string& os)
 }
 }
 
+//
+// Parallel parsing
+// ================
+//
+// The file is read in blocks. The <node> and <edge> elements of each block
+// (the "records") are split into chunks, at the beginning of records, which are
+// parsed in parallel, each with its own expat parser, into lists of records
+// whose property values are already converted. The records are then added to
+// the graph in the original order, exactly as they would have been by the
+// serial parser. Everything else (the header with the keys, and whatever comes
+// after the last record) is fed to the main parser, which simply skips over the
+// records which were parsed in parallel, since they are balanced elements. If
+// a chunk cannot be parsed in this way (because of a syntax error, or any
+// structure other than plain records with <data> elements), the rest of the
+// file is fed to the main parser, so that the result (and the error messages)
+// are always the same.
+
+// a position in the text, counted as expat does
+struct text_position
+{
+    text_position(): line(1), column(0) {}
+
+    XML_Size line;
+    XML_Size column;
+
+    void advance(const char* begin, const char* end)
+    {
+        for (const char* c = begin; c != end; ++c)
+        {
+            if (*c == '\n' || *c == '\r')
+            {
+                if (*c == '\r' && c + 1 != end && c[1] == '\n')
+                    ++c;
+                ++line;
+                column = 0;
+            }
+            else if ((*c & 0xC0) != 0x80) // UTF-8 continuation bytes
+            {
+                ++column;
+            }
+        }
+    }
+
+    // advances the position by the relative position delta, i.e. the
+    // position at the end of some text, counted from text_position()
+    void advance(const text_position& delta)
+    {
+        if (delta.line == 1)
+        {
+            column += delta.column;
+        }
+        else
+        {
+            line += delta.line - 1;
+            column = delta.column;
+        }
+    }
+
+    // the relative position with respect to base
+    text_position operator-(const text_position& base) const
+    {
+        text_position delta;
+        if (line == base.line)
+        {
+            delta.column = column - base.column;
+        }
+        else
+        {
+            delta.line = line - base.line + 1;
+            delta.column = column;
+        }
+        return delta;
+    }
+};
+
+struct graphml_data
+{
+    std::string key;
+    std::string value;
+    any converted;          // empty if the value was not converted
+    text_position pos;
+};
+
+struct graphml_record
+{
+    bool edge;
+    std::string id, source, target, directed;
+    bool has_directed;
+    text_position pos;
+    std::vector<graphml_data> data;
+};
+
+struct graphml_chunk
+{
+    const char* begin;
+    const char* end;
+    std::vector<graphml_record> records;
+    text_position size;     // relative position at the end of the chunk
+    bool failed;
+};
+
+class graphml_reader;
+
+struct graphml_chunk_parser
+{
+    const graphml_reader* reader;
+    graphml_chunk* chunk;
+    XML_Parser parser;
+    int depth;
+    std::string text;
+};
+
+struct graphml_probe
+{
+    XML_Parser parser;
+    XML_Index start;
+};
+
+// the chunks are parsed as the contents of this element
+const char graphml_chunk_begin[] = "<graphml_chunk>";
+const char graphml_chunk_end[] = "</graphml_chunk>";
+
+// the number of bytes read at a time, and the approximate size of each chunk
+const size_t graphml_block_size = 1 << 24;
+const size_t graphml_chunk_size = 1 << 20;
+
+// returns true if the text at pos starts a <node> or <edge> element
+bool is_record_start(const char* pos, const char* end)
+{
+    if (end - pos < 6 || (std::memcmp(pos, "<node", 5) != 0 &&
+                          std::memcmp(pos, "<edge", 5) != 0))
+        return false;
+    char c = pos[5];
+    return (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '/' ||
+            c == '>');
+}
+
 class graphml_reader
 {
 public:
     graphml_reader(mutate_graph& g, bool integer_vertices, bool store_ids)
         : m_g(g), m_canonical_vertices(false),
-          m_integer_vertices(integer_vertices), m_store_ids(store_ids) { }
+          m_integer_vertices(integer_vertices), m_store_ids(store_ids),
+          m_parallel(true), m_merging(false), m_skipped(false) { }
 
     void run(std::istream& in)
     {
-        const int buffer_size = 4096;
         m_parser = XML_ParserCreateNS(0,'|');
         XML_SetElementHandler(m_parser, &on_start_element, &on_end_element);
         XML_SetCharacterDataHandler(m_parser, &on_character_data);
         XML_SetUserData(m_parser, this);
-        char buffer[buffer_size];
 
-        bool okay = true;
-        do
+        graphml_probe probe;
+        probe.parser = XML_ParserCreateNS(0,'|');
+        probe.start = -1;
+        XML_SetStartElementHandler(probe.parser, &on_probe_start_element);
+        XML_SetUserData(probe.parser, &probe);
+
+        std::vector<char> buf;
+        std::vector<const char*> bounds;
+        std::vector<graphml_chunk> chunks;
+        bool header = true;
+        size_t offset = 0; // position of buf in the file
+        bool eof = false;
+        while (!eof)
         {
-            in.read(buffer, buffer_size);
-            okay = XML_Parse(m_parser, buffer, in.gcount(), in.gcount() == 0);
-        }
-        while (okay && in.good());
+            size_t n = buf.size();
+            buf.resize(n + graphml_block_size);
+            in.read(&buf[n], graphml_block_size);
+            buf.resize(n + in.gcount());
+            eof = !in.good();
+            if (buf.empty())
+                break;
+            const char* begin = &buf[0];
+            const char* end = begin + buf.size();
+            const char* pos = begin;
 
-        if (!okay)
-        {
-            std::stringstream s;
-            s << "on line " << XML_GetCurrentLineNumber(m_parser)
-              <<", column " << XML_GetCurrentColumnNumber(m_parser)
-              << ": " << XML_ErrorString(XML_GetErrorCode(m_parser));
-            throw parse_error(s.str());
+            if (header && m_parallel)
+            {
+                // the header is everything before the first record, which is
+                // found by an auxiliary parser
+                if (XML_Parse(probe.parser, begin + n, end - begin - n,
+                              false) == XML_STATUS_ERROR && probe.start < 0)
+                    m_parallel = false;
+                if (probe.start >= 0)
+                {
+                    pos = feed(begin, begin + (probe.start - offset));
+                    header = false;
+                }
+            }
+
+            if (!header && m_parallel)
+            {
+                find_chunks(pos, end, bounds);
+                if (bounds.size() > 1)
+                {
+                    chunks.resize(bounds.size() - 1);
+                    int i, N = chunks.size();
+                    #pragma omp parallel for default(shared) private(i) \
+                        schedule(dynamic) if (N > 1)
+                    for (i = 0; i < N; ++i)
+                    {
+                        chunks[i].begin = bounds[i];
+                        chunks[i].end = bounds[i + 1];
+                        parse_chunk(chunks[i]);
+                    }
+
+                    bool failed = false;
+                    for (size_t j = 0; j < chunks.size(); ++j)
+                        failed = failed || chunks[j].failed;
+                    if (failed)
+                    {
+                        m_parallel = false;
+                    }
+                    else
+                    {
+                        merge(chunks);
+                        pos = bounds.back();
+                    }
+                    chunks.clear();
+                }
+                else if (size_t(end - pos) > graphml_block_size)
+                {
+                    // no further records
+                    m_parallel = false;
+                }
+            }
+
+            // the rest is kept for the next block, unless it must be parsed
+            // serially
+            if (header || !m_parallel || eof)
+                pos = feed(pos, end);
+            offset += pos - begin;
+            buf.erase(buf.begin(), buf.begin() + (pos - begin));
         }
+        feed(0, 0, true);
+        XML_ParserFree(probe.parser);
         XML_ParserFree(m_parser);
     }
 
@@ -108,18 +316,7 @@ private:
                 else if (name == "source") source = value;
                 else if (name == "target") target = value;
                 else if (name == "directed")
-                {
-                    bool edge_is_directed = (value == "directed");
-                    if (self->m_g.is_directed() != 2 &&
-                        edge_is_directed != self->m_g.is_directed())
-                    {
-                        if (edge_is_directed)
-                            throw directed_graph_error();
-                        else
-                            throw undirected_graph_error();
-                    }
-                    self->m_g.flip_directed(edge_is_directed);
-                }
+                    self->handle_edge_directed(value);
             }
 
             self->m_active_descriptor = self->handle_edge(id, source, target);
@@ -177,11 +374,8 @@ private:
                     else
                     {
                         std::stringstream s;
-                        s << "on line "
-                          << XML_GetCurrentLineNumber(self->m_parser)
-                          << ", column "
-                          << XML_GetCurrentColumnNumber(self->m_parser)
-                          << ": unrecognized key kind '" << value << "'";
+                        s << self->position() << ": unrecognized key kind '"
+                          << value << "'";
                         throw parse_error(s.str());
                     }
                 }
@@ -267,6 +461,346 @@ private:
         self->m_character_data.append(s, len);
     }
 
+    // stops the auxiliary parser at the first record
+    static void
+    on_probe_start_element(void* user_data, const XML_Char *c_name,
+                           const XML_Char **)
+    {
+        graphml_probe* probe = static_cast<graphml_probe*>(user_data);
+        std::string name(c_name);
+        replace_first(name, "http://graphml.graphdrawing.org/xmlns|", "");
+        if (name == "node" || name == "edge")
+        {
+            probe->start = XML_GetCurrentByteIndex(probe->parser);
+            XML_StopParser(probe->parser, XML_FALSE);
+        }
+    }
+
+    // feeds the text to the main parser, and returns its end
+    const char* feed(const char* begin, const char* end, bool final = false)
+    {
+        if (XML_Parse(m_parser, begin, end - begin, final) ==
+            XML_STATUS_ERROR)
+        {
+            std::stringstream s;
+            s << position() << ": "
+              << XML_ErrorString(XML_GetErrorCode(m_parser));
+            throw parse_error(s.str());
+        }
+        if (m_parallel)
+        {
+            m_fed_pos.advance(begin, end);
+            m_real_pos.advance(begin, end);
+        }
+        return end;
+    }
+
+    // splits the records in [begin, end) into chunks, whose limits are put in
+    // bounds; the last record is not included, since it may be incomplete, or
+    // be followed by something else
+    void find_chunks(const char* begin, const char* end,
+                     std::vector<const char*>& bounds)
+    {
+        bounds.clear();
+        if (!is_record_start(begin, end))
+        {
+            m_parallel = false;
+            return;
+        }
+        bounds.push_back(begin);
+        const char* last = begin;
+        const char* pos = begin + 1;
+        while (true)
+        {
+            pos = static_cast<const char*>(std::memchr(pos, '<', end - pos));
+            if (pos == 0 || end - pos < 9)
+                break;
+            if (pos[1] == '!' || pos[1] == '?')
+            {
+                // comments, CDATA sections and processing instructions are
+                // skipped, since they may contain anything
+                const char* close = 0;
+                if (std::memcmp(pos, "<!--", 4) == 0)
+                    close = find(pos + 4, end, "-->");
+                else if (std::memcmp(pos, "<![CDATA[", 9) == 0)
+                    close = find(pos + 9, end, "]]>");
+                else if (pos[1] == '?')
+                    close = find(pos + 2, end, "?>");
+                else
+                    m_parallel = false; // e.g. a document type declaration
+                if (close == 0)
+                    break;
+                pos = close;
+                continue;
+            }
+            if (is_record_start(pos, end))
+            {
+                if (size_t(pos - bounds.back()) >= graphml_chunk_size)
+                    bounds.push_back(pos);
+                last = pos;
+            }
+            ++pos;
+        }
+        if (last != bounds.back())
+            bounds.push_back(last);
+    }
+
+    // parses the records of a chunk, which may be done concurrently
+    void parse_chunk(graphml_chunk& chunk) const
+    {
+        graphml_chunk_parser p;
+        p.reader = this;
+        p.chunk = &chunk;
+        p.parser = XML_ParserCreateNS(0,'|');
+        p.depth = 0;
+        XML_SetElementHandler(p.parser, &on_chunk_start_element,
+                              &on_chunk_end_element);
+        XML_SetCharacterDataHandler(p.parser, &on_chunk_character_data);
+        XML_SetUserData(p.parser, &p);
+
+        chunk.records.clear();
+        chunk.failed = false;
+        try
+        {
+            if (XML_Parse(p.parser, graphml_chunk_begin,
+                          sizeof(graphml_chunk_begin) - 1, false) ==
+                XML_STATUS_ERROR ||
+                XML_Parse(p.parser, chunk.begin, chunk.end - chunk.begin,
+                          false) == XML_STATUS_ERROR ||
+                XML_Parse(p.parser, graphml_chunk_end,
+                          sizeof(graphml_chunk_end) - 1, true) ==
+                XML_STATUS_ERROR)
+                chunk.failed = true;
+        }
+        catch (...)
+        {
+            // the chunk will be parsed again serially, which will report the
+            // error properly
+            chunk.failed = true;
+        }
+        XML_ParserFree(p.parser);
+        if (chunk.failed)
+        {
+            chunk.records.clear();
+            return;
+        }
+        chunk.size = text_position();
+        chunk.size.advance(chunk.begin, chunk.end);
+    }
+
+    // the position of the current event of a chunk parser, relative to the
+    // beginning of the chunk
+    static text_position chunk_position(graphml_chunk_parser& p)
+    {
+        text_position pos;
+        pos.line = XML_GetCurrentLineNumber(p.parser);
+        pos.column = XML_GetCurrentColumnNumber(p.parser);
+        if (pos.line == 1)
+            pos.column -= sizeof(graphml_chunk_begin) - 1;
+        return pos;
+    }
+
+    static void chunk_failed(graphml_chunk_parser& p)
+    {
+        p.chunk->failed = true;
+        XML_StopParser(p.parser, XML_FALSE);
+    }
+
+    // only <node> and <edge> elements are accepted at the top level, and
+    // only <data> elements (with a key) within them
+    static void
+    on_chunk_start_element(void* user_data, const XML_Char *c_name,
+                           const XML_Char **atts)
+    {
+        graphml_chunk_parser& p = *static_cast<graphml_chunk_parser*>(user_data);
+        std::string name(c_name);
+        replace_first(name, "http://graphml.graphdrawing.org/xmlns|", "");
+        p.depth++;
+        p.text.clear();
+
+        if (p.depth == 1)
+            return;
+        if (p.depth == 2 && (name == "node" || name == "edge"))
+        {
+            p.chunk->records.push_back(graphml_record());
+            graphml_record& r = p.chunk->records.back();
+            r.edge = (name == "edge");
+            r.has_directed = false;
+            r.pos = chunk_position(p);
+            while (*atts)
+            {
+                std::string name = *atts++;
+                std::string value = *atts++;
+
+                if (name == "id") r.id = value;
+                else if (r.edge && name == "source") r.source = value;
+                else if (r.edge && name == "target") r.target = value;
+                else if (r.edge && name == "directed")
+                {
+                    r.directed = value;
+                    r.has_directed = true;
+                }
+            }
+            return;
+        }
+        if (p.depth == 3 && name == "data")
+        {
+            graphml_record& r = p.chunk->records.back();
+            r.data.push_back(graphml_data());
+            while (*atts)
+            {
+                std::string name = *atts++;
+                std::string value = *atts++;
+
+                if (name == "key")
+                {
+                    r.data.back().key = value;
+                    return;
+                }
+            }
+        }
+        chunk_failed(p);
+    }
+
+    static void
+    on_chunk_end_element(void* user_data, const XML_Char*)
+    {
+        graphml_chunk_parser& p = *static_cast<graphml_chunk_parser*>(user_data);
+        if (p.depth == 3)
+        {
+            graphml_data& d = p.chunk->records.back().data.back();
+            d.value.swap(p.text);
+            d.pos = chunk_position(p);
+
+            const graphml_reader& self = *p.reader;
+            typeof(self.m_key_type.begin()) iter = self.m_key_type.find(d.key);
+            if (iter != self.m_key_type.end() &&
+                self.m_key_name.find(d.key) != self.m_key_name.end() &&
+                self.m_g.convert_value(d.value, iter->second, d.converted))
+                std::string().swap(d.value);
+        }
+        p.depth--;
+    }
+
+    static void
+    on_chunk_character_data(void* user_data, const XML_Char* s, int len)
+    {
+        graphml_chunk_parser& p = *static_cast<graphml_chunk_parser*>(user_data);
+        p.text.append(s, len);
+    }
+
+    // adds the records of the chunks to the graph, in order, as the main
+    // parser would have done
+    void merge(std::vector<graphml_chunk>& chunks)
+    {
+        m_merging = true;
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            std::vector<graphml_record>& records = chunks[i].records;
+            for (size_t j = 0; j < records.size(); ++j)
+            {
+                graphml_record& r = records[j];
+                m_position = m_real_pos;
+                m_position.advance(r.pos);
+                if (r.edge)
+                {
+                    if (r.has_directed)
+                        handle_edge_directed(r.directed);
+                    m_active_descriptor = handle_edge(r.id, r.source,
+                                                      r.target);
+                    m_descriptor_kind = M_EDGE_DESCRIPTOR;
+                }
+                else
+                {
+                    m_active_descriptor = handle_vertex(r.id);
+                    m_descriptor_kind = M_VERTEX_DESCRIPTOR;
+                }
+
+                for (size_t k = 0; k < r.data.size(); ++k)
+                {
+                    graphml_data& d = r.data[k];
+                    m_position = m_real_pos;
+                    m_position.advance(d.pos);
+                    m_active_key = d.key;
+                    if (d.converted.empty())
+                    {
+                        if (r.edge)
+                            handle_edge_property(d.key, m_active_descriptor,
+                                                 d.value);
+                        else
+                            handle_vertex_property(d.key, m_active_descriptor,
+                                                   d.value);
+                    }
+                    else
+                    {
+                        if (r.edge)
+                            m_g.put_edge_property(m_key_name[d.key],
+                                                  m_active_descriptor,
+                                                  d.converted);
+                        else
+                            m_g.put_vertex_property(m_key_name[d.key],
+                                                    m_active_descriptor,
+                                                    d.converted);
+                    }
+                }
+            }
+            m_real_pos.advance(chunks[i].size);
+        }
+        m_merging = false;
+
+        // the main parser skips the chunks, so its positions must now be
+        // corrected
+        m_skipped = true;
+        m_resume_fed_pos = m_fed_pos;
+        m_resume_real_pos = m_real_pos;
+    }
+
+    // the position of the current event, for error messages
+    std::string position()
+    {
+        text_position pos;
+        if (m_merging)
+        {
+            pos = m_position;
+        }
+        else
+        {
+            pos.line = XML_GetCurrentLineNumber(m_parser);
+            pos.column = XML_GetCurrentColumnNumber(m_parser);
+            if (m_skipped)
+            {
+                text_position delta = pos - m_resume_fed_pos;
+                pos = m_resume_real_pos;
+                pos.advance(delta);
+            }
+        }
+        std::stringstream s;
+        s << "on line " << pos.line << ", column " << pos.column;
+        return s.str();
+    }
+
+    void handle_edge_directed(const std::string& value)
+    {
+        bool edge_is_directed = (value == "directed");
+        if (m_g.is_directed() != 2 &&
+            edge_is_directed != m_g.is_directed())
+        {
+            if (edge_is_directed)
+                throw directed_graph_error();
+            else
+                throw undirected_graph_error();
+        }
+        m_g.flip_directed(edge_is_directed);
+    }
+
+    static const char* find(const char* begin, const char* end,
+                            const char* str)
+    {
+        size_t n = std::strlen(str);
+        const char* pos = std::search(begin, end, str, str + n);
+        return (pos == end) ? 0 : pos + n;
+    }
+
     any
     handle_vertex(const std::string& v)
     {
@@ -284,9 +818,7 @@ private:
             catch (bad_lexical_cast)
             {
                 std::stringstream s;
-                s << "on line " << XML_GetCurrentLineNumber(m_parser)
-                  << ", column " << XML_GetCurrentColumnNumber(m_parser)
-                  << ": invalid vertex: " << v;
+                s << position() << ": invalid vertex: " << v;
                 throw parse_error(s.str());
             }
 
@@ -390,9 +922,7 @@ private:
         catch (parse_error &e)
         {
             std::stringstream s;
-            s << "on line " << XML_GetCurrentLineNumber(m_parser)
-              << ", column " << XML_GetCurrentColumnNumber(m_parser)
-              << ": " << e.error;
+            s << position() << ": " << e.error;
             throw parse_error(s.str());
         }
     }
@@ -409,9 +939,7 @@ private:
         catch (parse_error &e)
         {
             std::stringstream s;
-            s << "on line " << XML_GetCurrentLineNumber(m_parser)
-              << ", column " << XML_GetCurrentColumnNumber(m_parser)
-              << ": " << e.error;
+            s << position() << ": " << e.error;
             throw parse_error(s.str());
         }
     }
@@ -428,9 +956,7 @@ private:
         catch (parse_error &e)
         {
             std::stringstream s;
-            s << "on line " << XML_GetCurrentLineNumber(m_parser)
-              << ", column " << XML_GetCurrentColumnNumber(m_parser)
-              << ": " << e.error;
+            s << position() << ": " << e.error;
             throw parse_error(s.str());
         }
     }
@@ -454,6 +980,18 @@ private:
     bool m_store_ids;
     bool m_ignore_directedness;
     XML_Parser m_parser;
+
+    // parallel parsing state: the positions in the text fed to the main
+    // parser, and in the actual file, of the text fed so far, and at the end
+    // of the last parallel chunks
+    bool m_parallel;
+    bool m_merging;
+    bool m_skipped;
+    text_position m_position;
+    text_position m_fed_pos;
+    text_position m_real_pos;
+    text_position m_resume_fed_pos;
+    text_position m_resume_real_pos;
 };
 
 namespace boost
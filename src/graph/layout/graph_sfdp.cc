@@ -61,21 +61,25 @@ void sfdp_layout(GraphInterface& g, boost::any pos, boost::any vweight,
     if(eweight.empty())
         eweight = eweight_map_t(1);
 
+    // the pin map is usually set for very few vertices, if any, so it may
+    // also be sparse
     typedef property_map_type::apply<uint8_t,
                                      GraphInterface::vertex_index_map_t>::type
         pin_map_t;
-    pin_map_t pin_map = any_cast<pin_map_t>(pin);
+    typedef sparse_property_map_type::apply<
+        uint8_t, GraphInterface::vertex_index_map_t>::type sparse_pin_map_t;
+    typedef mpl::vector<pin_map_t, sparse_pin_map_t> pin_props_t;
 
     run_action<graph_tool::detail::never_directed>()
         (g,
          bind<void>(get_sfdp_layout(C, K, p, theta, gamma, mu, mu_p, init_step,
                                     step_schedule, max_level, epsilon,
                                     max_iter, adaptive),
-                    _1, g.GetVertexIndex(), _2, _3, _4,
-                    pin_map.get_unchecked(num_vertices(g.GetGraph())),
-                    groups.get_unchecked(num_vertices(g.GetGraph())), verbose),
-         vertex_floating_vector_properties(), vertex_props_t(), edge_props_t())
-        (pos, vweight, eweight);
+                    _1, g.GetVertexIndex(), _2, _3, _4, _5,
+                    groups.get_unchecked(g.GetTotalNumberOfVertices()), verbose),
+         vertex_floating_vector_properties(), vertex_props_t(), edge_props_t(),
+         pin_props_t())
+        (pos, vweight, eweight, pin);
 }
 
 struct do_propagate_pos
@@ -0,0 +1,223 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2013 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef MAPPED_PROPERTY_MAP_HH
+#define MAPPED_PROPERTY_MAP_HH
+
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <cerrno>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/version.hpp>
+#if (BOOST_VERSION >= 104000)
+#   include <boost/property_map/property_map.hpp>
+#else
+#   include <boost/property_map.hpp>
+#endif
+#include <boost/shared_ptr.hpp>
+#include <boost/mpl/bool.hpp>
+
+#include "graph_exceptions.hh"
+
+namespace boost {
+
+// ========================================================================
+// mapped_vector_property_map<T, IndexMap>
+// ========================================================================
+//
+// This is a variant of checked_vector_property_map whose values are stored in a
+// memory-mapped file, instead of memory, so that they can exceed the available
+// RAM. The values are accessed in place, and are written back to the file by
+// the kernel, without any copy. When the map grows, the file is extended (with
+// zeros) and remapped, so references to the values are invalidated, as for
+// std::vector. If the file already exists, its contents are used as the initial
+// values, so the map can be reopened later.
+//
+// Only scalar (trivially copyable) value types are supported.
+
+template <class T>
+class mapped_storage
+{
+public:
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    mapped_storage(const std::string& path)
+        : _path(path), _data(0), _size(0), _capacity(0)
+    {
+        _fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (_fd < 0)
+            throw graph_tool::IOException("error opening file '" + path +
+                                          "': " + std::strerror(errno));
+        struct stat st;
+        if (::fstat(_fd, &st) != 0)
+        {
+            ::close(_fd);
+            throw graph_tool::IOException("error reading file '" + path +
+                                          "': " + std::strerror(errno));
+        }
+        _size = st.st_size / sizeof(T);
+        remap(_size);
+    }
+
+    ~mapped_storage()
+    {
+        if (_data != 0)
+            ::munmap(_data, _capacity * sizeof(T));
+        // the file may have been extended beyond the actual size
+        if (::ftruncate(_fd, _size * sizeof(T)) != 0) {}
+        ::close(_fd);
+    }
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    T* begin() { return _data; }
+    T* end() { return _data + _size; }
+    const T* begin() const { return _data; }
+    const T* end() const { return _data + _size; }
+
+    T& operator[](size_t i) { return _data[i]; }
+    const T& operator[](size_t i) const { return _data[i]; }
+
+    // new values are zero, since the file is extended with zeros
+    void resize(size_t n)
+    {
+        if (n > _capacity)
+            remap(std::max(n, 2 * _capacity));
+        _size = n;
+    }
+
+    // writes the modified pages back to the file
+    void sync()
+    {
+        if (_data != 0)
+            ::msync(_data, _capacity * sizeof(T), MS_SYNC);
+    }
+
+    const std::string& get_path() const { return _path; }
+
+private:
+    mapped_storage(const mapped_storage&);
+    mapped_storage& operator=(const mapped_storage&);
+
+    void remap(size_t capacity)
+    {
+        if (_data != 0)
+            ::munmap(_data, _capacity * sizeof(T));
+        _data = 0;
+        _capacity = 0;
+        if (capacity == 0)
+            return;
+        if (::ftruncate(_fd, capacity * sizeof(T)) != 0)
+            throw graph_tool::IOException("error resizing file '" + _path +
+                                          "': " + std::strerror(errno));
+        void* p = ::mmap(0, capacity * sizeof(T), PROT_READ | PROT_WRITE,
+                         MAP_SHARED, _fd, 0);
+        if (p == MAP_FAILED)
+            throw graph_tool::IOException("error mapping file '" + _path +
+                                          "': " + std::strerror(errno));
+        _data = static_cast<T*>(p);
+        _capacity = capacity;
+    }
+
+    std::string _path;
+    int _fd;
+    T* _data;
+    size_t _size;
+    size_t _capacity;
+};
+
+template <class T, class IndexMap>
+class mapped_vector_property_map
+    : public put_get_helper<T&, mapped_vector_property_map<T, IndexMap> >
+{
+public:
+    typedef typename property_traits<IndexMap>::key_type key_type;
+    typedef T value_type;
+    typedef T& reference;
+    typedef lvalue_property_map_tag category;
+
+    typedef IndexMap index_map_t;
+    typedef mapped_vector_property_map unchecked_t;
+    typedef mapped_vector_property_map checked_t;
+
+    mapped_vector_property_map(): _checked(true) {}
+    mapped_vector_property_map(const std::string& path,
+                               const IndexMap& idx = IndexMap())
+        : _store(new mapped_storage<T>(path)), _index(idx), _checked(true) {}
+
+    reference operator[](const key_type& k) const
+    {
+        size_t i = get(_index, k);
+        if (_checked && i >= _store->size())
+            reserve(i + 1);
+        return (*_store)[i];
+    }
+
+    void reserve(size_t size) const
+    {
+        #pragma omp critical
+        if (_store->size() < size)
+            _store->resize(size);
+    }
+
+    mapped_storage<T>& get_storage() const { return *_store; }
+
+    T* storage_begin() const { return _store->begin(); }
+    T* storage_end() const { return _store->end(); }
+
+    // the unchecked version is the same map, which does not grow on access
+    unchecked_t get_unchecked(size_t size = 0) const
+    {
+        reserve(size);
+        mapped_vector_property_map pmap = *this;
+        pmap._checked = false;
+        return pmap;
+    }
+
+    checked_t get_checked() const
+    {
+        mapped_vector_property_map pmap = *this;
+        pmap._checked = true;
+        return pmap;
+    }
+
+private:
+    shared_ptr<mapped_storage<T> > _store;
+    IndexMap _index;
+    bool _checked;
+};
+
+template <class PropertyMap>
+struct is_mapped_property_map: public mpl::false_ {};
+
+template <class T, class IndexMap>
+struct is_mapped_property_map<mapped_vector_property_map<T, IndexMap> >
+    : public mpl::true_ {};
+
+} // namespace boost
+
+#endif // MAPPED_PROPERTY_MAP_HH
@@ -47,12 +47,14 @@ using namespace boost::python;
 typedef mpl::map<
     mpl::pair<bool, mpl::int_<NPY_BOOL> >,
     mpl::pair<uint8_t, mpl::int_<NPY_BYTE> >,
+    mpl::pair<int8_t, mpl::int_<NPY_INT8> >,
     mpl::pair<uint32_t, mpl::int_<NPY_UINT32> >,
     mpl::pair<int16_t, mpl::int_<NPY_INT16> >,
     mpl::pair<int32_t, mpl::int_<NPY_INT32> >,
     mpl::pair<int64_t, mpl::int_<NPY_INT64> >,
     mpl::pair<uint64_t, mpl::int_<NPY_UINT64> >,
     mpl::pair<unsigned long int, mpl::int_<NPY_ULONG> >,
+    mpl::pair<float, mpl::int_<NPY_FLOAT> >,
     mpl::pair<double, mpl::int_<NPY_DOUBLE> >,
     mpl::pair<long double, mpl::int_<NPY_LONGDOUBLE> >
     > numpy_types;
@@ -100,6 +102,25 @@ python::object wrap_vector_not_owned(vector<ValueType>& vec)
     return o;
 }
 
+// the same as above, for an arbitrary contiguous buffer
+template <class ValueType>
+python::object wrap_array_not_owned(ValueType* data, size_t size)
+{
+    if (size == 0)
+    {
+        vector<ValueType> empty;
+        return wrap_vector_owned(empty);
+    }
+    int val_type = mpl::at<numpy_types,ValueType>::type::value;
+    npy_intp n = size;
+    PyArrayObject* ndarray =
+        (PyArrayObject*) PyArray_SimpleNewFromData(1, &n, val_type, data);
+    PyArray_ENABLEFLAGS(ndarray,NPY_ARRAY_ALIGNED | NPY_ARRAY_C_CONTIGUOUS |
+                        NPY_ARRAY_WRITEABLE);
+    handle<> x((PyObject*) ndarray);
+    object o(x);
+    return o;
+}
 
 template <class ValueType, int Dim>
 python::object wrap_multi_array_owned(multi_array<ValueType,Dim>& array)
@@ -0,0 +1,217 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2013 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef RAGGED_ARRAY_HH
+#define RAGGED_ARRAY_HH
+
+#include <vector>
+#include <algorithm>
+
+#include <boost/property_map/property_map.hpp>
+
+namespace graph_tool
+{
+using namespace std;
+using namespace boost;
+
+// ========================================================================
+// ragged_array<T>
+// ========================================================================
+//
+// ragged_array stores a sequence of rows of varying length, such as the values
+// of a vector<T> property map, in a single contiguous buffer. The row i spans
+// the values [offsets[i], offsets[i+1]). If all rows have the same length, the
+// offsets are not stored at all, and row i simply spans [i * width,
+// (i + 1) * width), i.e. the buffer is a row-major (N, width) matrix.
+//
+// The layout is computed and the values are copied with the free functions
+// ragged_layout() and ragged_copy(), which can also be used to fill an
+// externally allocated buffer (e.g. a numpy array).
+
+// a lightweight reference to a row of a ragged_array
+template <class T>
+class ragged_row
+{
+public:
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    ragged_row(): _begin(0), _end(0) {}
+    ragged_row(T* begin, T* end): _begin(begin), _end(end) {}
+
+    T* begin() const { return _begin; }
+    T* end() const { return _end; }
+    size_t size() const { return _end - _begin; }
+    bool empty() const { return _begin == _end; }
+    T& operator[](size_t i) const { return _begin[i]; }
+
+private:
+    T* _begin;
+    T* _end;
+};
+
+// Computes the layout of the first N rows of 'rows', which can be any indexed
+// sequence of vectors, such as the storage of a vector-valued
+// checked_vector_property_map. If all rows have the same size, 'offsets' is
+// left empty and 'width' is set to this size; otherwise 'offsets' will contain
+// N + 1 entries. The total number of values is returned.
+template <class Rows>
+size_t ragged_layout(const Rows& rows, size_t N, vector<size_t>& offsets,
+                     size_t& width)
+{
+    offsets.clear();
+    width = (N > 0) ? rows[0].size() : 0;
+    size_t i;
+    for (i = 1; i < N; ++i)
+        if (rows[i].size() != width)
+            break;
+    if (i == N)
+        return N * width;
+
+    offsets.resize(N + 1);
+    offsets[0] = 0;
+    for (i = 0; i < N; ++i)
+        offsets[i + 1] = offsets[i] + rows[i].size();
+    return offsets.back();
+}
+
+// Copies the first N rows of 'rows' into 'values', with the layout given by
+// ragged_layout().
+template <class Rows, class T>
+void ragged_copy(const Rows& rows, size_t N, const vector<size_t>& offsets,
+                 size_t width, T* values)
+{
+    int i, n = N;
+    #pragma omp parallel for default(shared) private(i) schedule(static) \
+        if (n > 1000)
+    for (i = 0; i < n; ++i)
+    {
+        size_t pos = offsets.empty() ? i * width : offsets[i];
+        copy(rows[i].begin(), rows[i].end(), values + pos);
+    }
+}
+
+template <class T>
+class ragged_array
+{
+public:
+    typedef T value_type;
+    typedef ragged_row<T> row_type;
+
+    ragged_array(): _size(0), _width(0) {}
+
+    template <class Rows>
+    ragged_array(const Rows& rows, size_t N)
+    {
+        assign(rows, N);
+    }
+
+    // packs the first N rows of 'rows'
+    template <class Rows>
+    void assign(const Rows& rows, size_t N)
+    {
+        _size = N;
+        _values.resize(ragged_layout(rows, N, _offsets, _width));
+        ragged_copy(rows, N, _offsets, _width, data());
+    }
+
+    // writes the rows back into 'rows', which is resized if necessary
+    template <class Rows>
+    void unpack(Rows& rows) const
+    {
+        if (rows.size() < _size)
+            rows.resize(_size);
+        int i, N = _size;
+        #pragma omp parallel for default(shared) private(i) schedule(static) \
+            if (N > 1000)
+        for (i = 0; i < N; ++i)
+        {
+            row_type r = (*this)[i];
+            rows[i].assign(r.begin(), r.end());
+        }
+    }
+
+    size_t size() const { return _size; }
+    bool is_fixed_width() const { return _offsets.empty(); }
+    size_t width() const { return _width; }
+
+    size_t row_begin(size_t i) const
+    {
+        return _offsets.empty() ? i * _width : _offsets[i];
+    }
+
+    size_t row_size(size_t i) const
+    {
+        return _offsets.empty() ? _width : _offsets[i + 1] - _offsets[i];
+    }
+
+    row_type operator[](size_t i) const
+    {
+        T* begin = const_cast<T*>(data()) + row_begin(i);
+        return row_type(begin, begin + row_size(i));
+    }
+
+    T* data() { return _values.empty() ? 0 : &_values[0]; }
+    const T* data() const { return _values.empty() ? 0 : &_values[0]; }
+
+    vector<T>& get_values() { return _values; }
+    const vector<size_t>& get_offsets() const { return _offsets; }
+
+private:
+    size_t _size;
+    size_t _width;
+    vector<size_t> _offsets;
+    vector<T> _values;
+};
+
+// Read-only property map which maps each key to its row in a ragged_array, via
+// an index map. The values of the row itself can be modified.
+template <class T, class IndexMap>
+class ragged_property_map
+{
+public:
+    typedef typename property_traits<IndexMap>::key_type key_type;
+    typedef ragged_row<T> value_type;
+    typedef ragged_row<T> reference;
+    typedef readable_property_map_tag category;
+
+    ragged_property_map(): _array(0) {}
+    ragged_property_map(const ragged_array<T>& array, IndexMap index)
+        : _array(&array), _index(index) {}
+
+    reference operator[](const key_type& k) const
+    {
+        return (*_array)[get(_index, k)];
+    }
+
+private:
+    const ragged_array<T>* _array;
+    IndexMap _index;
+};
+
+template <class T, class IndexMap>
+inline ragged_row<T>
+get(const ragged_property_map<T, IndexMap>& pmap,
+    const typename property_traits<IndexMap>::key_type& k)
+{
+    return pmap[k];
+}
+
+} // graph_tool namespace
+
+#endif // RAGGED_ARRAY_HH
@@ -0,0 +1,207 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2013 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SLAB_ALLOCATOR_HH
+#define SLAB_ALLOCATOR_HH
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <limits>
+
+namespace boost
+{
+
+// ========================================================================
+// slab_allocator<T>
+// ========================================================================
+//
+// slab_allocator is a stateless STL allocator meant for the many small
+// per-vertex edge lists of adj_list. Requests of up to 2^max_class elements are
+// rounded up to the next power of two (the "size class") and carved out of
+// large slabs, without any per-allocation header. Freed blocks are kept in a
+// free list for their size class, and are reused by later requests of the same
+// class; a vector which grows beyond its block is simply relocated to a block
+// of the next class. Larger requests are forwarded to ::operator new.
+//
+// The memory of the slabs is shared by all containers with the same value
+// type, and is never returned to the system, only recycled.
+
+template <class T>
+class slab_pool
+{
+public:
+    static const size_t max_class = 6;           // up to 64 elements
+    static const size_t slab_size = 1 << 20;     // bytes
+
+    // the pool is never destroyed, since containers with static storage may
+    // still release memory at exit
+    static slab_pool& get()
+    {
+        static slab_pool* pool = new slab_pool();
+        return *pool;
+    }
+
+    // number of bytes actually reserved for a request of n elements
+    static size_t block_bytes(size_t n)
+    {
+        if (n == 0)
+            return 0;
+        if (n > (size_t(1) << max_class))
+            return n * sizeof(T);
+        return elem_size() << size_class(n);
+    }
+
+    T* allocate(size_t n)
+    {
+        if (n > (size_t(1) << max_class))
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+
+        size_t c = size_class(n);
+        size_t bytes = elem_size() << c;
+        void* p;
+        #pragma omp critical (slab_pool)
+        {
+            if (_free[c] != 0)
+            {
+                p = _free[c];
+                _free[c] = *static_cast<void**>(p);
+            }
+            else
+            {
+                if (_pos + bytes > _end)
+                    new_slab();
+                p = _pos;
+                _pos += bytes;
+            }
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        if (n > (size_t(1) << max_class))
+        {
+            ::operator delete(p);
+            return;
+        }
+
+        size_t c = size_class(n);
+        #pragma omp critical (slab_pool)
+        {
+            *reinterpret_cast<void**>(p) = _free[c];
+            _free[c] = p;
+        }
+    }
+
+    // total number of bytes held in slabs, including free blocks
+    size_t reserved_bytes() const { return _slabs.size() * slab_size; }
+
+private:
+    slab_pool(): _pos(0), _end(0)
+    {
+        for (size_t i = 0; i <= max_class; ++i)
+            _free[i] = 0;
+    }
+    slab_pool(const slab_pool&);
+    slab_pool& operator=(const slab_pool&);
+
+    static size_t size_class(size_t n)
+    {
+        size_t c = 0;
+        while ((size_t(1) << c) < n)
+            ++c;
+        return c;
+    }
+
+    // blocks must be able to hold the free list pointer, and stay aligned
+    static size_t elem_size()
+    {
+        size_t align = sizeof(void*);
+        return (sizeof(T) + align - 1) / align * align;
+    }
+
+    void new_slab()
+    {
+        // the remainder of the current slab is lost, which is at most the
+        // size of the largest block
+        _slabs.push_back(static_cast<char*>(::operator new(slab_size)));
+        _pos = _slabs.back();
+        _end = _pos + slab_size;
+    }
+
+    void* _free[max_class + 1];
+    std::vector<char*> _slabs;
+    char* _pos;
+    char* _end;
+};
+
+template <class T>
+class slab_allocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <class U>
+    struct rebind { typedef slab_allocator<U> other; };
+
+    slab_allocator() {}
+    template <class U>
+    slab_allocator(const slab_allocator<U>&) {}
+
+    pointer address(reference x) const { return &x; }
+    const_pointer address(const_reference x) const { return &x; }
+
+    pointer allocate(size_type n, const void* = 0)
+    {
+        if (n == 0)
+            return 0;
+        return slab_pool<T>::get().allocate(n);
+    }
+
+    void deallocate(pointer p, size_type n)
+    {
+        if (p != 0)
+            slab_pool<T>::get().deallocate(p, n);
+    }
+
+    size_type max_size() const
+    {
+        return std::numeric_limits<size_type>::max() / sizeof(T);
+    }
+
+    void construct(pointer p, const T& val) { new(p) T(val); }
+    void destroy(pointer p) { p->~T(); }
+};
+
+template <class T, class U>
+bool operator==(const slab_allocator<T>&, const slab_allocator<U>&)
+{ return true; }
+
+template <class T, class U>
+bool operator!=(const slab_allocator<T>&, const slab_allocator<U>&)
+{ return false; }
+
+} // namespace boost
+
+#endif // SLAB_ALLOCATOR_HH
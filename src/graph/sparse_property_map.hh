@@ -0,0 +1,166 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2013 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPARSE_PROPERTY_MAP_HH
+#define SPARSE_PROPERTY_MAP_HH
+
+#include "config.h"
+
+#include <limits>
+#include <boost/version.hpp>
+#if (BOOST_VERSION >= 104000)
+#   include <boost/property_map/property_map.hpp>
+#else
+#   include <boost/property_map.hpp>
+#endif
+#include <boost/shared_ptr.hpp>
+#include <boost/mpl/bool.hpp>
+
+#ifdef HAVE_SPARSEHASH
+#include <dense_hash_map>
+#else
+#include "tr1_include.hh"
+#include TR1_HEADER(unordered_map)
+#endif
+
+namespace boost {
+
+// ========================================================================
+// sparse_property_map<T, IndexMap>
+// ========================================================================
+//
+// This is a property map which stores only the entries which differ from a
+// given default value, in a hash table keyed by the vertex or edge index. Its
+// memory usage is therefore proportional to the number of entries which were
+// set, instead of the largest index, which makes it suitable for annotations of
+// a small fraction of the vertices or edges of a large graph. If sparsehash is
+// available, the table is google's dense_hash_map, which uses open addressing,
+// otherwise a tr1::unordered_map is used.
+//
+// Unlike checked_vector_property_map, the values can only be modified via
+// put(), since operator[] returns a const reference (to the default value, if
+// the key is not present). Putting the default value removes the entry. Lookups
+// are thread-safe, but modifications are not.
+
+template <class T, class IndexMap>
+class sparse_property_map
+{
+public:
+    typedef typename property_traits<IndexMap>::key_type key_type;
+    typedef T value_type;
+    typedef const T& reference;
+    typedef read_write_property_map_tag category;
+
+    typedef IndexMap index_map_t;
+    typedef typename property_traits<IndexMap>::value_type index_t;
+
+#ifdef HAVE_SPARSEHASH
+    typedef google::dense_hash_map<index_t, T> map_t;
+#else
+    typedef std::tr1::unordered_map<index_t, T> map_t;
+#endif
+    typedef typename map_t::const_iterator const_iterator;
+
+    sparse_property_map(const IndexMap& idx = IndexMap(),
+                        const T& def = T())
+        : _store(new storage(def)), _index(idx) {}
+
+    reference operator[](const key_type& k) const
+    {
+        typename map_t::const_iterator iter = _store->map.find(get(_index, k));
+        if (iter == _store->map.end())
+            return _store->def;
+        return iter->second;
+    }
+
+    // the value is taken by copy, since it may refer to an entry of the same
+    // table, which can be invalidated by the insertion
+    void put_value(const key_type& k, T val) const
+    {
+        index_t i = get(_index, k);
+        if (val == _store->def)
+            _store->map.erase(i);
+        else
+            _store->map[i] = val;
+    }
+
+    const T& get_default() const { return _store->def; }
+
+    // number of stored entries, i.e. those which differ from the default
+    size_t size() const { return _store->map.size(); }
+
+    void clear() const { _store->map.clear(); }
+
+    // iteration over the stored (index, value) pairs
+    const_iterator storage_begin() const { return _store->map.begin(); }
+    const_iterator storage_end() const { return _store->map.end(); }
+
+    sparse_property_map get_unchecked(size_t = 0) const { return *this; }
+
+    // deep copy
+    sparse_property_map copy() const
+    {
+        sparse_property_map pmap(_index, _store->def);
+        pmap._store->map = _store->map;
+        return pmap;
+    }
+
+private:
+    struct storage
+    {
+        storage(const T& d): def(d)
+        {
+#ifdef HAVE_SPARSEHASH
+            map.set_empty_key(std::numeric_limits<index_t>::max());
+            map.set_deleted_key(std::numeric_limits<index_t>::max() - 1);
+#endif
+        }
+        map_t map;
+        T def;
+    };
+
+    shared_ptr<storage> _store;
+    IndexMap _index;
+};
+
+template <class T, class IndexMap>
+inline const T&
+get(const sparse_property_map<T, IndexMap>& pmap,
+    const typename sparse_property_map<T, IndexMap>::key_type& k)
+{
+    return pmap[k];
+}
+
+template <class T, class IndexMap>
+inline void
+put(const sparse_property_map<T, IndexMap>& pmap,
+    const typename sparse_property_map<T, IndexMap>::key_type& k,
+    const T& val)
+{
+    pmap.put_value(k, val);
+}
+
+template <class PropertyMap>
+struct is_sparse_property_map: public mpl::false_ {};
+
+template <class T, class IndexMap>
+struct is_sparse_property_map<sparse_property_map<T, IndexMap> >
+    : public mpl::true_ {};
+
+} // namespace boost
+
+#endif // SPARSE_PROPERTY_MAP_HH
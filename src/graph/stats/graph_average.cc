@@ -31,7 +31,7 @@ get_vertex_average(GraphInterface& gi, GraphInterface::deg_t deg)
 {
     long double a, dev;
     run_action<>()(gi, get_average<VertexAverageTraverse>(a,dev),
-                   scalar_selectors())(degree_selector(deg));
+                   mapped_and_scalar_selectors())(degree_selector(deg));
     return python::make_tuple(a,dev);
 }
 
@@ -44,7 +44,7 @@ get_edge_average(GraphInterface& gi, boost::any prop)
     gi.SetDirected(true);
     run_action<graph_tool::detail::always_directed>()
         (gi, get_average<EdgeAverageTraverse>(a, dev),
-         edge_scalar_properties())(prop);
+         mapped_and_edge_scalar_properties())(prop);
     gi.SetDirected(directed);
 
     return python::make_tuple(a, dev);
@@ -29,7 +29,8 @@ struct deg_check : public boost::static_visitor<>
 {
     void operator()(boost::any a) const
     {
-        if (!belongs<vertex_scalar_properties>()(a))
+        if (!belongs<vertex_scalar_properties>()(a) &&
+            !belongs<vertex_mapped_scalar_properties>()(a))
             throw ValueException("Vertex property must be of scalar type.");
     }
 
@@ -50,7 +51,7 @@ get_vertex_histogram(GraphInterface& gi, GraphInterface::deg_t deg,
 
     run_action<>()(gi, get_histogram<VertexHistogramFiller>(hist, bins,
                                                             ret_bins),
-         scalar_selectors())(degree_selector(deg));
+         mapped_and_scalar_selectors())(degree_selector(deg));
     return python::make_tuple(hist, ret_bins);
 }
 
@@ -59,7 +60,7 @@ python::object
 get_edge_histogram(GraphInterface& gi, boost::any prop,
                    const vector<long double>& bins)
 {
-    if (!belongs<edge_scalar_properties>()(prop))
+    if (!belongs<mapped_and_edge_scalar_properties>()(prop))
         throw ValueException("Edge property must be of scalar type.");
 
     python::object hist;
@@ -69,7 +70,7 @@ get_edge_histogram(GraphInterface& gi, boost::any prop,
     gi.SetDirected(true);
     run_action<graph_tool::detail::always_directed>()
         (gi, get_histogram<EdgeHistogramFiller>(hist, bins, ret_bins),
-         edge_scalar_properties())(prop);
+         mapped_and_edge_scalar_properties())(prop);
     gi.SetDirected(directed);
 
     return python::make_tuple(hist, ret_bins);
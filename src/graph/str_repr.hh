@@ -51,6 +51,18 @@ uint8_t lexical_cast<uint8_t,string>(const string& val)
     return uint8_t(lexical_cast<int>(val));
 }
 
+template <>
+string lexical_cast<string,int8_t>(const int8_t& val)
+{
+    return lexical_cast<std::string>(int(val));
+}
+
+template <>
+int8_t lexical_cast<int8_t,string>(const string& val)
+{
+    return int8_t(lexical_cast<int>(val));
+}
+
 // float, double and long double should be printed in hexadecimal format to
 // preserve internal representation. (we also need to make sure the
 // representation is locale-independent).
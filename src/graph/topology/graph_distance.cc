@@ -176,7 +176,7 @@ void get_dists(GraphInterface& gi, size_t source, int tgt, boost::any dist_map,
     {
         run_action<>()
             (gi, bind<void>(do_bfs_search(), _1, source, target, gi.GetVertexIndex(),
-                            _2, pmap.get_unchecked(num_vertices(gi.GetGraph())),
+                            _2, pmap.get_unchecked(gi.GetTotalNumberOfVertices()),
                             max_dist),
              writable_vertex_scalar_properties(),
              mpl::vector<pred_map_t>())
@@ -186,7 +186,7 @@ void get_dists(GraphInterface& gi, size_t source, int tgt, boost::any dist_map,
     {
         run_action<>()
             (gi, bind<void>(do_djk_search(), _1, source, target, gi.GetVertexIndex(),
-                            _2, pmap.get_unchecked(num_vertices(gi.GetGraph())),
+                            _2, pmap.get_unchecked(gi.GetTotalNumberOfVertices()),
                             _3, max_dist),
              writable_vertex_scalar_properties(),
              edge_scalar_properties())
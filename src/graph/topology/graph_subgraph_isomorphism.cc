@@ -226,7 +226,7 @@ void subgraph_isomorphism(GraphInterface& gi1, GraphInterface& gi2,
 
     if (belongs<vertex_props_t>()(vertex_label1))
     {
-        vertex_label2 = any_cast<vlabel_t>(vertex_label2).get_unchecked(num_vertices(gi2.GetGraph()));
+        vertex_label2 = any_cast<vlabel_t>(vertex_label2).get_unchecked(gi2.GetTotalNumberOfVertices());
     }
     else
     {
@@ -250,13 +250,13 @@ void subgraph_isomorphism(GraphInterface& gi1, GraphInterface& gi2,
                                            _1, _2, vlabel2, ref(vlist)),
                            vertex_properties())
                 (vertex_label2);
-            vertex_label2 = vlabel2.get_unchecked(num_vertices(gi2.GetGraph()));
+            vertex_label2 = vlabel2.get_unchecked(gi2.GetTotalNumberOfVertices());
         }
     }
 
     if (belongs<edge_props_t>()(edge_label1))
     {
-        edge_label2 = any_cast<elabel_t>(edge_label2).get_unchecked(gi2.GetGraph().get_last_index());
+        edge_label2 = any_cast<elabel_t>(edge_label2).get_unchecked(gi2.GetMaxEdgeIndex());
     }
     else
     {
@@ -280,7 +280,7 @@ void subgraph_isomorphism(GraphInterface& gi1, GraphInterface& gi2,
                                            _1, _2, elabel2, ref(vlist)),
                            edge_properties())
                 (edge_label2);
-            edge_label2 = elabel2.get_unchecked(num_edges(gi2.GetGraph()));
+            edge_label2 = elabel2.get_unchecked(gi2.GetMaxEdgeIndex());
         }
     }
 
@@ -108,14 +108,18 @@ import re
 import gzip
 import weakref
 import copy
+import struct
+import pickle
 
 from io import BytesIO
 from .decorators import _wraps, _require, _attrs, _limit_args
 from inspect import ismethod
 
 __all__ = ["Graph", "GraphView", "Vertex", "Edge", "Vector_bool",
-           "Vector_int16_t", "Vector_int32_t", "Vector_int64_t", "Vector_double",
+           "Vector_int8_t", "Vector_int16_t", "Vector_int32_t",
+           "Vector_uint32_t", "Vector_int64_t", "Vector_float", "Vector_double",
            "Vector_long_double", "Vector_string", "value_types", "load_graph",
+           "load_graph_from_csv",
            "PropertyMap", "group_vector_property", "ungroup_vector_property",
            "infect_vertex_property", "edge_difference", "seed_rng", "show_config",
            "PropertyArray", "__author__", "__copyright__", "__URL__",
@@ -151,6 +155,21 @@ def _prop(t, g, prop):
         return pmap._PropertyMap__map.get_map()
 
 
+def _intern_pair(p1, p2):
+    """Return the pair of property maps such that, if any of them is interned,
+    both are interned with the same dictionary, so that their codes can be
+    compared directly."""
+    if p1 is None or p2 is None or not (p1.is_interned() or p2.is_interned()):
+        return p1, p2
+    if p1._PropertyMap__strings is p2._PropertyMap__strings:
+        return p1, p2
+    if p1.is_interned():
+        p2 = p2.copy(intern=p1)
+    else:
+        p1 = p1.copy(intern=p2)
+    return p1, p2
+
+
 def _degree(g, name):
     """Retrieve the degree type from string, or returns the corresponding
     property map."""
@@ -167,14 +186,14 @@ def _degree(g, name):
 
 
 def _type_alias(type_name):
-    alias = {"int8_t": "bool",
+    alias = {"uint8_t": "bool",
              "boolean": "bool",
              "short": "int16_t",
              "int": "int32_t",
              "long": "int64_t",
              "long long": "int64_t",
-             "object": "python::object",
-             "float": "double"}
+             "unsigned int": "uint32_t",
+             "object": "python::object"}
     if type_name in value_types():
         return type_name
     if type_name in alias:
@@ -197,7 +216,7 @@ def _python_type(type_name):
         return int
     if type_name == "bool":
         return bool
-    if "double" in type_name:
+    if "double" in type_name or type_name == "float":
         return float
     if "string" in type_name:
         return str
@@ -208,12 +227,18 @@ def _gt_type(obj):
     t = type(obj)
     if t is numpy.longlong or t is numpy.uint64:
         return "long long"
+    if issubclass(t, numpy.int8):
+        return "int8_t"
     if issubclass(t, numpy.int16):
         return "short"
+    if issubclass(t, numpy.uint32):
+        return "uint32_t"
     if t is int or issubclass(t, numpy.int):
         return "int"
     if t is numpy.float128:
         return "long double"
+    if t is numpy.float32:
+        return "float"
     if t is float or issubclass(t, numpy.float):
         return "double"
     if t is str:
@@ -244,6 +269,7 @@ def show_config():
     print("python dir:", info.python_dir)
     print("graph filtering:", libcore.graph_filtering_enabled())
     print("openmp:", libcore.openmp_enabled())
+    print("slab allocator:", libcore.slab_allocator_enabled())
     print("uname:", " ".join(os.uname()))
 
 ################################################################################
@@ -351,6 +377,29 @@ class PropertyArray(numpy.ndarray):
             locals()[method] = _wrap_method(method)
 
 
+class _StringDictionary(object):
+    """Dictionary of the values of interned string property maps, which is
+    shared between them. The position of each string in the list is its
+    code. The empty string has always the code zero, so that unset values are
+    empty, as with regular string property maps."""
+    def __init__(self):
+        self.strings = [""]
+        self.codes = {"": 0}
+
+    def encode(self, val):
+        c = self.codes.get(val)
+        if c is None:
+            c = len(self.strings)
+            self.strings.append(val)
+            self.codes[val] = c
+        return c
+
+    def update(self):
+        # register strings appended from the C++ side
+        for c in range(len(self.codes), len(self.strings)):
+            self.codes[self.strings[c]] = c
+
+
 class PropertyMap(object):
     """This class provides a mapping from vertices, edges or whole graphs to arbitrary properties.
 
@@ -364,24 +413,34 @@ class PropertyMap(object):
          Type name                  Alias
         =======================     ======================
         ``bool``                    ``uint8_t``
+        ``int8_t``
         ``int16_t``                 ``short``
         ``int32_t``                 ``int``
+        ``uint32_t``                ``unsigned int``
         ``int64_t``                 ``long``, ``long long``
-        ``double``                  ``float``
+        ``float``
+        ``double``
         ``long double``
         ``string``
         ``vector<bool>``            ``vector<uint8_t>``
-        ``vector<int16_t>``         ``short``
+        ``vector<int8_t>``
+        ``vector<int16_t>``         ``vector<short>``
         ``vector<int32_t>``         ``vector<int>``
+        ``vector<uint32_t>``        ``vector<unsigned int>``
         ``vector<int64_t>``         ``vector<long>``, ``vector<long long>``
-        ``vector<double>``          ``vector<float>``
+        ``vector<float>``
+        ``vector<double>``
         ``vector<long double>``
         ``vector<string>``
         ``python::object``          ``object``
         =======================     ======================
+
+    String property maps can also be interned (see
+    :meth:`~graph_tool.Graph.new_vertex_property`).
     """
-    def __init__(self, pmap, g, key_type):
+    def __init__(self, pmap, g, key_type, strings=None):
         self.__map = pmap
+        self.__strings = strings
         self.__g = weakref.ref(g)
         self.__base_g = lambda: None
         try:
@@ -415,14 +474,22 @@ class PropertyMap(object):
         self.__unregister_map()
 
     def __getitem__(self, k):
+        if self.__strings is not None:
+            return self.__strings.strings[self.__map[self.__key_trans(k)]]
         return self.__map[self.__key_trans(k)]
 
     def __setitem__(self, k, v):
         key = self.__key_trans(k)
-        try:
-            self.__map[key] = v
-        except TypeError:
-            self.__map[key] = _convert(self, v)
+        if self.__strings is not None:
+            self.__map[key] = self.__strings.encode(str(v))
+        else:
+            try:
+                self.__map[key] = v
+            except TypeError:
+                self.__map[key] = _convert(self, v)
+        g = self.__g()
+        if g is not None and g._Graph__journal is not None:
+            g._Graph__journal_property(self, k)
 
     def __repr__(self):
         # provide some more useful information
@@ -440,10 +507,14 @@ class PropertyMap(object):
         return ("<PropertyMap object with key type '%s' and value type '%s',"
                 + " for %s, at 0x%x>") % (k, self.value_type(), g, id(self))
 
-    def copy(self, value_type=None):
+    def copy(self, value_type=None, sparse=None, intern=None):
         """Return a copy of the property map. If ``value_type`` is specified,
-        the value type is converted to the chosen type."""
-        return self.get_graph().copy_property(self, value_type=value_type)
+        the value type is converted to the chosen type. If ``sparse`` or
+        ``intern`` are specified, the copy is a sparse or an interned property
+        map, accordingly (see :meth:`~graph_tool.Graph.new_vertex_property`),
+        otherwise it is of the same kind as the original."""
+        return self.get_graph().copy_property(self, value_type=value_type,
+                                              sparse=sparse, intern=intern)
 
     def __copy__(self):
         return self.copy()
@@ -461,11 +532,13 @@ class PropertyMap(object):
 
     def value_type(self):
         """Return the value type of the map."""
+        if self.__strings is not None:
+            return "string"
         return self.__map.value_type()
 
     def python_value_type(self):
         """Return the python-compatible value type of the map."""
-        return _python_type(self.__map.value_type())
+        return _python_type(self.value_type())
 
     def get_array(self):
         """Get a :class:`~graph_tool.PropertyArray` with the property values.
@@ -474,7 +547,9 @@ class PropertyMap(object):
 
            An array is returned *only if* the value type of the property map is
            a scalar. For vector, string or object types, ``None`` is returned
-           instead. For vector and string objects, indirect array access is
+           instead, except for interned string property maps, for which the
+           array contains the string codes (see
+           :meth:`~graph_tool.PropertyMap.get_dictionary`). For vector and string objects, indirect array access is
            provided via the :func:`~graph_tool.PropertyMap.get_2d_array()` and
            :func:`~graph_tool.PropertyMap.set_2d_array()` member functions.
 
@@ -492,6 +567,14 @@ class PropertyMap(object):
         return PropertyArray(a, prop_map=self)
 
     def _get_data(self):
+        n = self.__get_size()
+        if n is None:
+            return None
+        a = self.__map.get_array(n)
+        return a
+
+    def __get_size(self):
+        # number of entries of the underlying storage, ignoring any filters
         g = self.get_graph()
         if g is None:
             return None
@@ -501,13 +584,10 @@ class PropertyMap(object):
         else:
             u = g
         if self.__key_type == 'v':
-            n = u.num_vertices()
+            return u.num_vertices()
         elif self.__key_type == 'e':
-            n = max(u.max_edge_index, 1)
-        else:
-            n = 1
-        a = self.__map.get_array(n)
-        return a
+            return max(u.max_edge_index, 1)
+        return 1
 
     def __set_array(self, v):
         a = self.get_array()
@@ -601,10 +681,23 @@ class PropertyMap(object):
                   identical to the :attr:`~PropertyMap.a` attribute.""")
 
     def get_2d_array(self, pos):
-        r"""Return a two-dimensional array with a copy of the entries of the
+        r"""Return a two-dimensional array with the entries of the
         vector-valued property map. The parameter ``pos`` must be a sequence of
         integers which specifies the indexes of the property values which will
-        be used. """
+        be used.
+
+        The vectors are first packed into a single contiguous array, in one
+        pass. If all vectors have the same length, and ``pos`` is a contiguous
+        range of indexes, the returned array is a view of this packed array,
+        without any further copies. Missing entries of shorter vectors are
+        returned as zeros.
+
+        .. note::
+
+           The returned array is always a *copy* of the property values, and
+           modifying it will not affect the property map. Use
+           :meth:`~graph_tool.PropertyMap.set_2d_array` instead.
+        """
 
         if self.key_type() == "g":
             raise ValueError("Cannot create multidimensional array for graph property maps.")
@@ -635,9 +728,31 @@ class PropertyMap(object):
         a = self.fa
         if a is not None:
             return numpy.array(a)
-        else:
-            p = ungroup_vector_property(self, pos)
-            return numpy.array([x.a for x in p])
+        packed = self.__map.get_packed(self.__get_size())
+        if packed is None:
+            raise ValueError("Cannot create array from property map of type '%s'." \
+                             % self.value_type())
+        values, offsets = packed
+        pos = [int(p) for p in pos]
+        if len(pos) > 0 and min(pos) < 0:
+            raise ValueError("Invalid negative index in %s." % str(pos))
+        if offsets is None:
+            # all vectors have the same length, and the values are laid out
+            # as a (N, width) array
+            w = values.shape[1]
+            if len(pos) > 0 and max(pos) < w:
+                if pos == list(range(pos[0], pos[-1] + 1)):
+                    return values.T[pos[0]:pos[-1] + 1]
+                return values.T[pos]
+            offsets = numpy.arange(0, (values.shape[0] + 1) * w, w)
+            values = values.ravel()
+        start = offsets[:-1].astype("int64")
+        lengths = numpy.diff(offsets).astype("int64")
+        a = numpy.zeros((len(pos), len(start)), dtype=values.dtype)
+        for i, p in enumerate(pos):
+            m = lengths > p
+            a[i, m] = values[start[m] + p]
+        return a
 
     def set_2d_array(self, a, pos=None):
         r"""Set the entries of the vector-valued property map from a
@@ -683,6 +798,42 @@ class PropertyMap(object):
         """Return True if the property is writable."""
         return self.__map.is_writable()
 
+    def is_sparse(self):
+        """Return True if the property map is sparse, i.e. if it stores only
+        the values which differ from its default value (see
+        :meth:`~graph_tool.Graph.new_vertex_property`)."""
+        if self.key_type() == "g":
+            return False
+        return self.__map.is_sparse()
+
+    def is_interned(self):
+        """Return True if the property map is an interned string property map
+        (see :meth:`~graph_tool.Graph.new_vertex_property`)."""
+        return self.__strings is not None
+
+    def get_dictionary(self):
+        """Return the list of distinct strings of an interned property map,
+        indexed by their codes, as returned by
+        :meth:`~graph_tool.PropertyMap.get_array`, or ``None`` if the property
+        map is not interned."""
+        if self.__strings is None:
+            return None
+        return list(self.__strings.strings)
+
+    def is_mapped(self):
+        """Return True if the property map values are stored in a memory-mapped
+        file (see :meth:`~graph_tool.Graph.new_vertex_property`)."""
+        if self.key_type() == "g":
+            return False
+        return self.__map.is_mapped()
+
+    def get_default(self):
+        """Return the default value of a sparse property map, or ``None`` if it
+        is not sparse."""
+        if self.key_type() == "g":
+            return None
+        return self.__map.get_default()
+
     def __call__(self, a):
         p = self.copy()
         p.fa = a
@@ -696,10 +847,10 @@ def _check_prop_writable(prop, name=None):
 
 
 def _check_prop_scalar(prop, name=None, floating=False):
-    scalars = ["bool", "int32_t", "int64_t", "unsigned long",
-               "double", "long double"]
+    scalars = ["bool", "int8_t", "int32_t", "uint32_t", "int64_t",
+               "unsigned long", "float", "double", "long double"]
     if floating:
-        scalars = ["double", "long double"]
+        scalars = ["float", "double", "long double"]
 
     if prop.value_type() not in scalars:
         raise ValueError("property map%s is not of scalar%s type." %\
@@ -708,12 +859,12 @@ def _check_prop_scalar(prop, name=None, floating=False):
 
 
 def _check_prop_vector(prop, name=None, scalar=True, floating=False):
-    scalars = ["bool", "int32_t", "int64_t", "unsigned long",
-               "double", "long double"]
+    scalars = ["bool", "int8_t", "int32_t", "uint32_t", "int64_t",
+               "unsigned long", "float", "double", "long double"]
     if not scalar:
         scalars += ["string"]
     if floating:
-        scalars = ["double", "long double"]
+        scalars = ["float", "double", "long double"]
     vals = ["vector<%s>" % v for v in scalars]
     if prop.value_type() not in vals:
         raise ValueError("property map%s is not of vector%s type." %\
@@ -953,6 +1104,174 @@ def edge_difference(g, prop, ediff=None):
     return ediff
 
 
+class _LazyPropertyMap(PropertyMap):
+    """Property map whose values are read from a saved graph file only when
+    they are first accessed (see :func:`~graph_tool.load_graph`)."""
+
+    def __init__(self, g, key_type, value_type, file_name, pos, n, stat):
+        self.__lazy = (value_type, file_name, pos, n, stat)
+        self.__lazy_map = None
+        PropertyMap.__init__(self, None, g, key_type)
+
+    def __get_map(self):
+        if self.__lazy_map is None and self.__lazy is not None:
+            value_type, file_name, pos, n, stat = self.__lazy
+            st = os.stat(file_name)
+            if (st.st_size, st.st_mtime) != stat:
+                raise IOError("file '%s' was modified after the graph was " %
+                              file_name + "loaded; cannot read property map")
+            g = self.get_graph()
+            self.__lazy_map = g._Graph__graph.ReadProperty(file_name, pos, n)
+            self.__lazy = None
+        return self.__lazy_map
+
+    def __set_map(self, pmap):
+        self.__lazy_map = pmap
+    _PropertyMap__map = property(__get_map, __set_map)
+
+    def value_type(self):
+        if self.__lazy is not None:
+            return self.__lazy[0]
+        return PropertyMap.value_type(self)
+
+    def is_loaded(self):
+        """Return whether the values have already been read from the file."""
+        return self.__lazy is None
+
+
+# binary encoding of the property values in the graph journal (see
+# Graph.set_journal())
+
+_journal_dtypes = {"bool": "uint8", "int8_t": "int8", "int16_t": "int16",
+                   "int32_t": "int32", "uint32_t": "uint32",
+                   "int64_t": "int64", "float": "float32", "double": "float64",
+                   "long double": "longdouble"}
+
+
+def _journal_encode(value_type, val):
+    if value_type in _journal_dtypes:
+        return numpy.array(val, dtype=_journal_dtypes[value_type]).tostring()
+    if value_type == "vector<string>":
+        return (struct.pack("=Q", len(val)) +
+                b"".join([_journal_encode("string", x) for x in val]))
+    if value_type.startswith("vector<"):
+        val = numpy.array(list(val), dtype=_journal_dtypes[value_type[7:-1]])
+        return struct.pack("=Q", len(val)) + val.tostring()
+    if value_type == "string":
+        if not isinstance(val, bytes):
+            val = val.encode("utf-8")
+    else:
+        val = pickle.dumps(val, -1)
+    return struct.pack("=Q", len(val)) + val
+
+
+def _journal_decode(value_type, data, pos):
+    # returns the value at position pos, and the position after it
+    if value_type in _journal_dtypes:
+        dtype = numpy.dtype(_journal_dtypes[value_type])
+        val = numpy.frombuffer(data, dtype, 1, pos)[0]
+        return val, pos + dtype.itemsize
+    n = struct.unpack_from("=Q", data, pos)[0]
+    pos += 8
+    if value_type == "vector<string>":
+        val = []
+        for i in range(n):
+            x, pos = _journal_decode("string", data, pos)
+            val.append(x)
+        return val, pos
+    if value_type.startswith("vector<"):
+        dtype = numpy.dtype(_journal_dtypes[value_type[7:-1]])
+        if n == 0:
+            return [], pos
+        val = numpy.frombuffer(data, dtype, n, pos)
+        return val, pos + n * dtype.itemsize
+    val = data[pos:pos + n]
+    if value_type == "string":
+        if sys.version_info >= (3,):
+            val = val.decode("utf-8")
+    else:
+        val = pickle.loads(val)
+    return val, pos + n
+
+
+class _Journal(object):
+    """Log of the modifications of a graph since its last snapshot (see
+    :meth:`~graph_tool.Graph.set_journal`)."""
+
+    magic = b"graph-tool journal\n"
+
+    def __init__(self, file_name):
+        self.file_name = file_name
+        self.log = None
+        # set when the graph was modified in a way which cannot be recorded,
+        # in which case nothing else is written until the next snapshot
+        self.stale = False
+
+    @staticmethod
+    def header(snapshot):
+        # identifies the snapshot to which the log refers
+        st = os.stat(snapshot)
+        return _Journal.magic + struct.pack("=qd", st.st_size, st.st_mtime)
+
+    def reset(self, snapshot):
+        # the new snapshot was written to a temporary file, which replaces the
+        # previous one together with an empty log
+        self.close()
+        log_name = self.file_name + ".log"
+        head, tail = os.path.split(log_name)
+        tmp = os.path.join(head, ".tmp-" + tail)
+        with open(snapshot, "rb") as f:
+            os.fsync(f.fileno())
+        with open(tmp, "wb") as f:
+            f.write(self.header(snapshot))
+            f.flush()
+            os.fsync(f.fileno())
+        os.rename(snapshot, self.file_name)
+        os.rename(tmp, log_name)
+        self.log = open(log_name, "ab")
+        self.stale = False
+
+    def write(self, op, data=b""):
+        if self.log is None or self.stale:
+            return
+        self.log.write(struct.pack("=I", len(data) + 1) + op + data)
+
+    def sync(self):
+        if self.log is not None:
+            self.log.flush()
+            os.fsync(self.log.fileno())
+
+    def close(self):
+        if self.log is not None:
+            self.log.close()
+            self.log = None
+
+    @staticmethod
+    def read(file_name):
+        # returns the (op, data) records of the log of the given snapshot; a
+        # truncated last record, left by an interrupted write, is ignored
+        log_name = file_name + ".log"
+        if not os.path.exists(log_name):
+            return []
+        with open(log_name, "rb") as f:
+            data = f.read()
+        header = _Journal.header(file_name)
+        if data[:len(header)] != header:
+            raise IOError(("the journal '%s' does not match the snapshot " +
+                           "'%s', which was probably rewritten after it; the " +
+                           "journal must be removed for the snapshot to be " +
+                           "loaded alone") % (log_name, file_name))
+        records = []
+        pos = len(header)
+        while pos + 4 <= len(data):
+            n = struct.unpack_from("=I", data, pos)[0]
+            if n == 0 or pos + 4 + n > len(data):
+                break
+            records.append((data[pos + 4:pos + 5], data[pos + 5:pos + 4 + n]))
+            pos += 4 + n
+        return records
+
+
 class PropertyDict(dict):
     """Wrapper for the dict of vertex, graph or edge properties, which sets the
     value on the property map when changed in the dict.
@@ -1001,9 +1320,12 @@ class PropertyDict(dict):
 # The main graph interface
 ################################################################################
 
-from .libgraph_tool_core import Vertex, EdgeBase, Vector_bool, Vector_int16_t, \
-    Vector_int32_t, Vector_int64_t, Vector_double, Vector_long_double, \
-    Vector_string, new_vertex_property, new_edge_property, new_graph_property
+from .libgraph_tool_core import Vertex, EdgeBase, Vector_bool, Vector_int8_t, \
+    Vector_int16_t, Vector_int32_t, Vector_uint32_t, Vector_int64_t, \
+    Vector_float, Vector_double, Vector_long_double, \
+    Vector_string, new_vertex_property, new_edge_property, new_graph_property, \
+    new_sparse_vertex_property, new_sparse_edge_property, \
+    new_mapped_vertex_property, new_mapped_edge_property
 
 
 class Graph(object):
@@ -1029,21 +1351,40 @@ class Graph(object):
     The graph is implemented as an `adjacency list`_, where both vertex and edge
     lists are C++ STL vectors.
 
+    If ``index_type == "int32"``, the adjacency lists are stored with 32-bit
+    integers, instead of the default 64-bit (``index_type == "int64"``), which
+    halves their memory usage, and improves cache usage in most algorithms.
+    The number of vertices and edges is then limited to :math:`2^{32}-1`. If
+    ``g`` is specified and ``index_type`` is ``None``, the index type of ``g``
+    is used; otherwise the graph is converted.
+
+    If ``keep_in_edges == False``, only the out-edge lists are stored, and the
+    in-edge lists are built only when an algorithm first needs them (see
+    :meth:`~Graph.set_keep_in_edges`). If ``g`` is specified and
+    ``keep_in_edges`` is ``None``, the setting of ``g`` is used.
+
+    When pickled, the graph and all its property maps are serialized in memory
+    in the binary "gt" format (see :meth:`~Graph.save`), which is not
+    compressed, unless the class attribute ``Graph.pickle_compression`` is set
+    to ``True``.
+
     .. _adjacency list: http://en.wikipedia.org/wiki/Adjacency_list
 
     """
 
-    def __init__(self, g=None, directed=True, prune=False, vorder=None):
-        self.__properties = {}
-        self.__known_properties = {}
-        self.__filter_state = {"reversed": False,
-                               "edge_filter": (None, False),
-                               "vertex_filter": (None, False),
-                               "directed": True}
+    def __init__(self, g=None, directed=True, prune=False, vorder=None,
+                 index_type=None, keep_in_edges=None):
+        if index_type not in [None, "int32", "int64"]:
+            raise ValueError("invalid index type: " + str(index_type))
+        self.__init_state()
         if g is None:
-            self.__graph = libcore.GraphInterface()
+            self.__graph = libcore.GraphInterface(index_type == "int32")
             self.set_directed(directed)
         else:
+            if index_type is None:
+                index32 = g.__graph.GetIndex32()
+            else:
+                index32 = index_type == "int32"
             if isinstance(prune, bool):
                 vprune = eprune = rprune = prune
             else:
@@ -1060,12 +1401,13 @@ class Graph(object):
             vfilt = g.get_vertex_filter()[0]
             efilt = g.get_edge_filter()[0]
 
-            if (vorder is None and
+            # (memory-mapped graphs have no adjacency list to be copied)
+            if (vorder is None and not g.__graph.GetMapped() and
                 ((g.get_vertex_filter()[0] is None and g.get_edge_filter()[0] is None) or
                  (not vprune and not eprune))):
                 # Do a simpler, faster copy.
                 self.__graph = libcore.GraphInterface(gv.__graph, False,
-                                                      [], [], None)
+                                                      [], [], None, index32)
                 nvfilt = nefilt = None
                 for k, m in g.properties.items():
                     nmap = self.copy_property(m, g=gv)
@@ -1088,13 +1430,19 @@ class Graph(object):
                 vprops = []
                 eprops = []
                 ef_pos = vf_pos = None
+                # (sparse and memory-mapped maps are copied via temporary
+                # regular ones)
                 for k, m in gv.vertex_properties.items():
                     if not vprune and m is vfilt:
                         vf_pos = len(vprops)
+                    if m.is_sparse() or m.is_mapped():
+                        m = gv.copy_property(m, sparse=False)
                     vprops.append([_prop("v", gv, m), libcore.any()])
                 for k, m in gv.edge_properties.items():
                     if not eprune and  m is efilt:
                         ef_pos = len(eprops)
+                    if m.is_sparse() or m.is_mapped():
+                        m = gv.copy_property(m, sparse=False)
                     eprops.append([_prop("e", gv, m), libcore.any()])
                 if not vprune and vf_pos is None and vfilt is not None:
                     vf_pos = len(vprops)
@@ -1112,20 +1460,39 @@ class Graph(object):
                 self.__graph = libcore.GraphInterface(gv.__graph, False,
                                                       vprops,
                                                       eprops,
-                                                      _prop("v", gv, vorder))
+                                                      _prop("v", gv, vorder),
+                                                      index32)
 
                 # Put the copied properties in the internal dictionary
                 for i, (k, m) in enumerate(g.vertex_properties.items()):
-                    pmap = new_vertex_property(m.value_type(),
+                    # (interned maps are copied as their codes)
+                    pmap = new_vertex_property(m._PropertyMap__map.value_type(),
                                                self.__graph.GetVertexIndex(),
                                                vprops[i][1])
-                    self.vertex_properties[k] = PropertyMap(pmap, self, "v")
+                    pmap = PropertyMap(pmap, self, "v",
+                                       m._PropertyMap__strings)
+                    if m.is_sparse():
+                        spmap = self.new_vertex_property(m.value_type(),
+                                                         sparse=True,
+                                                         default=m.get_default())
+                        self.copy_property(pmap, spmap)
+                        pmap = spmap
+                    self.vertex_properties[k] = pmap
 
                 for i, (k, m) in enumerate(g.edge_properties.items()):
-                    pmap = new_edge_property(m.value_type(),
+                    # (interned maps are copied as their codes)
+                    pmap = new_edge_property(m._PropertyMap__map.value_type(),
                                              self.__graph.GetEdgeIndex(),
                                              eprops[i][1])
-                    self.edge_properties[k] = PropertyMap(pmap, self, "e")
+                    pmap = PropertyMap(pmap, self, "e",
+                                       m._PropertyMap__strings)
+                    if m.is_sparse():
+                        spmap = self.new_edge_property(m.value_type(),
+                                                       sparse=True,
+                                                       default=m.get_default())
+                        self.copy_property(pmap, spmap)
+                        pmap = spmap
+                    self.edge_properties[k] = pmap
 
                 for k, v in g.graph_properties.items():
                     new_p = self.new_graph_property(v.value_type())
@@ -1151,6 +1518,27 @@ class Graph(object):
             # directedness is always a filter
             self.set_directed(g.is_directed())
 
+            if keep_in_edges is None:
+                keep_in_edges = g.get_keep_in_edges()
+
+        if keep_in_edges is not None:
+            self.set_keep_in_edges(keep_in_edges)
+
+        self.__init_index()
+
+    def __init_state(self):
+        # internal properties and filter state
+        self.__properties = {}
+        self.__known_properties = {}
+        self.__filter_state = {"reversed": False,
+                               "edge_filter": (None, False),
+                               "vertex_filter": (None, False),
+                               "directed": True}
+        # journal of modifications (see set_journal())
+        self.__journal = None
+        self.__journal_eindex = None
+
+    def __init_index(self):
         # internal index maps
         self.__vertex_index = \
                  PropertyMap(libcore.get_vertex_index(self.__graph), self, "v")
@@ -1191,6 +1579,19 @@ class Graph(object):
     def __check_perms(self, ptype):
         if not self.__perms[ptype]:
             raise RuntimeError("the graph cannot be modified at this point!")
+        if self.__graph.GetFrozen():
+            raise RuntimeError("the graph is frozen, and cannot be modified;" +
+                               " call set_frozen(False) first")
+        if ptype in ["del_vertex", "del_edge"]:
+            self.__load_lazy_properties()
+
+    def __load_lazy_properties(self):
+        # the values of lazily loaded property maps are stored according to
+        # the original indexes, so they must be read before these change
+        for pmap in list(self.__known_properties.values()):
+            pmap = pmap()
+            if isinstance(pmap, _LazyPropertyMap) and not pmap.is_loaded():
+                pmap._PropertyMap__map
 
     def vertices(self):
         """Return an :meth:`iterator <iterator.__iter__>` over the vertices.
@@ -1233,10 +1634,15 @@ class Graph(object):
         from ``s`` to ``t``, otherwise only one edge is returned.
 
         This operation will take :math:`O(k(s))` time, where :math:`k(s)` is the
-        out-degree of vertex :math:`s`.
+        out-degree of vertex :math:`s`, or :math:`O(1)` expected time if
+        ``all_edges == False`` and :meth:`~Graph.set_fast_edge_lookup` is set
+        to `True`.
         """
         s = self.vertex(int(s))
         t = self.vertex(int(t))
+        if (not all_edges and self.get_fast_edge_lookup() and
+            self.get_edge_filter()[0] is None):
+            return libcore.get_edge(weakref.ref(self), s, t)
         edges = []
         for e in s.out_edges():
             if e.target() == t:
@@ -1273,6 +1679,8 @@ class Graph(object):
 
         self.__check_perms("add_vertex")
         v = libcore.add_vertex(weakref.ref(self), n)
+        if self.__journal is not None:
+            self.__journal.write(b"v", struct.pack("=Q", n))
 
         if n <= 1:
             return v
@@ -1317,6 +1725,8 @@ class Graph(object):
                         self.__graph.ShiftVertexProperty(pmap()._PropertyMap__map.get_map(), index)
 
         libcore.remove_vertex(self.__graph, vertex, fast)
+        if self.__journal is not None:
+            self.__journal.write(b"x", struct.pack("=QB", index, fast))
 
     def clear_vertex(self, vertex):
         """Remove all in and out-edges from the given vertex."""
@@ -1335,8 +1745,54 @@ class Graph(object):
         efilt = self.get_edge_filter()
         if efilt[0] is not None:
             efilt[0][e] = not efilt[1]
+        if self.__journal is not None:
+            self.__journal.write(b"e", self.__journal_edge(e))
         return e
 
+    def add_edge_list(self, edge_list, eprops=None, grow=True):
+        r"""Add a list of edges to the graph, given by ``edge_list``, which
+        must be a :class:`~numpy.ndarray` (or anything convertible to one) of
+        shape ``(E, 2 + k)``, where ``E`` is the number of edges. The first two
+        columns contain the indexes of the source and target vertices, and
+        the remaining ``k`` columns, if given, contain the values of the edge
+        property maps passed in the list ``eprops``, in the same order.
+
+        If ``grow == True``, vertices are added to the graph as needed, so
+        that all vertex indexes in ``edge_list`` are valid. Otherwise an
+        exception is raised if a vertex index is out of range.
+
+        This operation is :math:`O(E)`, and is much faster than calling
+        :meth:`~graph_tool.Graph.add_edge` repeatedly, since the edge lists
+        are allocated only once, and no Python objects are created.
+
+        Examples
+        --------
+        >>> g = gt.Graph()
+        >>> w = g.new_edge_property("double")
+        >>> g.add_edge_list([[0, 1, 0.5], [1, 2, 1.5]], eprops=[w])
+        >>> print(g.num_vertices(), g.num_edges(), w.a)
+        3 2 [ 0.5  1.5]
+        """
+        self.__check_perms("add_edge")
+        if grow:
+            self.__check_perms("add_vertex")
+        edge_list = numpy.asarray(edge_list)
+        if edge_list.dtype.kind in ["i", "u", "b"]:
+            if edge_list.dtype not in [numpy.int32, numpy.int64, numpy.uint64]:
+                edge_list = numpy.array(edge_list, dtype="int64")
+        else:
+            edge_list = numpy.array(edge_list, dtype="double")
+        if edge_list.ndim != 2:
+            raise ValueError("edge list must be a two-dimensional array")
+        edge_list = numpy.ascontiguousarray(edge_list)
+        if eprops is None:
+            eprops = []
+        eprops = [_prop("e", self, p) for p in eprops]
+        efilt = self.get_edge_filter()
+        libcore.add_edge_list(self.__graph, edge_list, eprops,
+                              _prop("e", self, efilt[0]), not efilt[1], grow)
+        self.__journal_stale()
+
     def remove_edge(self, edge):
         r"""Remove an edge from the graph.
 
@@ -1354,7 +1810,12 @@ class Graph(object):
            `True`, in which case it can change.
         """
         self.__check_perms("del_edge")
-        return libcore.remove_edge(self.__graph, edge)
+        if self.__journal is None:
+            return libcore.remove_edge(self.__graph, edge)
+        key = self.__journal_edge(edge)
+        ret = libcore.remove_edge(self.__graph, edge)
+        self.__journal.write(b"r", key)
+        return ret
 
     def set_fast_edge_removal(self, fast=True):
         r"""If ``fast == True`` the fast :math:`O(1)` removal of edges will be
@@ -1368,16 +1829,142 @@ class Graph(object):
         enabled."""
         return self.__graph.GetKeepEpos()
 
+    def set_fast_edge_lookup(self, fast=True):
+        r"""If ``fast == True``, a hash index of all edges, keyed by their
+        (source, target) pairs, will be kept, so that :meth:`~Graph.edge`
+        lookups (and adjacency tests in algorithms such as
+        :func:`~graph_tool.generation.random_rewire`) take :math:`O(1)`
+        expected time, instead of :math:`O(k)`. This requires an additional
+        data structure of size :math:`O(E)` to be kept at all times, and makes
+        edge insertion and removal somewhat slower. If ``fast == False``, this
+        data structure is destroyed."""
+        self.__graph.SetKeepEindex(fast)
+
+    def get_fast_edge_lookup(self):
+        r"""Return whether the fast :math:`O(1)` lookup of edges is currently
+        enabled."""
+        return self.__graph.GetKeepEindex()
+
+    def set_keep_in_edges(self, keep=True):
+        r"""If ``keep == False``, the in-edge lists of the vertices are
+        discarded, and only the out-edge lists are stored and updated, which
+        halves the memory usage of the adjacency list, and the work done when
+        edges are added. The in-edge lists are then rebuilt in :math:`O(V + E)`
+        time, only once, when an algorithm first needs them, i.e. when it
+        iterates over the in-edges or in-neighbours, or queries the in- or total
+        degree of a vertex. This includes all algorithms running on reversed or
+        undirected graphs, since the edges of an undirected graph are stored
+        only once, in the out-edge list of their source. Freezing the graph
+        (see :meth:`~Graph.set_frozen`) also needs the in-edges. The routines
+        which caused the in-edges to be rebuilt are returned by
+        :meth:`~Graph.get_in_edges_triggers`. While the in-edges are not
+        stored, removing a vertex takes :math:`O(V + E)` time. If ``keep ==
+        True``, the in-edge lists are rebuilt, if necessary, and kept from then
+        on.
+
+        >>> g = gt.Graph(keep_in_edges=False)
+        >>> v = g.add_vertex(3)
+        >>> e = g.add_edge(g.vertex(0), g.vertex(1))
+        >>> g.get_keep_in_edges()
+        False
+        >>> g.vertex(1).in_degree()
+        1
+        >>> g.get_keep_in_edges()
+        True
+        >>> len(g.get_in_edges_triggers())
+        1
+        """
+        self.__graph.SetKeepInEdges(keep)
+
+    def get_keep_in_edges(self):
+        r"""Return whether the in-edge lists are currently stored (see
+        :meth:`~Graph.set_keep_in_edges`)."""
+        return self.__graph.GetKeepInEdges()
+
+    def get_in_edges_triggers(self):
+        r"""Return a list with the names of the internal routines which caused
+        the in-edge lists to be rebuilt, after they were discarded with
+        :meth:`~Graph.set_keep_in_edges`, in the order in which this
+        happened. The list is shared with all the graph views of this graph."""
+        return self.__graph.GetInEdgesTriggers()
+
+    def get_memory_usage(self, per_vertex=False):
+        r"""Return the number of bytes used by the adjacency list of the graph,
+        including the auxiliary data structures enabled with
+        :meth:`~Graph.set_fast_edge_removal` and
+        :meth:`~Graph.set_fast_edge_lookup`. If ``per_vertex == True``, the
+        value is divided by the total number of vertices. Property maps are not
+        included.
+
+        The per-vertex edge lists are allocated either from the general-purpose
+        heap, or, if graph-tool was compiled with ``--enable-slab-allocator``
+        (see :func:`~graph_tool.show_config`), from size-class slabs. In the
+        former case the value includes an estimate of the bookkeeping overhead
+        of the heap, and in the latter the rounding of the lists to their size
+        classes, so that both modes can be compared.
+
+        >>> g = gt.Graph()
+        >>> g.add_vertex(100)
+        <...>
+        >>> g.get_memory_usage() > 0
+        True
+        """
+        m = self.__graph.GetMemoryUsage()
+        if per_vertex:
+            N = self.__graph.GetTotalNumberOfVertices()
+            return m / float(N) if N > 0 else 0.
+        return m
+
+    def get_index_type(self):
+        r"""Return the integer type used to store the adjacency lists, either
+        ``"int32"`` or ``"int64"``."""
+        return "int32" if self.__graph.GetIndex32() else "int64"
+
+    def set_frozen(self, frozen=True):
+        r"""If ``frozen == True``, an immutable, compressed sparse row (CSR)
+        snapshot of the graph is built, which will be used by all algorithms
+        whenever no vertex or edge filter is active. The snapshot stores the
+        adjacency in contiguous arrays of 32-bit integers, which yields better
+        cache behaviour and requires about half the memory of the adjacency
+        list (the latter is kept, and used for filtered views). While the
+        graph is frozen, it cannot be modified. If ``frozen == False``, the
+        snapshot is destroyed. This operation is :math:`O(N + E)`.
+
+        .. note::
+
+           The snapshot is shared with all :class:`~graph_tool.GraphView`
+           instances of the graph. Memory-mapped graphs (see
+           :meth:`~Graph.is_mapped`) consist only of the snapshot, and cannot
+           be unfrozen.
+        """
+        self.__graph.SetFrozen(frozen)
+
+    def is_frozen(self):
+        r"""Return whether the graph is currently frozen (see
+        :meth:`~Graph.set_frozen`)."""
+        return self.__graph.GetFrozen()
+
+    def is_mapped(self):
+        r"""Return whether the graph was loaded from a memory-mapped image
+        (see :func:`~graph_tool.load_graph`). Such a graph is always frozen,
+        and cannot be unfrozen; a modifiable copy can be obtained with
+        :meth:`~Graph.copy`."""
+        return self.__graph.GetMapped()
+
     def clear(self):
         """Remove all vertices and edges from the graph."""
         self.__check_perms("del_vertex")
         self.__check_perms("del_edge")
         self.__graph.Clear()
+        if self.__journal is not None:
+            self.__journal.write(b"c")
 
     def clear_edges(self):
         """Remove all edges from the graph."""
         self.__check_perms("del_edge")
         self.__graph.ClearEdges()
+        if self.__journal is not None:
+            self.__journal.write(b"C")
 
     # Internal property maps
     # ======================
@@ -1398,11 +1985,15 @@ class Graph(object):
             if t != v.key_type():
                 raise ValueError("wrong key type for property map")
             self.__properties[(t, k)] = v
+            self.__journal_stale()
 
     @_limit_args({"t": ["v", "e", "g"]})
     @_require("k", str)
     def __del_property(self, t, k):
         del self.__properties[(t, k)]
+        if self.__journal is not None:
+            self.__journal.write(b"D", t.encode("ascii") +
+                                 _journal_encode("string", k))
 
     properties = property(__get_properties,
                           doc=
@@ -1459,7 +2050,8 @@ class Graph(object):
     def own_property(self, prop):
         """Return a version of the property map 'prop' (possibly belonging to
         another graph) which is owned by the current graph."""
-        return PropertyMap(prop._PropertyMap__map, self, prop.key_type())
+        return PropertyMap(prop._PropertyMap__map, self, prop.key_type(),
+                           prop._PropertyMap__strings)
 
     def list_properties(self):
         """Print a list of all internal properties.
@@ -1551,39 +2143,160 @@ class Graph(object):
            be usable, but their contents will still be tied to the old indexes,
            and thus may become scrambled.
         """
+        self.__load_lazy_properties()
         self.__graph.ReIndexEdges()
+        self.__journal_stale()
 
     # Property map creation
 
-    def new_property(self, key_type, value_type):
+    def new_property(self, key_type, value_type, sparse=False, default=None,
+                     mmap=None, intern=False):
         """Create a new (uninitialized) vertex property map of key type
         ``key_type`` (``v``, ``e`` or ``g``), value type ``value_type``, and
-        return it.
+        return it. The parameters ``sparse``, ``default``, ``mmap`` and
+        ``intern`` apply only to vertex and edge property maps (see
+        :meth:`~graph_tool.Graph.new_vertex_property`).
         """
         if key_type == "v" or key_type == "vertex":
-            return self.new_vertex_property(value_type)
+            return self.new_vertex_property(value_type, sparse=sparse,
+                                            default=default, mmap=mmap,
+                                            intern=intern)
         if key_type == "e" or key_type == "edge":
-            return self.new_edge_property(value_type)
+            return self.new_edge_property(value_type, sparse=sparse,
+                                          default=default, mmap=mmap,
+                                          intern=intern)
         if key_type == "g" or key_type == "graph":
             return self.new_graph_property(value_type)
         raise ValueError("unknown key type: " + key_type)
 
-    def new_vertex_property(self, value_type):
+    def new_vertex_property(self, value_type, sparse=False, default=None,
+                            mmap=None, intern=False):
         """Create a new (uninitialized) vertex property map of type
-        ``value_type``, and return it."""
+        ``value_type``, and return it.
+
+        If ``sparse == True``, the property map will store only the values
+        which differ from ``default`` (or from zero, if ``default`` is
+        ``None``), in a hash table. Its memory usage is then proportional to the
+        number of vertices with non-default values, instead of the total number
+        of vertices. This is only possible for scalar value types. Sparse
+        property maps can be converted to and from regular ones with
+        :meth:`~graph_tool.PropertyMap.copy`, but they do not provide an array
+        interface, and are accepted only by some algorithms.
+
+        >>> g = gt.Graph()
+        >>> g.add_vertex(1000000)
+        <...>
+        >>> seed = g.new_vertex_property("int32_t", sparse=True, default=-1)
+        >>> seed[g.vertex(42)] = 3
+        >>> print(seed[g.vertex(42)], seed[g.vertex(43)])
+        3 -1
+        >>> print(seed.get_array())
+        None
+
+        If ``mmap`` is given, it must be a file name, and the property values
+        will be stored in this file, which is mapped into memory, instead of
+        being held in RAM. This allows for property maps which are larger than
+        the available memory, as long as they are accessed mostly
+        sequentially. The values are written directly to the file, which is
+        created if it does not exist, or otherwise is used to initialize the
+        values, so that the property map can be reopened later. This is only
+        possible for scalar value types, and the array returned by
+        :meth:`~graph_tool.PropertyMap.get_array` refers directly to the mapped
+        file. Copies of the property map are kept in memory.
+
+        If ``intern == True``, the value type must be ``string``, and the
+        property map will be interned, i.e. it will store only a 32-bit code
+        for each vertex, and each distinct string only once, in a dictionary
+        which is shared with its copies. This saves a lot of memory if there are
+        few distinct values, and algorithms which only compare the values, such
+        as :func:`~graph_tool.topology.similarity`,
+        :func:`~graph_tool.topology.subgraph_isomorphism` or
+        :func:`~graph_tool.community.condensation_graph`, will compare the codes
+        instead of the strings. If ``intern`` is an interned property map, its
+        dictionary is shared with the new property map, so that their codes can
+        be compared directly. Interned property maps are saved to files as
+        regular string property maps.
+
+        >>> label = g.new_vertex_property("string", intern=True)
+        >>> label[g.vertex(0)] = "foo"
+        >>> label[g.vertex(1)] = "bar"
+        >>> print(label[g.vertex(0)], label.a[:3])
+        foo [1 2 0]
+        >>> print(label.get_dictionary())
+        ['', 'foo', 'bar']
+        """
+        if intern is not False and intern is not None:
+            return self.__new_interned_property("v", value_type, intern,
+                                                sparse or mmap is not None or
+                                                default is not None)
+        if sparse:
+            if mmap is not None:
+                raise ValueError("A sparse property map cannot be memory-mapped.")
+            return PropertyMap(new_sparse_vertex_property(_type_alias(value_type),
+                                                          self.__graph.GetVertexIndex(),
+                                                          default),
+                               self, "v")
+        if mmap is not None:
+            return PropertyMap(new_mapped_vertex_property(_type_alias(value_type),
+                                                          self.__graph.GetVertexIndex(),
+                                                          mmap),
+                               self, "v")
+        if default is not None:
+            raise ValueError("A default value can only be given for sparse property maps.")
         return PropertyMap(new_vertex_property(_type_alias(value_type),
                                                self.__graph.GetVertexIndex(),
                                                libcore.any()),
                            self, "v")
 
-    def new_edge_property(self, value_type):
+    def new_edge_property(self, value_type, sparse=False, default=None,
+                          mmap=None, intern=False):
         """Create a new (uninitialized) edge property map of type
-        ``value_type``, and return it."""
+        ``value_type``, and return it. The parameters ``sparse``, ``default``,
+        ``mmap`` and ``intern`` have the same meaning as in
+        :meth:`~graph_tool.Graph.new_vertex_property`."""
+        if intern is not False and intern is not None:
+            return self.__new_interned_property("e", value_type, intern,
+                                                sparse or mmap is not None or
+                                                default is not None)
+        if sparse:
+            if mmap is not None:
+                raise ValueError("A sparse property map cannot be memory-mapped.")
+            return PropertyMap(new_sparse_edge_property(_type_alias(value_type),
+                                                        self.__graph.GetEdgeIndex(),
+                                                        default),
+                               self, "e")
+        if mmap is not None:
+            return PropertyMap(new_mapped_edge_property(_type_alias(value_type),
+                                                        self.__graph.GetEdgeIndex(),
+                                                        mmap),
+                               self, "e")
+        if default is not None:
+            raise ValueError("A default value can only be given for sparse property maps.")
         return PropertyMap(new_edge_property(_type_alias(value_type),
                                              self.__graph.GetEdgeIndex(),
                                              libcore.any()),
                            self, "e")
 
+    def __new_interned_property(self, key_type, value_type, intern, extra):
+        if _type_alias(value_type) != "string":
+            raise ValueError("Only string property maps can be interned.")
+        if extra:
+            raise ValueError("An interned property map cannot be sparse, " +
+                             "memory-mapped, or have a default value.")
+        if isinstance(intern, PropertyMap):
+            if not intern.is_interned():
+                raise ValueError("Property map is not interned.")
+            strings = intern._PropertyMap__strings
+        else:
+            strings = _StringDictionary()
+        if key_type == "v":
+            pmap = new_vertex_property("int32_t", self.__graph.GetVertexIndex(),
+                                       libcore.any())
+        else:
+            pmap = new_edge_property("int32_t", self.__graph.GetEdgeIndex(),
+                                     libcore.any())
+        return PropertyMap(pmap, self, key_type, strings)
+
     def new_graph_property(self, value_type, val=None):
         """Create a new graph property map of type ``value_type``, and return
         it. If ``val`` is not None, the property is initialized to its value."""
@@ -1598,17 +2311,33 @@ class Graph(object):
     # property map copying
     @_require("src", PropertyMap)
     @_require("tgt", (PropertyMap, type(None)))
-    def copy_property(self, src, tgt=None, value_type=None, g=None):
+    def copy_property(self, src, tgt=None, value_type=None, g=None,
+                      sparse=None, intern=None):
         """Copy contents of ``src`` property to ``tgt`` property. If ``tgt`` is
         None, then a new property map of the same type (or with the type given
         by the optional ``value_type`` parameter) is created, and returned. The
         optional parameter g specifies the (identical) source graph to copy
-        properties from (defaults to self).
+        properties from (defaults to self). If ``sparse`` or ``intern`` are not
+        ``None``, they specify whether the new property map is sparse or
+        interned, otherwise it will be so only if ``src`` is. Interned copies of
+        an interned property map share its dictionary.
         """
         if tgt is None:
-            tgt = self.new_property(src.key_type(),
-                                    (src.value_type()
-                                     if value_type == None else value_type))
+            if sparse is None:
+                sparse = src.is_sparse()
+            default = None
+            if sparse and src.is_sparse() and value_type is None:
+                default = src.get_default()
+            if value_type is None:
+                value_type = src.value_type()
+            if intern is None:
+                intern = (src.is_interned() and
+                          _type_alias(value_type) == "string")
+            if intern is True and src.is_interned():
+                intern = src
+            tgt = self.new_property(src.key_type(), value_type,
+                                    sparse=sparse, default=default,
+                                    intern=intern)
             ret = tgt
         else:
             ret = None
@@ -1618,6 +2347,30 @@ class Graph(object):
                              " key type")
 
         u = self if g is None else g
+
+        # interned maps with distinct dictionaries are converted via temporary
+        # regular string maps
+        if (src.is_interned() or tgt.is_interned()) and \
+           (src._PropertyMap__strings is not tgt._PropertyMap__strings):
+            k = src.key_type()
+            if src.is_interned():
+                strings = src._PropertyMap__strings
+                s = u.new_property(k, "string")
+                libcore.unintern_string_property(u.__graph, _prop(k, u, src),
+                                                 strings.strings,
+                                                 _prop(k, u, s), k == "e")
+                src = s
+            if tgt.is_interned():
+                if u is not self or src.value_type() != "string":
+                    src = self.copy_property(src, value_type="string", g=u)
+                strings = tgt._PropertyMap__strings
+                libcore.intern_string_property(self.__graph,
+                                               _prop(k, self, src),
+                                               _prop(k, self, tgt),
+                                               strings.strings, k == "e")
+                strings.update()
+                return ret
+
         g = GraphView(u, directed=True, reversed=u.is_reversed(),
                       skip_properties=True)
 
@@ -1645,7 +2398,7 @@ class Graph(object):
     # ==============
     def __get_file_format(self, file_name):
         fmt = None
-        for f in ["xml", "dot", "gml"]:
+        for f in ["gt", "gti", "xml", "dot", "gml"]:
             names = ["." + f, ".%s.gz" % f, ".%s.bz2" % f]
             for name in names:
                 if file_name.endswith(name):
@@ -1656,14 +2409,26 @@ class Graph(object):
         return fmt
 
     def load(self, file_name, fmt="auto", ignore_vp=None, ignore_ep=None,
-             ignore_gp=None):
+             ignore_gp=None, mmap=False, lazy=False, journal=False):
         """Load graph from ``file_name`` (which can be either a string or a
         file-like object). The format is guessed from ``file_name``, or can be
-        specified by ``fmt``, which can be either "xml", "dot" or "gml".
+        specified by ``fmt``, which can be either "gt", "gti", "xml", "dot" or
+        "gml" (see :meth:`~graph_tool.Graph.save`).
 
         If provided, the parameters ``ignore_vp``, ``ignore_ep`` and
         ``ignore_gp``, should contain a list of property names (vertex, edge or
         graph, respectively) which should be ignored when reading the file.
+
+        If ``mmap == True``, the file must be in the "gti" format, which is
+        memory-mapped instead of read (see :func:`~graph_tool.load_graph`).
+
+        If ``lazy == True``, the values of the vertex and edge property maps are
+        only read when they are first accessed (see
+        :func:`~graph_tool.load_graph`).
+
+        If ``journal == True``, the file must be the snapshot of a journal,
+        whose log is replayed, and which is then attached to the graph (see
+        :meth:`~graph_tool.Graph.set_journal`).
         """
 
         if type(file_name) == str:
@@ -1672,6 +2437,19 @@ class Graph(object):
             fmt = self.__get_file_format(file_name)
         elif fmt == "auto":
             fmt = "xml"
+        if mmap and fmt != "gti":
+            raise ValueError("only files in the 'gti' format can be " +
+                             "memory-mapped, not '%s'" % fmt)
+        if fmt == "gti" and not mmap:
+            raise ValueError("files in the 'gti' format can only be loaded " +
+                             "with mmap=True")
+        if lazy and (fmt not in ["gt", "gti"] or
+                     not isinstance(file_name, str)):
+            raise ValueError("only files in the 'gt' or 'gti' formats can be" +
+                             " loaded lazily, given by their names")
+        if journal and (fmt != "gt" or not isinstance(file_name, str)):
+            raise ValueError("only files in the 'gt' format can be loaded " +
+                             "with a journal, given by their names")
         if ignore_vp is None:
             ignore_vp = []
         if ignore_ep is None:
@@ -1680,14 +2458,38 @@ class Graph(object):
             ignore_gp = []
         if isinstance(file_name, str):
             props = self.__graph.ReadFromFile(file_name, None, fmt, ignore_vp,
-                                              ignore_ep, ignore_gp)
+                                              ignore_ep, ignore_gp, lazy)
         else:
             props = self.__graph.ReadFromFile("", file_name, fmt, ignore_vp,
-                                              ignore_ep, ignore_gp)
+                                              ignore_ep, ignore_gp, lazy)
+        self.__set_loaded_properties(props, file_name if lazy else None)
+        if journal:
+            self.set_journal(None)
+            self.__replay_journal(file_name)
+            self.set_journal(file_name)
+        self.__journal_eindex = None
+
+    def __set_loaded_properties(self, props, file_name=None):
+        # if file_name is given, the vertex and edge property maps may be
+        # given as (value type, position, number of values) tuples, which are
+        # read lazily from the file
+        if file_name is not None:
+            st = os.stat(file_name)
+            st = (st.st_size, st.st_mtime)
+        def new_map(prop, key_type):
+            if isinstance(prop, tuple):
+                return _LazyPropertyMap(self, key_type, prop[0], file_name,
+                                        prop[1], prop[2], st)
+            return PropertyMap(prop, self, key_type)
+        if "_Graph__journal__eindex" in props[1]:
+            # edge indexes of the journaled graph (see compact_journal())
+            self.__journal_eindex = new_map(props[1]["_Graph__journal__eindex"],
+                                            "e")
+            del props[1]["_Graph__journal__eindex"]
         for name, prop in props[0].items():
-            self.vertex_properties[name] = PropertyMap(prop, self, "v")
+            self.vertex_properties[name] = new_map(prop, "v")
         for name, prop in props[1].items():
-            self.edge_properties[name] = PropertyMap(prop, self, "e")
+            self.edge_properties[name] = new_map(prop, "e")
         for name, prop in props[2].items():
             self.graph_properties[name] = PropertyMap(prop, self, "g")
         if "_Graph__save__vfilter" in self.graph_properties:
@@ -1704,13 +2506,46 @@ class Graph(object):
             self.set_reversed(True)
             del self.graph_properties["_Graph__reversed"]
 
-
-
-    def save(self, file_name, fmt="auto"):
+    def save(self, file_name, fmt="auto", threads=1):
         """Save graph to ``file_name`` (which can be either a string or a
         file-like object). The format is guessed from the ``file_name``, or can
-        be specified by ``fmt``, which can be either "xml", "dot" or "gml". """
+        be specified by ``fmt``, which can be either "gt", "gti", "xml", "dot"
+        or "gml".
+
+        The "gt" format is a compact binary format, which stores the edge list
+        and the raw values of each property map, and is therefore much faster
+        to read and write than the text formats. It is not portable between
+        machines with different byte orders. As with the other formats, the
+        file is compressed if its name ends with ".gz" or ".bz2".
+
+        The "gti" format is an image of the frozen adjacency of the graph (see
+        :meth:`~graph_tool.Graph.set_frozen`), which is not read, but
+        memory-mapped when loaded (see :func:`~graph_tool.load_graph`). It can
+        not be compressed, and it is not portable between machines with
+        different byte orders.
+
+        If ``threads`` is larger than one, and the file is compressed, the data
+        is split into independent blocks which are compressed by that many
+        threads in parallel. The result is a standard multi-member gzip (or
+        bzip2) file, which is slightly larger, but which can be decompressed
+        by the usual tools, and read by :func:`~graph_tool.load_graph`.
+        """
 
+        if type(file_name) == str:
+            file_name = os.path.expanduser(file_name)
+        if fmt == 'auto' and isinstance(file_name, str):
+            fmt = self.__get_file_format(file_name)
+        elif fmt == "auto":
+            fmt = "xml"
+        u, props = self.__get_saved_properties(fmt)
+        if isinstance(file_name, str):
+            u.__graph.WriteToFile(file_name, None, fmt, props, threads)
+        else:
+            u.__graph.WriteToFile("", file_name, fmt, props, threads)
+
+    def __get_saved_properties(self, fmt):
+        # returns an unfiltered view of the graph, and the list of property
+        # maps to be saved with it, in the given format
         u = GraphView(self, reversed=self.is_reversed(), skip_vfilt=True,
                       skip_efilt=True)
 
@@ -1727,19 +2562,219 @@ class Graph(object):
             u.graph_properties["_Graph__reversed"] = self.new_graph_property("bool")
             u.graph_properties["_Graph__reversed"] = True
 
-        if type(file_name) == str:
-            file_name = os.path.expanduser(file_name)
-        if fmt == 'auto' and isinstance(file_name, str):
-            fmt = self.__get_file_format(file_name)
-        elif fmt == "auto":
-            fmt = "xml"
-        props = [(name[1], prop._PropertyMap__map) for name, prop in \
-                 self.__properties.items()]
+        # interned maps are saved as regular string maps, and for the binary
+        # formats, sparse and memory-mapped maps are saved as regular ones
+        props = []
+        for name, prop in self.__properties.items():
+            if prop.is_interned():
+                prop = prop.copy(intern=False)
+            elif (fmt in ["gt", "gti"] and
+                  (prop.is_sparse() or prop.is_mapped())):
+                prop = prop.copy(sparse=False)
+            props.append((name[1], prop._PropertyMap__map))
+        return u, props
+
+    # Journal
+    # =======
+
+    def set_journal(self, file_name):
+        r"""Attach a journal to the graph, which allows it to be saved
+        incrementally, or detach it if ``file_name`` is ``None``.
+
+        The graph is saved to ``file_name``, which must be in the "gt" format
+        (see :meth:`~graph_tool.Graph.save`), as a snapshot. From then on, its
+        modifications are appended as compact binary records to the log file
+        ``file_name + ".log"``, so that the cost of a checkpoint (see
+        :meth:`~graph_tool.Graph.sync_journal`) is proportional to the amount
+        of modifications, not to the size of the graph. The log is folded
+        into a new snapshot by :meth:`~graph_tool.Graph.compact_journal`. The
+        graph is recovered from the snapshot and the log by
+        :func:`~graph_tool.load_graph`, with ``journal=True``.
+
+        The following modifications are recorded: the addition and removal of
+        vertices and edges (by :meth:`~graph_tool.Graph.add_vertex`,
+        :meth:`~graph_tool.Graph.remove_vertex`,
+        :meth:`~graph_tool.Graph.add_edge`,
+        :meth:`~graph_tool.Graph.remove_edge`,
+        :meth:`~graph_tool.Graph.clear_vertex`,
+        :meth:`~graph_tool.Graph.clear` and
+        :meth:`~graph_tool.Graph.clear_edges`), the changes of directedness
+        and reversal, the removal of internal property maps, and the values
+        written to internal property maps as ``prop[key] = value``.
+
+        The other modifications done by the methods of the graph, such as the
+        addition of internal property maps, :meth:`~graph_tool.Graph.add_edge_list`
+        or :meth:`~graph_tool.Graph.purge_vertices`, cause the next
+        :meth:`~graph_tool.Graph.sync_journal` to write a new snapshot
+        instead. The changes of the filters, the values written through the
+        property map arrays (e.g. ``prop.a``), and the modifications done by
+        functions which act directly on the graph (such as
+        :func:`~graph_tool.generation.random_rewire`), or via a
+        :class:`~graph_tool.GraphView`, are not noticed, and
+        :meth:`~graph_tool.Graph.compact_journal` must be called after them.
 
-        if isinstance(file_name, str):
-            u.__graph.WriteToFile(file_name, None, fmt, props)
+        Examples
+        --------
+        >>> g = gt.Graph()
+        >>> g.vp["name"] = g.new_vertex_property("string")
+        >>> g.set_journal("/tmp/journal.gt")
+        >>> v1 = g.add_vertex()
+        >>> v2 = g.add_vertex()
+        >>> e = g.add_edge(v1, v2)
+        >>> g.vp["name"][v2] = "foo"
+        >>> g.sync_journal()
+        >>> u = gt.load_graph("/tmp/journal.gt", journal=True)
+        >>> print(u.num_vertices(), u.num_edges(), u.vp["name"][u.vertex(1)])
+        2 1 foo
+        """
+        if self.__journal is not None:
+            self.__journal.close()
+            self.__journal = None
+        if file_name is None:
+            return
+        file_name = os.path.expanduser(file_name)
+        if self.__get_file_format(file_name) != "gt":
+            raise ValueError("the journal snapshot must be in the 'gt' " +
+                             "format: " + file_name)
+        self.__journal = _Journal(file_name)
+        self.compact_journal()
+
+    def get_journal(self):
+        """Return the file name of the snapshot of the journal, or ``None`` if
+        the graph has no journal (see :meth:`~graph_tool.Graph.set_journal`)."""
+        if self.__journal is None:
+            return None
+        return self.__journal.file_name
+
+    def sync_journal(self):
+        """Write the pending records of the journal to the disk (see
+        :meth:`~graph_tool.Graph.set_journal`). If the graph was modified in a
+        way which cannot be recorded, a new snapshot is written instead."""
+        if self.__journal is None:
+            raise ValueError("the graph has no journal")
+        if self.__journal.stale:
+            self.compact_journal()
+        else:
+            self.__journal.sync()
+
+    def compact_journal(self):
+        """Write a new snapshot of the graph, and empty the log of the journal
+        (see :meth:`~graph_tool.Graph.set_journal`)."""
+        if self.__journal is None:
+            raise ValueError("the graph has no journal")
+        self.__load_lazy_properties()
+        self.__journal.close()
+        u, props = self.__get_saved_properties("gt")
+        # the edges are reindexed when the snapshot is loaded, but the log
+        # refers to their current indexes
+        eindex = u.copy_property(u.edge_index, value_type="int64_t")
+        props.append(("_Graph__journal__eindex", eindex._PropertyMap__map))
+        head, tail = os.path.split(self.__journal.file_name)
+        tmp = os.path.join(head, ".tmp-" + tail)
+        u.__graph.WriteToFile(tmp, None, "gt", props, 1)
+        self.__journal.reset(tmp)
+
+    def __journal_stale(self):
+        # the graph was modified in a way which is not recorded
+        if self.__journal is not None:
+            self.__journal.stale = True
+
+    def __journal_edge(self, e):
+        return struct.pack("=QQQ", int(e.source()), int(e.target()),
+                           int(self.edge_index[e]))
+
+    def __journal_property(self, pmap, k):
+        # records a value written to an internal property map
+        for (t, name), p in self.__properties.items():
+            if p is pmap:
+                break
         else:
-            u.__graph.WriteToFile("", file_name, fmt, props)
+            return
+        data = t.encode("ascii") + _journal_encode("string", name)
+        if t == "v":
+            data += struct.pack("=Q", int(k))
+        elif t == "e":
+            data += self.__journal_edge(k)
+        self.__journal.write(b"p", data + _journal_encode(pmap.value_type(),
+                                                          pmap[k]))
+
+    def __replay_journal(self, file_name):
+        # applies the log of the journal to the graph just loaded from its
+        # snapshot
+        eindex = self.__journal_eindex
+        self.__journal_eindex = None
+        records = _Journal.read(file_name)
+        if len(records) == 0:
+            return
+
+        # the edges are identified in the log by their index in the journaled
+        # graph, which is mapped to the current one
+        emap = numpy.zeros(0, dtype="int64")
+        if eindex is not None and len(eindex.a) > 0:
+            emap = -numpy.ones(eindex.a.max() + 1, dtype="int64")
+            emap[eindex.a] = numpy.arange(len(eindex.a))
+        eadded = {}
+        u = None
+
+        def get_edge(data, pos):
+            s, t, i = struct.unpack_from("=QQQ", data, pos)
+            if i in eadded:
+                i = eadded[i]
+            elif i < len(emap) and emap[i] >= 0:
+                i = emap[i]
+            else:
+                raise IOError("invalid edge in journal: " + str((s, t)))
+            # the edge may have been seen by a view with another direction
+            for v in [s, t]:
+                for e in u.vertex(v).out_edges():
+                    if u.edge_index[e] == i:
+                        return e
+            raise IOError("invalid edge in journal: " + str((s, t)))
+
+        for op, data in records:
+            if u is None:
+                u = GraphView(self, skip_properties=True, skip_vfilt=True,
+                              skip_efilt=True)
+            if op == b"v":
+                self.add_vertex(struct.unpack("=Q", data)[0])
+            elif op == b"x":
+                i, fast = struct.unpack("=QB", data)
+                self.remove_vertex(i, bool(fast))
+            elif op == b"e":
+                s, t, i = struct.unpack("=QQQ", data)
+                e = self.add_edge(s, t)
+                eadded[i] = self.edge_index[e]
+            elif op == b"r":
+                self.remove_edge(get_edge(data, 0))
+            elif op == b"c":
+                self.clear()
+            elif op == b"C":
+                self.clear_edges()
+            elif op in [b"d", b"R"]:
+                val = bool(struct.unpack("=B", data)[0])
+                if op == b"d":
+                    self.set_directed(val)
+                else:
+                    self.set_reversed(val)
+                u = None
+            elif op in [b"D", b"p"]:
+                t = data[:1].decode("ascii")
+                name, pos = _journal_decode("string", data, 1)
+                if op == b"D":
+                    del self.properties[(t, name)]
+                    continue
+                pmap = self.properties[(t, name)]
+                if t == "v":
+                    k = self.vertex(struct.unpack_from("=Q", data, pos)[0])
+                    pos += 8
+                elif t == "e":
+                    k = get_edge(data, pos)
+                    pos += 24
+                else:
+                    k = self
+                pmap[k] = _journal_decode(pmap.value_type(), data, pos)[0]
+            else:
+                raise IOError("invalid record in journal: " + repr(op))
 
 
     # Directedness
@@ -1748,6 +2783,8 @@ class Graph(object):
     def set_directed(self, is_directed):
         """Set the directedness of the graph."""
         self.__graph.SetDirected(is_directed)
+        if self.__journal is not None:
+            self.__journal.write(b"d", struct.pack("=B", is_directed))
 
     def is_directed(self):
         """Get the directedness of the graph."""
@@ -1760,6 +2797,8 @@ class Graph(object):
         """Reverse the direction of the edges, if ``is_reversed`` is ``True``,
         or maintain the original direction otherwise."""
         self.__graph.SetReversed(is_reversed)
+        if self.__journal is not None:
+            self.__journal.write(b"R", struct.pack("=B", is_reversed))
 
     def is_reversed(self):
         """Return ``True`` if the edges are reversed, and ``False`` otherwise.
@@ -1799,6 +2838,35 @@ class Graph(object):
         indicating whether or not it is inverted."""
         return self.__filter_state["edge_filter"]
 
+    def set_filter_cache(self, cache=True):
+        r"""If ``cache == True``, whenever a vertex or edge filter is active, a
+        compact copy of the filtered graph will be used by all algorithms,
+        instead of testing the filters for every vertex and edge visited. The
+        copy contains only the edges which are not filtered out, and the
+        remaining vertices are marked in a bit-packed mask (one bit per vertex,
+        where 64 filtered vertices are skipped at a time during iteration). The
+        vertex and edge indexes are kept, so that all property maps remain
+        valid, and the filter property maps themselves can still be modified
+        as usual. The copy is built when first needed, and rebuilt only when the graph or the
+        filters (including their values) are modified, which makes repeated
+        calls of algorithms on a sparsely filtered graph much faster. The copy
+        is specific to this graph (or graph view), and requires
+        :math:`O(N + E)` additional memory. If ``cache == False``, the copy is
+        destroyed.
+
+        >>> g = gt.random_graph(1000, lambda: (5, 5))
+        >>> u = gt.GraphView(g, vfilt=lambda v: int(v) < 100)
+        >>> u.set_filter_cache(True)
+        >>> hist = gt.vertex_hist(u, "out")
+        >>> dist = gt.shortest_distance(u, u.vertex(0))
+        """
+        self.__graph.SetFilterCache(cache)
+
+    def get_filter_cache(self):
+        r"""Return whether the materialized copy of the filtered graph is
+        currently enabled (see :meth:`~Graph.set_filter_cache`)."""
+        return self.__graph.GetFilterCache()
+
     def purge_vertices(self, in_place=False):
         """Remove all vertices of the graph which are currently being filtered
         out, and return it to the unfiltered state. This operation is not
@@ -1806,8 +2874,9 @@ class Graph(object):
 
         If the option ``in_place == True`` is given, the algorithm will remove
         the filtered vertices and re-index all property maps which are tied with
-        the graph. This is a slow operation which has an :math:`O(N^2)`
-        complexity.
+        the graph. This is done in a single compaction pass over the adjacency
+        lists and the property maps, with an :math:`O(N + E)` complexity, and
+        does not require any additional copy of the graph.
 
         If ``in_place == False``, the graph and its vertex and edge property
         maps are temporarily copied to a new unfiltered graph, which will
@@ -1844,12 +2913,65 @@ class Graph(object):
                 new_pmap = new_g.properties[(pmap.key_type(), pname)]
                 pmap._PropertyMap__map = new_pmap._PropertyMap__map
                 del self.properties[(pmap.key_type(), pname)]
+        self.__journal_stale()
 
     def purge_edges(self):
         """Remove all edges of the graph which are currently being filtered out,
-        and return it to the unfiltered state. This operation is not reversible."""
+        and return it to the unfiltered state. This operation is not reversible,
+        and has an :math:`O(N + E)` complexity."""
+        self.__load_lazy_properties()
         self.__graph.PurgeEdges()
         self.set_edge_filter(None)
+        self.__journal_stale()
+
+    def reorder_vertices(self, method="rcm", order=None):
+        r"""Renumber the vertices of the graph in place, in order to improve the
+        memory locality of algorithms which traverse it. The vertex property
+        maps tied with the graph are permuted accordingly, and the edges keep
+        their indexes (and hence their property values). The edge lists of
+        each vertex are also sorted by neighbour. This operation ignores any
+        vertex or edge filter, and returns a vertex property map with the
+        previous index of each vertex.
+
+        Parameters
+        ----------
+        method : string (optional, default: ``"rcm"``)
+            The ordering to be used, ignoring the edge directions. It can be
+            either ``"bfs"`` (breadth-first search order), ``"rcm"`` (reverse
+            Cuthill-McKee order, which minimizes the bandwidth of the adjacency
+            matrix), or ``"degree"`` (decreasing total degree).
+        order : :class:`~graph_tool.PropertyMap` (optional, default: ``None``)
+            If given, it must be a vertex property map with the new index of
+            each vertex, which must be a permutation of the vertex indexes. In
+            this case ``method`` is ignored.
+
+        Notes
+        -----
+        This operation is :math:`O(N\log N + E\log k)`, where :math:`k` is the
+        largest degree.
+
+        Examples
+        --------
+        >>> from numpy.random import permutation
+        >>> g = gt.lattice([30, 30])
+        >>> idx = g.new_vertex_property("int")
+        >>> idx.a = permutation(g.num_vertices())
+        >>> old_index = g.reorder_vertices(order=idx)
+        >>> old_index = g.reorder_vertices("rcm")
+        """
+        self.__check_perms("del_vertex")
+        if order is not None:
+            order = order.copy("int64_t")
+        old_index = self.new_vertex_property("int64_t")
+        self.__graph.ReorderVertices(method, _prop("v", self, order),
+                                     _prop("v", self, old_index))
+        for pmap in self.__known_properties.values():
+            if (pmap() is not None and pmap().key_type() == "v" and
+                pmap() not in [self.vertex_index, self.edge_index, old_index]):
+                self.__graph.PermuteVertexProperty(pmap()._PropertyMap__map.get_map(),
+                                                   _prop("v", self, old_index))
+        self.__journal_stale()
+        return old_index
 
     def get_filter_state(self):
         """Return a copy of the filter state of the graph."""
@@ -1893,38 +3015,178 @@ class Graph(object):
     # Pickling support
     # ================
 
+    # whether the pickled graphs are compressed (see __getstate__)
+    pickle_compression = False
+
     def __getstate__(self):
+        # the graph is serialized in memory in the binary "gt" format
         state = dict()
-        sio = BytesIO()
-        stream = gzip.GzipFile(fileobj=sio, mode="wb")
-        self.save(stream, "xml")
-        stream.close()
-        state["blob"] = sio.getvalue()
+        u, props = self.__get_saved_properties("gt")
+        state["blob"] = u.__graph.WriteToBlob(props,
+                                              Graph.pickle_compression)
+        state["fmt"] = "gt"
+        state["index_type"] = self.get_index_type()
         return state
 
     def __setstate__(self, state):
-        self.__init__()
+        self.__init__(index_type=state.get("index_type", None))
         blob = state["blob"]
-        if blob != "":
+        if state.get("fmt", "xml") == "gt":
+            props = self.__graph.ReadFromBlob(blob)
+            self.__set_loaded_properties(props)
+        elif blob != "":
+            # graphs pickled by older versions
             sio = BytesIO(blob)
             stream = gzip.GzipFile(fileobj=sio, mode="rb")
             self.load(stream, "xml")
 
 
 def load_graph(file_name, fmt="auto", ignore_vp=None, ignore_ep=None,
-               ignore_gp=None):
+               ignore_gp=None, mmap=False, lazy=False, journal=False):
     """
     Load a graph from ``file_name`` (which can be either a string or a file-like object).
 
     The format is guessed from ``file_name``, or can be specified by
-    ``fmt``, which can be either "xml", "dot" or "gml".
+    ``fmt``, which can be either "gt", "gti", "xml", "dot" or "gml" (see
+    :meth:`~graph_tool.Graph.save`).
 
     If provided, the parameters ``ignore_vp``, ``ignore_ep`` and
     ``ignore_gp``, should contain a list of property names (vertex, edge or
     graph, respectively) which should be ignored when reading the file.
+
+    If ``mmap == True``, ``file_name`` must be the path of a file in the "gti"
+    format, which is memory-mapped instead of read: the adjacency of the graph
+    is used directly from the mapped file, so the graph is available
+    immediately, its pages are only read from disk when they are accessed, and
+    they are shared (via the page cache) between all the processes which map
+    the same file. The returned graph is read-only (see
+    :meth:`~graph_tool.Graph.is_mapped`), but can be used with all algorithms,
+    and filtered as usual. The property maps are copied into memory, and can
+    be modified.
+
+    >>> g = gt.random_graph(100, lambda: (3, 3))
+    >>> g.save("/tmp/graph.gti")
+    >>> u = gt.load_graph("/tmp/graph.gti", mmap=True)
+    >>> u.is_mapped(), u.num_vertices(), u.num_edges()
+    (True, 100, 300)
+
+    If ``lazy == True``, ``file_name`` must be the path of an uncompressed file
+    in the "gt" or "gti" format. Only the graph and its graph properties are
+    then read, and the values of each vertex or edge property map are read
+    from the file only when the map is first accessed, so that the loading
+    time and the memory usage depend only on the property maps which are
+    actually used. The file must not be modified while there are property maps
+    which were not yet read. They are also read before any vertex or edge is
+    removed from the graph.
+
+    >>> g = gt.random_graph(100, lambda: (3, 3))
+    >>> x = g.new_vertex_property("double")
+    >>> x.a = range(100)
+    >>> g.vp["x"] = x
+    >>> g.vp["y"] = g.new_vertex_property("string")
+    >>> g.save("/tmp/graph.gt")
+    >>> u = gt.load_graph("/tmp/graph.gt", lazy=True)
+    >>> print(u.vp["x"][u.vertex(10)])
+    10.0
+
+    If ``journal == True``, ``file_name`` must be the path of the snapshot of
+    a journal, in the "gt" format. The modifications recorded in its log are
+    replayed, and a new snapshot is written, with an empty log, which remains
+    attached to the returned graph (see :meth:`~graph_tool.Graph.set_journal`).
     """
     g = Graph()
-    g.load(file_name, fmt, ignore_vp, ignore_ep, ignore_gp)
+    g.load(file_name, fmt, ignore_vp, ignore_ep, ignore_gp, mmap, lazy,
+           journal)
+    return g
+
+
+def load_graph_from_csv(file_name, directed=True, eprop_types=None,
+                        eprop_names=None, id_type="string", delimiter=",",
+                        skip_first=False):
+    """Load a graph from an edge list in ``file_name`` (which can be either a
+    string or a file-like object), where each line has the form ``source,
+    target[, values...]``.
+
+    Parameters
+    ----------
+    file_name : ``str`` or file-like object
+        File to be read. If it is a file name ending with ".gz" or ".bz2", it
+        will be decompressed.
+    directed : ``bool`` (optional, default: ``True``)
+        Whether the returned graph is directed.
+    eprop_types : list of ``str`` (optional, default: ``None``)
+        Value types of the edge properties which are read from the columns
+        following the source and target. Only scalar types and ``"string"`` are
+        supported. Any further columns are ignored.
+    eprop_names : list of ``str`` (optional, default: ``None``)
+        Names of the edge properties. If not given, they are taken from the
+        first line, if ``skip_first == True``, or are otherwise named ``"c2"``,
+        ``"c3"``, etc., after the column number.
+    id_type : ``str`` (optional, default: ``"string"``)
+        Type of the vertex identifiers in the first two columns, either
+        ``"string"`` or ``"int64_t"``.
+    delimiter : ``str`` (optional, default: ``","``)
+        Field delimiter. Fields can be enclosed in double quotes, in which case
+        they may contain the delimiter, and ``""`` stands for a literal
+        quote. If ``None``, the fields are separated by whitespace.
+    skip_first : ``bool`` (optional, default: ``False``)
+        If ``True``, the first line is a header, which is skipped.
+
+    Returns
+    -------
+    g : :class:`~graph_tool.Graph`
+        The graph, with the vertex identifiers stored in the internal vertex
+        property ``"name"``, and the edge properties in the internal edge
+        properties with the given names.
+
+    Notes
+    -----
+    The vertices are created in the order in which their identifiers first
+    appear in the file, and the edges in the order of the lines. Empty lines,
+    and lines starting with ``#`` are skipped.
+
+    The file is read in large blocks, whose lines are parsed in parallel, and
+    the vertex identifiers are resolved in parallel via a partitioned hash
+    table, if OpenMP is enabled.
+
+    Examples
+    --------
+    >>> f = open("/tmp/edges.csv", "w")
+    >>> n = f.write("src,tgt,weight\nfoo,bar,1.5\nbar,\"baz, qux\",2\n")
+    >>> f.close()
+    >>> g = gt.load_graph_from_csv("/tmp/edges.csv", eprop_types=["double"],
+    ...                            skip_first=True)
+    >>> print(g.num_vertices(), g.num_edges())
+    3 2
+    >>> print(g.vp["name"][g.vertex(2)], g.ep["weight"].a)
+    baz, qux [ 1.5  2. ]
+    """
+    g = Graph(directed=directed)
+    if eprop_types is None:
+        eprop_types = []
+    eprop_types = [_type_alias(t) for t in eprop_types]
+    if eprop_names is not None and len(eprop_names) != len(eprop_types):
+        raise ValueError("the number of edge property names and types " +
+                         "must be the same")
+    id_type = _type_alias(id_type)
+    if delimiter is None:
+        delimiter = ""
+    if isinstance(file_name, str):
+        file_name = os.path.expanduser(file_name)
+        ret = g._Graph__graph.ReadEdgeList(file_name, None, delimiter,
+                                           skip_first, id_type, eprop_types)
+    else:
+        ret = g._Graph__graph.ReadEdgeList("", file_name, delimiter,
+                                           skip_first, id_type, eprop_types)
+    ids, eprops, header = ret
+    g.vertex_properties["name"] = PropertyMap(ids, g, "v")
+    if eprop_names is None:
+        if len(header) >= 2 + len(eprops):
+            eprop_names = header[2:2 + len(eprops)]
+        else:
+            eprop_names = ["c%d" % (i + 2) for i in range(len(eprops))]
+    for name, prop in zip(eprop_names, eprops):
+        g.edge_properties[name] = PropertyMap(prop, g, "e")
     return g
 
 
@@ -1962,7 +3224,12 @@ class GraphView(Graph):
     If ``vfilt`` or ``efilt`` is anything other than a
     :class:`~graph_tool.PropertyMap` instance, the instantiation running time is
     :math:`O(V)` and :math:`O(E)`, respectively. Otherwise, the running time is
-    :math:`O(1)`.
+    :math:`O(1)`, i.e. independent of the size of the graph: the view shares the
+    adjacency list and the index maps of ``g``, and no per-view storage is
+    allocated until a filter is set, or materialized with
+    :meth:`~graph_tool.Graph.set_filter_cache`. Only the internal property maps
+    of ``g`` are registered with the view, which takes time proportional to
+    their number, unless ``skip_properties == True``.
 
     If either ``skip_properties``, ``skip_vfilt`` or ``skip_efilt`` is ``True``,
     then the internal properties, vertex filter or edge filter of the original
@@ -1974,11 +3241,13 @@ class GraphView(Graph):
                  reversed=False, skip_properties=False, skip_vfilt=False,
                  skip_efilt=False):
         self.__base = g if not isinstance(g, GraphView) else g.base
-        Graph.__init__(self)
-        # copy graph reference
+        # Graph.__init__() is not called, since it would create an empty
+        # GraphInterface only to discard it; the view shares the underlying
+        # graph and index maps of g instead.
+        self._Graph__init_state()
         self._Graph__graph = libcore.GraphInterface(g._Graph__graph, True,
-                                                    [], [],
-                                                    _prop("v", g, g.vertex_index))
+                                                    [], [], None, False)
+        self._Graph__init_index()
 
         if not skip_properties:
             for k, v in g.properties.items():
@@ -2151,8 +3420,9 @@ def _get_array_view(self):
 def _set_array_view(self, v):
     self.get_array()[:] = v
 
-vector_types = [Vector_bool, Vector_int16_t, Vector_int32_t, Vector_int64_t,
-                Vector_double, Vector_long_double]
+vector_types = [Vector_bool, Vector_int8_t, Vector_int16_t, Vector_int32_t,
+                Vector_uint32_t, Vector_int64_t, Vector_float, Vector_double,
+                Vector_long_double]
 for vt in vector_types:
     vt.a = property(_get_array_view, _set_array_view,
                     doc=r"""Shortcut to the `get_array` method as an attribute.""")
@@ -1664,7 +1664,9 @@ def condensation_graph(g, prop, vweight=None, eweight=None, avprops=None,
 
     if prop is g.vertex_index:
         prop = prop.copy(value_type="int32_t")
-    cprop = gp.new_vertex_property(prop.value_type())
+    # interned labels are condensed via their codes
+    cprop = gp.new_vertex_property(prop.value_type(),
+                                   intern=prop if prop.is_interned() else False)
 
     if avprops is None:
         avprops = []
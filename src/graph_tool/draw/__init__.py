@@ -520,7 +520,9 @@ def sfdp_layout(g, vweight=None, eweight=None, pin=None, groups=None, C=0.2,
         An edge property map with the respective weights.
     pin : :class:`~graph_tool.PropertyMap` (optional, default: ``None``)
         A vertex property map with boolean values, which, if given,
-        specify the vertices which will not have their positions modified.
+        specify the vertices which will not have their positions modified. It
+        may be a sparse property map (see
+        :meth:`~graph_tool.Graph.new_vertex_property`).
     groups : :class:`~graph_tool.PropertyMap` (optional, default: ``None``)
         A vertex property map with group assignments. Vertices belonging to the
         same group will be put close together.
@@ -625,7 +627,7 @@ def sfdp_layout(g, vweight=None, eweight=None, pin=None, groups=None, C=0.2,
         if pin.value_type() != "bool":
             raise ValueError("'pin' property must be of type 'bool'.")
     else:
-        pin = g.new_vertex_property("bool")
+        pin = g.new_vertex_property("bool", sparse=True)
 
     if K is None:
         K = _avg_edge_distance(g, pos)
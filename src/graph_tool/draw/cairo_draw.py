@@ -194,6 +194,8 @@ def surface_from_prop(surface):
 
 
 def _convert(attr, val, cmap):
+    if isinstance(val, PropertyMap) and val.is_interned():
+        val = val.copy(intern=False)
     if attr == vertex_attrs.shape:
         return shape_from_prop(val, vertex_shape)
     if attr == vertex_attrs.surface:
@@ -67,7 +67,7 @@ dl_import("from . import libgraph_tool_topology")
 
 from .. import _prop, Vector_int32_t, _check_prop_writable, \
      _check_prop_scalar, _check_prop_vector, Graph, PropertyMap, GraphView,\
-     libcore, _get_rng, _degree
+     libcore, _get_rng, _degree, _intern_pair
 import random, sys, numpy
 __all__ = ["isomorphism", "subgraph_isomorphism", "mark_subgraph",
            "max_cardinality_matching", "max_independent_vertex_set",
@@ -138,6 +138,7 @@ def similarity(g1, g2, label1=None, label2=None, norm=True):
         label2 = g2.vertex_index
     if label1.value_type() != label2.value_type():
         raise ValueError("label property maps must be of the same type")
+    label1, label2 = _intern_pair(label1, label2)
     s = libgraph_tool_topology.\
            similarity(g1._Graph__graph, g2._Graph__graph,
                       _prop("v", g1, label1), _prop("v", g1, label2))
@@ -288,10 +289,14 @@ def subgraph_isomorphism(sub, g, max_n=0, vertex_label=None, edge_label=None,
         vertex_label = (None, None)
     elif vertex_label[0].value_type() != vertex_label[1].value_type():
         raise ValueError("Both vertex label property maps must be of the same type!")
+    else:
+        vertex_label = _intern_pair(*vertex_label)
     if edge_label is None:
         edge_label = (None, None)
     elif edge_label[0].value_type() != edge_label[1].value_type():
         raise ValueError("Both edge label property maps must be of the same type!")
+    else:
+        edge_label = _intern_pair(*edge_label)
     vmaps = []
     emaps = []
     if random: